@@ -30,6 +30,8 @@
 #include <string>
 #include <vector>
 
+#include "simd.hpp"
+
 namespace OffScreenBitmapDraw
 {
 
@@ -321,35 +323,75 @@ public:
         return true;
     }
 
-    bool reflective_image(Type& image, const bool include_diagnols = false)
+    // 3 x 3 tiles: this image in the center, mirrored copies around it.
+    // each source row is written directly into all tiles - no flipping of this image
+    bool reflective_image(Type& image, const bool include_diagnols = false) const
     {
-        image.setwidth_height(3 * width_, 3 * height_, true);
-        image.copy_from(*this, width_, height_);
-        vertical_flip();
+        assert( &image != this );
+        if ( &image == this || !width_ || !height_ )
+            return false;
+        if (!image.setwidth_height(3 * width_, 3 * height_, 0, true))
+            return false;
+        for (unsigned y = 0; y < height_; ++y)
+        {
+            const pixel_t* src = row(y);
+            const unsigned y_mirrored = height_ - 1 - y;
 
-        image.copy_from(*this, width_,           0);
-        image.copy_from(*this, width_, 2 * height_);
-        vertical_flip();
-        horizontal_flip();
+            pixel_t* center = image.row(height_ + y) + width_;
+            std::copy(src, src + width_, center);
+            std::copy(src, src + width_, image.row(y_mirrored) + width_);
+            std::copy(src, src + width_, image.row(2 * height_ + y_mirrored) + width_);
 
-        image.copy_from(*this,          0, height_);
-        image.copy_from(*this, 2 * width_, height_);
-        horizontal_flip();
+            // horizontally mirrored row, once - then copied
+            pixel_t* left = image.row(height_ + y);
+            std::copy(src, src + width_, left);
+            reverse_pixels(left, left + width_);
+            std::copy(left, left + width_, image.row(height_ + y) + 2 * width_);
 
-        if (include_diagnols)
-        {
-            Type tile = *this;
-            tile.vertical_flip();
-            tile.horizontal_flip();
-            image.copy_from(tile,          0,           0);
-            image.copy_from(tile, 2 * width_,           0);
-            image.copy_from(tile, 2 * width_, 2 * height_);
-            image.copy_from(tile, 0         , 2 * height_);
+            if (include_diagnols)
+            {
+                std::copy(left, left + width_, image.row(y_mirrored));
+                std::copy(left, left + width_, image.row(y_mirrored) + 2 * width_);
+                std::copy(left, left + width_, image.row(2 * height_ + y_mirrored));
+                std::copy(left, left + width_, image.row(2 * height_ + y_mirrored) + 2 * width_);
+            }
         }
-
         return true;
     }
 
+    // dest(y, x) = this(x, y)
+    bool transpose_to(Type& dest) const
+    {
+        return remap_transposed_to(dest, false, false);
+    }
+
+    // degrees: multiple of 90 - positive rotates clockwise
+    bool rotate_to(Type& dest, const int degrees) const
+    {
+        assert( &dest != this );
+        if ( &dest == this || !width_ || !height_ || (degrees % 90) )
+            return false;
+        switch ( ((degrees / 90) % 4 + 4) % 4 )
+        {
+        case 1:     return remap_transposed_to(dest, true, false);
+        case 3:     return remap_transposed_to(dest, false, true);
+        case 2:
+            if (!dest.setwidth_height(width_, height_))
+                return false;
+            for (unsigned y = 0; y < height_; ++y)
+            {
+                pixel_t* d = dest.row(height_ - 1 - y);
+                std::copy(row(y), row(y) + width_, d);
+                reverse_pixels(d, d + width_);
+            }
+            return true;
+        default:
+            if (!dest.setwidth_height(width_, height_))
+                return false;
+            return dest.copy_from(*this);
+        }
+    }
+
     // non-padded width
     inline unsigned width() const
     {
@@ -413,28 +455,18 @@ public:
     inline void horizontal_flip()
     {
         for (unsigned y = 0; y < height_; ++y)
-        {
-            pixel_t* itr1 = row(y);
-            pixel_t* itr2 = itr1 + ( width_ - 1 );
-            while (itr1 < itr2)
-            {
-                std::swap(*itr1, *itr2);
-                ++itr1;
-                --itr2;
-            }
-        }
+            reverse_pixels(row(y), row(y) + width_);
     }
 
     inline void vertical_flip()
     {
+        // byte wise swap: vectorizes for any pixel size
+        const std::size_t row_bytes = std::size_t(width_) * sizeof(pixel_t);
         for (unsigned y = 0; y < (height_ / 2); ++y)
         {
-            pixel_t* itr1 = row(y);
-            pixel_t* itr2 = row(height_ - y - 1);
-            for (std::size_t x = 0; x < width_; ++x)
-            {
-                std::swap(*(itr1 + x),*(itr2 + x));
-            }
+            unsigned char* itr1 = reinterpret_cast<unsigned char*>(row(y));
+            unsigned char* itr2 = reinterpret_cast<unsigned char*>(row(height_ - y - 1));
+            std::swap_ranges(itr1, itr1 + row_bytes, itr2);
         }
     }
 
@@ -466,6 +498,34 @@ public:
 
 protected:
 
+   // cache blocked transpose of (x, y) to (y, x) - optionally mirroring the
+   // destination columns (clockwise rotation) or rows (counter clockwise)
+   bool remap_transposed_to(Type& dest, const bool mirror_x, const bool mirror_y) const
+   {
+      assert( &dest != this );
+      if ( &dest == this || !width_ || !height_ )
+         return false;
+      if (!dest.setwidth_height(height_, width_))
+         return false;
+      constexpr unsigned block = 32;
+      for (unsigned by = 0; by < height_; by += block)
+      {
+         const unsigned y_end = std::min(height_, by + block);
+         for (unsigned bx = 0; bx < width_; bx += block)
+         {
+            const unsigned x_end = std::min(width_, bx + block);
+            for (unsigned y = by; y < y_end; ++y)
+            {
+               const pixel_t* src = row(y);
+               const unsigned dx = mirror_x ? (height_ - 1 - y) : y;
+               for (unsigned x = bx; x < x_end; ++x)
+                  dest.row(mirror_y ? (width_ - 1 - x) : x)[dx] = src[x];
+            }
+         }
+      }
+      return true;
+   }
+
    inline unsigned short flip(const unsigned short& v) const
    {
       return ((v >> 8) | (v << 8));
@@ -342,31 +342,13 @@ public:
 
     inline Type & horizontal_flip()
     {
-        for (unsigned y = 0; y < height_; ++y)
-        {
-            pixel_t* itr1 = row(y);
-            pixel_t* itr2 = itr1 + (width() -1);
-            while (itr1 < itr2)
-            {
-                std::swap(*itr1,*itr2);
-                ++itr1;
-                --itr2;
-            }
-        }
+        BaseType::horizontal_flip();
         return *this;
     }
 
     inline Type & vertical_flip()
     {
-        for (unsigned y = 0; y < (height_ / 2); ++y)
-        {
-            pixel_t* itr1 = row(y);
-            pixel_t* itr2 = row(height_ - y - 1);
-            for (std::size_t x = 0; x < width(); ++x)
-            {
-                std::swap(*(itr1 + x),*(itr2 + x));
-            }
-        }
+        BaseType::vertical_flip();
         return *this;
     }
 
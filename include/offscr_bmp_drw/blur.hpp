@@ -0,0 +1,351 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "bitmap_image_generic.hpp"
+#include "colors.hpp"
+#include "convolution.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+/// blur filters, which cost per pixel is independent of the radius:
+///   box_blur():                running sums
+///   gaussian_blur():           multiple passes of box_blur() approximating a gaussian
+///   gaussian_blur_recursive(): 3rd order IIR filter of Young / van Vliet
+///
+/// all filters work on an interleaved Float copy of the image,
+/// thus src and dst may be the same image.
+/// vertical passes process complete rows at once - vectorizable across columns.
+/// num_threads: 0 = hardware concurrency
+
+template <class BitmapImageType, class Float = float>
+class blur_impl
+{
+public:
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using component_t = typename pixel_traits<pixel_t>::component_t;
+    static constexpr unsigned N = pixel_traits<pixel_t>::num_components;
+
+    blur_impl(const BitmapImageType& src, const unsigned num_threads)
+        : w_(src.width()), h_(src.height()), n_(src.width() * N)
+        , num_threads_(num_threads)
+        , buf_(std::size_t(n_) * h_), tmp_(std::size_t(n_) * h_)
+    {
+        parallel_for_bands(h_, num_threads_, [&](const unsigned y0, const unsigned y1, const unsigned) {
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                const component_t* comps = cbegin(*src.row(y));
+                Float* out = row(buf_, y);
+                for (unsigned i = 0; i < n_; ++i)
+                    out[i] = Float(comps[i]);
+            }
+        });
+    }
+
+    bool store(const BitmapImageType& src, BitmapImageType& dst) const
+    {
+        if (dst.width() != src.width() || dst.height() != src.height())
+        {
+            if (!dst.setwidth_height(src.width(), src.height()))
+                return false;
+        }
+        parallel_for_bands(h_, num_threads_, [&](const unsigned y0, const unsigned y1, const unsigned) {
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                const Float* in = row(buf_, y);
+                component_t* comps = begin(*dst.row(y));
+                for (unsigned i = 0; i < n_; ++i)
+                    comps[i] = component_saturation<component_t>::from(in[i]);
+            }
+        });
+        return true;
+    }
+
+    void box_horizontal(const unsigned r, const border_mode border, const Float border_value)
+    {
+        if (!r)
+            return;
+        const unsigned d = 2 * r + 1;
+        const Float inv = Float(1) / Float(d);
+        parallel_for_bands(h_, num_threads_, [&](const unsigned y0, const unsigned y1, const unsigned) {
+            std::vector<Float> padded(std::size_t(w_ + 2 * r) * N);
+            std::vector<int> xmap(w_ + 2 * r);
+            for (unsigned i = 0; i < w_ + 2 * r; ++i)
+                xmap[i] = border_index(int(i) - int(r), int(w_), border);
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                const Float* in = row(buf_, y);
+                Float* out = row(buf_, y);
+                Float* p = padded.data();
+                for (unsigned i = 0; i < w_ + 2 * r; ++i, p += N)
+                {
+                    const int sx = xmap[i];
+                    for (unsigned c = 0; c < N; ++c)
+                        p[c] = (sx < 0) ? border_value : in[sx * N + c];
+                }
+                p = padded.data();
+                Float acc[N];
+                for (unsigned c = 0; c < N; ++c)
+                    acc[c] = 0;
+                for (unsigned k = 0; k < d; ++k)
+                    for (unsigned c = 0; c < N; ++c)
+                        acc[c] += p[k * N + c];
+                for (unsigned x = 0; x < w_; ++x)
+                {
+                    for (unsigned c = 0; c < N; ++c)
+                        out[x * N + c] = acc[c] * inv;
+                    if (x + 1 < w_)
+                    {
+                        for (unsigned c = 0; c < N; ++c)
+                            acc[c] += p[(x + d) * N + c] - p[x * N + c];
+                    }
+                }
+            }
+        });
+    }
+
+    void box_vertical(const unsigned r, const border_mode border, const Float border_value)
+    {
+        if (!r)
+            return;
+        const Float inv = Float(1) / Float(2 * r + 1);
+        const std::vector<Float> const_row(n_, border_value);
+        auto src_row = [&](const int y) -> const Float* {
+            const int sy = border_index(y, int(h_), border);
+            return (sy < 0) ? const_row.data() : row(buf_, unsigned(sy));
+        };
+        parallel_for_bands(h_, num_threads_, [&](const unsigned y0, const unsigned y1, const unsigned) {
+            std::vector<Float> acc(n_, Float(0));
+            for (int k = int(y0) - int(r); k <= int(y0) + int(r); ++k)
+            {
+                const Float* in = src_row(k);
+                for (unsigned i = 0; i < n_; ++i)
+                    acc[i] += in[i];
+            }
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                Float* out = row(tmp_, y);
+                for (unsigned i = 0; i < n_; ++i)
+                    out[i] = acc[i] * inv;
+                if (y + 1 < y1)
+                {
+                    const Float* add = src_row(int(y + r + 1));
+                    const Float* sub = src_row(int(y) - int(r));
+                    for (unsigned i = 0; i < n_; ++i)
+                        acc[i] += add[i] - sub[i];
+                }
+            }
+        });
+        buf_.swap(tmp_);
+    }
+
+    // box widths for n passes approximating a gaussian of sigma
+    // see: W. Wells, "Efficient synthesis of Gaussian filters by cascaded uniform filters", 1986
+    //  and P. Kovesi, "Fast Almost-Gaussian Filtering", 2010
+    static std::vector<unsigned> gaussian_box_radii(const Float sigma, const unsigned passes)
+    {
+        const double s2 = double(sigma) * sigma;
+        const double w_ideal = std::sqrt(12.0 * s2 / passes + 1.0);
+        int wl = int(std::floor(w_ideal));
+        if (!(wl & 1))
+            --wl;
+        if (wl < 1)
+            wl = 1;
+        const int wu = wl + 2;
+        const double m_ideal = (12.0 * s2 - passes * wl * wl - 4.0 * passes * wl - 3.0 * passes) / (-4.0 * wl - 4.0);
+        const int m = int(std::floor(m_ideal + 0.5));
+        std::vector<unsigned> radii(passes);
+        for (unsigned i = 0; i < passes; ++i)
+            radii[i] = unsigned(((int(i) < m) ? wl : wu) - 1) / 2;
+        return radii;
+    }
+
+    // Young / van Vliet: "Recursive implementation of the Gaussian filter", 1995
+    struct recursive_coeffs
+    {
+        explicit recursive_coeffs(const Float sigma)
+        {
+            const double s = sigma;
+            const double q = (s >= 2.5) ? (0.98711 * s - 0.96330) : (3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * s));
+            const double q2 = q * q, q3 = q2 * q;
+            const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+            const double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+            const double b2 = -(1.4281 * q2 + 1.26661 * q3);
+            const double b3 = 0.422205 * q3;
+            a1 = Float(b1 / b0);
+            a2 = Float(b2 / b0);
+            a3 = Float(b3 / b0);
+            B  = Float(1.0 - (b1 + b2 + b3) / b0);
+        }
+        Float B, a1, a2, a3;
+    };
+
+    void recursive_horizontal(const recursive_coeffs& k)
+    {
+        parallel_for_bands(h_, num_threads_, [&](const unsigned y0, const unsigned y1, const unsigned) {
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                Float* p = row(buf_, y);
+                for (unsigned c = 0; c < N; ++c)
+                {
+                    // steady state for constant continuation of the edges
+                    Float w1 = p[c], w2 = w1, w3 = w1;
+                    for (unsigned i = c; i < n_; i += N)
+                    {
+                        const Float v = k.B * p[i] + k.a1 * w1 + k.a2 * w2 + k.a3 * w3;
+                        w3 = w2; w2 = w1; w1 = v;
+                        p[i] = v;
+                    }
+                    w2 = w3 = w1;
+                    for (int i = int(n_ - N + c); i >= 0; i -= int(N))
+                    {
+                        const Float v = k.B * p[i] + k.a1 * w1 + k.a2 * w2 + k.a3 * w3;
+                        w3 = w2; w2 = w1; w1 = v;
+                        p[i] = v;
+                    }
+                }
+            }
+        });
+    }
+
+    void recursive_vertical(const recursive_coeffs& k)
+    {
+        // rows depend on each other: split the columns into bands
+        parallel_for_bands(n_, num_threads_, [&](const unsigned i0, const unsigned i1, const unsigned) {
+            const unsigned n = i1 - i0;
+            std::vector<Float> w1(row(buf_, 0) + i0, row(buf_, 0) + i1), w2(w1), w3(w1);
+            for (unsigned y = 0; y < h_; ++y)
+            {
+                Float* p = row(buf_, y) + i0;
+                for (unsigned i = 0; i < n; ++i)
+                {
+                    const Float v = k.B * p[i] + k.a1 * w1[i] + k.a2 * w2[i] + k.a3 * w3[i];
+                    w3[i] = w2[i]; w2[i] = w1[i]; w1[i] = v;
+                    p[i] = v;
+                }
+            }
+            w2 = w1;
+            w3 = w1;
+            for (unsigned y = h_; y > 0; --y)
+            {
+                Float* p = row(buf_, y - 1) + i0;
+                for (unsigned i = 0; i < n; ++i)
+                {
+                    const Float v = k.B * p[i] + k.a1 * w1[i] + k.a2 * w2[i] + k.a3 * w3[i];
+                    w3[i] = w2[i]; w2[i] = w1[i]; w1[i] = v;
+                    p[i] = v;
+                }
+            }
+        });
+    }
+
+private:
+    inline Float* row(std::vector<Float>& v, const unsigned y) const
+    {
+        return &v[std::size_t(y) * n_];
+    }
+
+    inline const Float* row(const std::vector<Float>& v, const unsigned y) const
+    {
+        return &v[std::size_t(y) * n_];
+    }
+
+    const unsigned w_, h_, n_;
+    const unsigned num_threads_;
+    std::vector<Float> buf_;
+    std::vector<Float> tmp_;
+};
+
+
+/// mean over the (2 radius_x + 1) x (2 radius_y + 1) neighbourhood
+template <class BitmapImageType, class Float = float>
+inline bool box_blur(
+    const BitmapImageType& src,
+    BitmapImageType& dst,
+    const unsigned radius_x,
+    const unsigned radius_y,
+    const border_mode border = border_clamp,
+    const Float border_value = Float(0),
+    const unsigned num_threads = 1
+    )
+{
+    if (!src)
+        return false;
+    blur_impl<BitmapImageType, Float> impl(src, num_threads);
+    impl.box_horizontal(radius_x, border, border_value);
+    impl.box_vertical(radius_y, border, border_value);
+    return impl.store(src, dst);
+}
+
+/// gaussian approximated by passes (3 .. 5 are reasonable) box blurs
+template <class BitmapImageType, class Float = float>
+inline bool gaussian_blur(
+    const BitmapImageType& src,
+    BitmapImageType& dst,
+    const Float sigma,
+    const unsigned passes = 3,
+    const border_mode border = border_clamp,
+    const Float border_value = Float(0),
+    const unsigned num_threads = 1
+    )
+{
+    using Impl = blur_impl<BitmapImageType, Float>;
+    if (!src || !passes || sigma <= Float(0))
+        return false;
+    const std::vector<unsigned> radii = Impl::gaussian_box_radii(sigma, passes);
+    Impl impl(src, num_threads);
+    for (const unsigned r : radii)
+    {
+        impl.box_horizontal(r, border, border_value);
+        impl.box_vertical(r, border, border_value);
+    }
+    return impl.store(src, dst);
+}
+
+/// gaussian by recursive (IIR) filtering - for sigma >= 0.5
+/// edges are continued constantly (border_clamp)
+template <class BitmapImageType, class Float = float>
+inline bool gaussian_blur_recursive(
+    const BitmapImageType& src,
+    BitmapImageType& dst,
+    const Float sigma,
+    const unsigned num_threads = 1
+    )
+{
+    using Impl = blur_impl<BitmapImageType, Float>;
+    if (!src || sigma < Float(0.5))
+        return false;
+    const typename Impl::recursive_coeffs k(sigma);
+    Impl impl(src, num_threads);
+    impl.recursive_horizontal(k);
+    impl.recursive_vertical(k);
+    return impl.store(src, dst);
+}
+
+}
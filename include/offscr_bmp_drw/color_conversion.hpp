@@ -0,0 +1,295 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "colors.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace OffScreenBitmapDraw
+{
+
+template <class Float>
+struct HSL_f
+{
+    Float h;    // hue in [0 .. 360)
+    Float s;    // saturation in [0 .. 1]
+    Float l;    // lightness in [0 .. 1]
+};
+
+// batch color space conversions - arrays of n values (structure of arrays).
+// the kernels have no data dependent branches: the sector switch of to_rgb()
+// is replaced by the closed form  f(n) = v - v * s * clamp(min(k, 4 - k), 0, 1)
+// with k = (n + h / 60) mod 6, so that the compiler can vectorize the loops.
+// hue in degrees, any value - it is wrapped into [0 .. 360)
+
+namespace color_conversion_detail
+{
+
+template <class Float>
+inline Float wrap(const Float x, const Float period)
+{
+    return x - period * std::floor(x / period);
+}
+
+template <class Float>
+inline Float clamp01(const Float x)
+{
+    return (x < Float(0)) ? Float(0) : (x > Float(1)) ? Float(1) : x;
+}
+
+template <class Float>
+inline Float hsv_channel(const Float h6, const Float s, const Float v, const Float n)
+{
+    Float k = n + h6;
+    k = (k >= Float(6)) ? k - Float(6) : k;
+    const Float t = clamp01(std::min(k, Float(4) - k));
+    return v - v * s * t;
+}
+
+template <class Float>
+inline Float hsl_channel(const Float h12, const Float a, const Float l, const Float n)
+{
+    Float k = n + h12;
+    k = (k >= Float(12)) ? k - Float(12) : k;
+    const Float t = std::max(Float(-1), std::min(std::min(k - Float(3), Float(9) - k), Float(1)));
+    return l - a * t;
+}
+
+// hue in degrees [0 .. 360) of max/min/delta - 0 for gray
+template <class Float>
+inline Float hue_of(const Float r, const Float g, const Float b, const Float mx, const Float d)
+{
+    const Float dd = (d > Float(0)) ? d : Float(1);
+    const Float h6 = (mx == r) ? (g - b) / dd
+                   : (mx == g) ? Float(2) + (b - r) / dd
+                   :             Float(4) + (r - g) / dd;
+    const Float h = Float(60) * ((h6 < Float(0)) ? h6 + Float(6) : h6);
+    return (d > Float(0)) ? h : Float(0);
+}
+
+template <class PixelType, class Float>
+inline void store_pixel(PixelType& p, const Float r, const Float g, const Float b)
+{
+    using component = typename PixelType::component;
+    set_rgb(p, component(Float(255.99) * r), component(Float(255.99) * g), component(Float(255.99) * b));
+}
+
+constexpr std::size_t chunk = 64;
+
+}
+
+template <class Float>
+inline void hsv_to_rgb(
+    const Float* h, const Float* s, const Float* v,
+    Float* r, Float* g, Float* b,
+    const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Float h6 = wrap(h[i], Float(360)) / Float(60);
+        const Float si = clamp01(s[i]);
+        r[i] = hsv_channel(h6, si, v[i], Float(5));
+        g[i] = hsv_channel(h6, si, v[i], Float(3));
+        b[i] = hsv_channel(h6, si, v[i], Float(1));
+    }
+}
+
+template <class Float>
+inline void rgb_to_hsv(
+    const Float* r, const Float* g, const Float* b,
+    Float* h, Float* s, Float* v,
+    const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Float mx = std::max(r[i], std::max(g[i], b[i]));
+        const Float mn = std::min(r[i], std::min(g[i], b[i]));
+        const Float d = mx - mn;
+        h[i] = hue_of(r[i], g[i], b[i], mx, d);
+        s[i] = (mx > Float(0)) ? d / mx : Float(0);
+        v[i] = mx;
+    }
+}
+
+template <class Float>
+inline void hsl_to_rgb(
+    const Float* h, const Float* s, const Float* l,
+    Float* r, Float* g, Float* b,
+    const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Float h12 = wrap(h[i], Float(360)) / Float(30);
+        const Float a = clamp01(s[i]) * std::min(l[i], Float(1) - l[i]);
+        r[i] = hsl_channel(h12, a, l[i], Float(0));
+        g[i] = hsl_channel(h12, a, l[i], Float(8));
+        b[i] = hsl_channel(h12, a, l[i], Float(4));
+    }
+}
+
+template <class Float>
+inline void rgb_to_hsl(
+    const Float* r, const Float* g, const Float* b,
+    Float* h, Float* s, Float* l,
+    const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const Float mx = std::max(r[i], std::max(g[i], b[i]));
+        const Float mn = std::min(r[i], std::min(g[i], b[i]));
+        const Float d = mx - mn;
+        const Float li = (mx + mn) / Float(2);
+        const Float den = Float(1) - std::abs(Float(2) * li - Float(1));
+        h[i] = hue_of(r[i], g[i], b[i], mx, d);
+        s[i] = (d > Float(0) && den > Float(0)) ? d / den : Float(0);
+        l[i] = li;
+    }
+}
+
+
+/// n HSV colors into pixels - e.g. an image row: converted in chunks through the batch kernel
+template <class Float, class PixelType>
+inline void hsv_to_pixels(const HSV_f<Float>* hsv, PixelType* dest, const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    Float h[chunk], s[chunk], v[chunk], r[chunk], g[chunk], b[chunk];
+    for (std::size_t i0 = 0; i0 < n; i0 += chunk)
+    {
+        const std::size_t m = std::min(chunk, n - i0);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            h[i] = hsv[i0 + i].h;
+            s[i] = hsv[i0 + i].s;
+            v[i] = hsv[i0 + i].v;
+        }
+        hsv_to_rgb(h, s, v, r, g, b, m);
+        for (std::size_t i = 0; i < m; ++i)
+            store_pixel(dest[i0 + i], r[i], g[i], b[i]);
+    }
+}
+
+template <class Float, class PixelType>
+inline void hsl_to_pixels(const HSL_f<Float>* hsl, PixelType* dest, const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    Float h[chunk], s[chunk], l[chunk], r[chunk], g[chunk], b[chunk];
+    for (std::size_t i0 = 0; i0 < n; i0 += chunk)
+    {
+        const std::size_t m = std::min(chunk, n - i0);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            h[i] = hsl[i0 + i].h;
+            s[i] = hsl[i0 + i].s;
+            l[i] = hsl[i0 + i].l;
+        }
+        hsl_to_rgb(h, s, l, r, g, b, m);
+        for (std::size_t i = 0; i < m; ++i)
+            store_pixel(dest[i0 + i], r[i], g[i], b[i]);
+    }
+}
+
+template <class Float, class PixelType>
+inline void pixels_to_hsv(const PixelType* src, HSV_f<Float>* hsv, const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    Float h[chunk], s[chunk], v[chunk], r[chunk], g[chunk], b[chunk];
+    for (std::size_t i0 = 0; i0 < n; i0 += chunk)
+    {
+        const std::size_t m = std::min(chunk, n - i0);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            r[i] = Float(*red  (src[i0 + i])) / Float(255);
+            g[i] = Float(*green(src[i0 + i])) / Float(255);
+            b[i] = Float(*blue (src[i0 + i])) / Float(255);
+        }
+        rgb_to_hsv(r, g, b, h, s, v, m);
+        for (std::size_t i = 0; i < m; ++i)
+            hsv[i0 + i] = HSV_f<Float>{ h[i], s[i], v[i] };
+    }
+}
+
+template <class Float, class PixelType>
+inline void pixels_to_hsl(const PixelType* src, HSL_f<Float>* hsl, const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    Float h[chunk], s[chunk], l[chunk], r[chunk], g[chunk], b[chunk];
+    for (std::size_t i0 = 0; i0 < n; i0 += chunk)
+    {
+        const std::size_t m = std::min(chunk, n - i0);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            r[i] = Float(*red  (src[i0 + i])) / Float(255);
+            g[i] = Float(*green(src[i0 + i])) / Float(255);
+            b[i] = Float(*blue (src[i0 + i])) / Float(255);
+        }
+        rgb_to_hsl(r, g, b, h, s, l, m);
+        for (std::size_t i = 0; i < m; ++i)
+            hsl[i0 + i] = HSL_f<Float>{ h[i], s[i], l[i] };
+    }
+}
+
+
+/// fixed point HSV to 8-bit RGB:
+///   hue in 1/256 sectors: [0 .. 1536) for [0 .. 360) degrees, saturation and value in [0 .. 255]
+/// integer only - same closed form as hsv_to_rgb()
+template <class PixelType>
+inline void hsv_to_pixels_fixed(
+    const uint16_t* h, const uint8_t* s, const uint8_t* v,
+    PixelType* dest, const std::size_t n)
+{
+    using namespace color_conversion_detail;
+    using component = typename PixelType::component;
+    uint8_t r[chunk], g[chunk], b[chunk];
+    for (std::size_t i0 = 0; i0 < n; i0 += chunk)
+    {
+        const std::size_t m = std::min(chunk, n - i0);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            const int hi = int(h[i0 + i] % 1536);
+            const int vs = int(v[i0 + i]) * int(s[i0 + i]);
+            const int vi = int(v[i0 + i]);
+            int k, t;
+            k = 5 * 256 + hi;   k -= (k >= 1536) ? 1536 : 0;
+            t = std::max(0, std::min(std::min(k, 1024 - k), 256));
+            r[i] = uint8_t(vi - (vs * t + 32640) / 65280);
+            k = 3 * 256 + hi;   k -= (k >= 1536) ? 1536 : 0;
+            t = std::max(0, std::min(std::min(k, 1024 - k), 256));
+            g[i] = uint8_t(vi - (vs * t + 32640) / 65280);
+            k = 1 * 256 + hi;   k -= (k >= 1536) ? 1536 : 0;
+            t = std::max(0, std::min(std::min(k, 1024 - k), 256));
+            b[i] = uint8_t(vi - (vs * t + 32640) / 65280);
+        }
+        for (std::size_t i = 0; i < m; ++i)
+            set_rgb(dest[i0 + i], component(r[i]), component(g[i]), component(b[i]));
+    }
+}
+
+}
@@ -0,0 +1,205 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "colors.hpp"
+
+#include <array>
+#include <cstddef>
+
+
+namespace OffScreenBitmapDraw
+{
+
+// colormaps as functions of t in [0 .. 1], evaluated at compile time.
+// gray, hot, copper and jet follow the MATLAB definitions. against the tables
+// of colormaps.hpp: gray is yarg_colormap[] - gray_colormap[] runs from white
+// to black -, hot and copper are within 1, jet is within 30 of jet_colormap[]
+// but for its last entries, which turn to (102, 0, 45).
+// the perceptual maps are 6th/5th degree polynomial fits to the matplotlib
+// (viridis, plasma, magma, inferno) and Google (turbo) reference tables
+enum colormap_kind {
+    cmap_gray    = 0,
+    cmap_hot     = 1,
+    cmap_copper  = 2,
+    cmap_jet     = 3,
+    cmap_viridis = 4,
+    cmap_plasma  = 5,
+    cmap_magma   = 6,
+    cmap_inferno = 7,
+    cmap_turbo   = 8
+};
+
+namespace colormap_detail
+{
+
+// C++11 constexpr: single return statements only
+
+constexpr double clamp01(const double v)
+{
+    return (v < 0.0) ? 0.0 : (v > 1.0) ? 1.0 : v;
+}
+
+constexpr double abs_(const double v)
+{
+    return (v < 0.0) ? -v : v;
+}
+
+constexpr unsigned char to_component(const double v)
+{
+    return static_cast<unsigned char>(clamp01(v) * 255.0 + 0.5);
+}
+
+// c0 + t * (c1 + t * (c2 + ...))
+constexpr double poly6(const double t,
+    const double c0, const double c1, const double c2, const double c3,
+    const double c4, const double c5, const double c6)
+{
+    return c0 + t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * (c5 + t * c6)))));
+}
+
+// channel: 0 = red, 1 = green, 2 = blue
+constexpr double viridis(const double t, const int channel)
+{
+    return (channel == 0) ? poly6(t, 0.2777273272234177, 0.1050930431085774, -0.3308618287255563, -4.634230498983486, 6.228269936347081, 4.776384997670288, -5.435455855934631)
+         : (channel == 1) ? poly6(t, 0.005407344544966578, 1.404613529898575, 0.214847559468213, -5.799100973351585, 14.17993336680509, -13.74514537774601, 4.645852612178535)
+         :                  poly6(t, 0.3340998053353061, 1.384590162594685, 0.09509516302823659, -19.33244095627987, 56.69055260068105, -65.35303263337234, 26.3124352495832);
+}
+
+constexpr double plasma(const double t, const int channel)
+{
+    return (channel == 0) ? poly6(t, 0.05873234392399702, 2.176514634195958, -2.689460476458034, 6.130348345893603, -11.10743619062271, 10.02306557647065, -3.658713842777788)
+         : (channel == 1) ? poly6(t, 0.02333670892565664, 0.2383834171260182, -7.455851135738909, 42.3461881477227, -82.66631109428045, 71.41361770095349, -22.93153465461149)
+         :                  poly6(t, 0.5433401826748754, 0.7539604599784036, 3.110799939717086, -28.51885465332158, 60.13984767418263, -54.07218655560067, 18.19190778539828);
+}
+
+constexpr double magma(const double t, const int channel)
+{
+    return (channel == 0) ? poly6(t, -0.002136485053939582, 0.2516605407371642, 8.353717279216625, -27.66873308576866, 52.17613981234068, -50.76852536473588, 18.65570506591883)
+         : (channel == 1) ? poly6(t, -0.000749655052795221, 0.6775232436837668, -3.577719514958484, 14.26473078096533, -27.94360607168351, 29.04658282127291, -11.48977351997711)
+         :                  poly6(t, -0.005386127855323933, 2.494026599312351, 0.3144679030132573, -13.64921318813922, 12.94416944238394, 4.23415299384598, -5.601961508734096);
+}
+
+constexpr double inferno(const double t, const int channel)
+{
+    return (channel == 0) ? poly6(t, 0.0002189403691192265, 0.1065134194856116, 11.60249308247187, -41.70399613139459, 77.162935699427, -71.31942824499214, 25.13112622477341)
+         : (channel == 1) ? poly6(t, 0.001651004631001012, 0.5639564367884091, -3.972853965665698, 17.43639888205313, -33.40235894210092, 32.62606426397723, -12.24266895238567)
+         :                  poly6(t, -0.01948089843709184, 3.932712388889277, -15.9423941062914, 44.35414519872813, -81.80730925738993, 73.20951985803202, -23.07032500287172);
+}
+
+constexpr double turbo(const double t, const int channel)
+{
+    return (channel == 0) ? poly6(t, 0.13572138, 4.61539260, -42.66032258, 132.13108234, -152.94239396, 59.28637943, 0.0)
+         : (channel == 1) ? poly6(t, 0.09140261, 2.19418839, 4.84296658, -14.18503333, 4.27729857, 2.82956604, 0.0)
+         :                  poly6(t, 0.10667330, 12.64194608, -60.58204836, 110.36276771, -89.90310912, 27.34824973, 0.0);
+}
+
+constexpr double jet(const double t, const int channel)
+{
+    return clamp01(1.5 - abs_(4.0 * t - double(3 - channel)));
+}
+
+// MATLAB's hot(64), continued linearly between its entries
+constexpr double hot(const double t, const int channel)
+{
+    return (channel == 0) ? clamp01((63.0 * t + 1.0) / 24.0)
+         : (channel == 1) ? clamp01((63.0 * t - 23.0) / 24.0)
+         :                  clamp01((63.0 * t - 47.0) / 16.0);
+}
+
+constexpr double copper(const double t, const int channel)
+{
+    return (channel == 0) ? clamp01(1.25 * t) : (channel == 1) ? 0.7812 * t : 0.4975 * t;
+}
+
+constexpr double value(const colormap_kind kind, const double t, const int channel)
+{
+    return (kind == cmap_hot)     ? hot(t, channel)
+         : (kind == cmap_copper)  ? copper(t, channel)
+         : (kind == cmap_jet)     ? jet(t, channel)
+         : (kind == cmap_viridis) ? viridis(t, channel)
+         : (kind == cmap_plasma)  ? plasma(t, channel)
+         : (kind == cmap_magma)   ? magma(t, channel)
+         : (kind == cmap_inferno) ? inferno(t, channel)
+         : (kind == cmap_turbo)   ? turbo(t, channel)
+         : t;
+}
+
+constexpr double position(const std::size_t i, const std::size_t n)
+{
+    return (n > 1) ? double(i) / double(n - 1) : 0.0;
+}
+
+template <class PixelType>
+constexpr PixelType entry(const colormap_kind kind, const std::size_t i, const std::size_t n)
+{
+    return PixelType(
+        to_component(value(kind, position(i, n), 0)),
+        to_component(value(kind, position(i, n), 1)),
+        to_component(value(kind, position(i, n), 2)) );
+}
+
+// index pack 0 .. N-1 - built with logarithmic template depth
+template <std::size_t... I> struct index_list {};
+
+template <class A, class B> struct concat_index_lists;
+template <std::size_t... A, std::size_t... B>
+struct concat_index_lists< index_list<A...>, index_list<B...> >
+{
+    using type = index_list<A..., (sizeof...(A) + B)...>;
+};
+
+template <std::size_t N>
+struct make_index_list
+{
+    using type = typename concat_index_lists<
+        typename make_index_list<N / 2>::type,
+        typename make_index_list<N - N / 2>::type >::type;
+};
+template <> struct make_index_list<0> { using type = index_list<>; };
+template <> struct make_index_list<1> { using type = index_list<0>; };
+
+template <class PixelType, std::size_t N, std::size_t... I>
+constexpr std::array<PixelType, N> generate(const colormap_kind kind, index_list<I...>)
+{
+    return std::array<PixelType, N>{ { entry<PixelType>(kind, I, N)... } };
+}
+
+}
+
+/// colormap with N entries of PixelType (rgb_t, bgr_t, rgba_t or abgr_t) at compile time:
+///   static constexpr std::array<bgr_t, 256> lut = generate_colormap<bgr_t, 256>(cmap_viridis);
+template <class PixelType, std::size_t N>
+constexpr std::array<PixelType, N> generate_colormap(const colormap_kind kind)
+{
+    return colormap_detail::generate<PixelType, N>(kind, typename colormap_detail::make_index_list<N>::type());
+}
+
+/// same colormaps at runtime: n entries into cmap
+template <class PixelType>
+inline void generate_colormap(const colormap_kind kind, PixelType cmap[], const std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        cmap[i] = colormap_detail::entry<PixelType>(kind, i, n);
+}
+
+}
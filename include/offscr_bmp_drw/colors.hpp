@@ -98,7 +98,7 @@ struct alignas(unsigned char) rgb_t
     rgb_t() = default;
     rgb_t(const rgb_t &) = default;
 
-    rgb_t(component r, component g, component b)
+    constexpr rgb_t(component r, component g, component b)
         : red(r), green(g), blue(b) { }
 
     static rgb_t from(const uint32_t u)
@@ -133,11 +133,11 @@ RGBColorType scale_rgb(RGBColorType c, float s) {
 }
 
 
-rgb_t::component * begin(rgb_t &c) { return &c.red; }
+rgb_t::component * begin(rgb_t &c) { return reinterpret_cast<rgb_t::component *>(&c); }
 rgb_t::component * end(rgb_t &c)   { return begin(c) + 3; }
-const rgb_t::component * begin(const rgb_t &c) { return &c.red; }
+const rgb_t::component * begin(const rgb_t &c) { return reinterpret_cast<const rgb_t::component *>(&c); }
 const rgb_t::component * end(const rgb_t &c)   { return begin(c) + 3; }
-const rgb_t::component * cbegin(const rgb_t &c) { return &c.red; }
+const rgb_t::component * cbegin(const rgb_t &c) { return reinterpret_cast<const rgb_t::component *>(&c); }
 const rgb_t::component * cend(const rgb_t &c)   { return begin(c) + 3; }
 rgb_t::component * red  (rgb_t &c) { return &c.red;   }
 rgb_t::component * green(rgb_t &c) { return &c.green; }
@@ -166,10 +166,10 @@ struct alignas(unsigned char) bgr_t
     bgr_t() = default;
     bgr_t(const bgr_t &) = default;
 
-    bgr_t(const rgb_t & c)
+    constexpr bgr_t(const rgb_t & c)
         : blue(c.blue), green(c.green), red(c.red) { }
 
-    bgr_t(component r, component g, component b)
+    constexpr bgr_t(component r, component g, component b)
         : blue(b), green(g), red(r) { }
 
     static bgr_t from(const uint32_t u)
@@ -194,11 +194,11 @@ struct alignas(unsigned char) bgr_t
     component   red;
 };
 
-bgr_t::component * begin(bgr_t &c) { return &c.blue; }
+bgr_t::component * begin(bgr_t &c) { return reinterpret_cast<bgr_t::component *>(&c); }
 bgr_t::component * end(bgr_t &c)   { return begin(c) + 3; }
-const bgr_t::component * begin(const bgr_t &c) { return &c.blue; }
+const bgr_t::component * begin(const bgr_t &c) { return reinterpret_cast<const bgr_t::component *>(&c); }
 const bgr_t::component * end(const bgr_t &c)   { return begin(c) + 3; }
-const bgr_t::component * cbegin(const bgr_t &c) { return &c.blue; }
+const bgr_t::component * cbegin(const bgr_t &c) { return reinterpret_cast<const bgr_t::component *>(&c); }
 const bgr_t::component * cend(const bgr_t &c)   { return begin(c) + 3; }
 bgr_t::component * red  (bgr_t &c) { return &c.red;   }
 bgr_t::component * green(bgr_t &c) { return &c.green; }
@@ -227,10 +227,10 @@ struct alignas(unsigned char) rgba_t
     rgba_t() = default;
     rgba_t( const rgba_t & ) = default;
 
-    rgba_t( const rgb_t & c )
+    constexpr rgba_t( const rgb_t & c )
         : red(c.red), green(c.green), blue(c.blue), alpha(0) { }
 
-    rgba_t(component r, component g, component b)
+    constexpr rgba_t(component r, component g, component b)
         : red(r), green(g), blue(b), alpha(0) { }
 
     static rgba_t from(const uint32_t u)
@@ -256,11 +256,11 @@ struct alignas(unsigned char) rgba_t
     component alpha;
 };
 
-rgba_t::component * begin(rgba_t &c) { return &c.red; }
+rgba_t::component * begin(rgba_t &c) { return reinterpret_cast<rgba_t::component *>(&c); }
 rgba_t::component * end(rgba_t &c)   { return begin(c) + 4; }
-const rgba_t::component * begin(const rgba_t &c) { return &c.red; }
+const rgba_t::component * begin(const rgba_t &c) { return reinterpret_cast<const rgba_t::component *>(&c); }
 const rgba_t::component * end(const rgba_t &c)   { return begin(c) + 4; }
-const rgba_t::component * cbegin(const rgba_t &c) { return &c.red; }
+const rgba_t::component * cbegin(const rgba_t &c) { return reinterpret_cast<const rgba_t::component *>(&c); }
 const rgba_t::component * cend(const rgba_t &c)   { return begin(c) + 4; }
 rgba_t::component * red  (rgba_t &c) { return &c.red;   }
 rgba_t::component * green(rgba_t &c) { return &c.green; }
@@ -289,10 +289,10 @@ struct alignas(unsigned char) abgr_t
     abgr_t() = default;
     abgr_t( const abgr_t & ) = default;
 
-    abgr_t( const rgb_t & c )
+    constexpr abgr_t( const rgb_t & c )
         : alpha(0), blue(c.blue), green(c.green), red(c.red) { }
 
-    abgr_t(component r, component g, component b)
+    constexpr abgr_t(component r, component g, component b)
         : alpha(0), blue(b), green(g), red(r) { }
 
     static abgr_t from(const uint32_t u)
@@ -318,11 +318,11 @@ struct alignas(unsigned char) abgr_t
     component   red;
 };
 
-abgr_t::component * begin(abgr_t &c) { return &c.alpha; }
+abgr_t::component * begin(abgr_t &c) { return reinterpret_cast<abgr_t::component *>(&c); }
 abgr_t::component * end(abgr_t &c)   { return begin(c) + 4; }
-const abgr_t::component * begin(const abgr_t &c) { return &c.alpha; }
+const abgr_t::component * begin(const abgr_t &c) { return reinterpret_cast<const abgr_t::component *>(&c); }
 const abgr_t::component * end(const abgr_t &c)   { return begin(c) + 4; }
-const abgr_t::component * cbegin(const abgr_t &c) { return &c.alpha; }
+const abgr_t::component * cbegin(const abgr_t &c) { return reinterpret_cast<const abgr_t::component *>(&c); }
 const abgr_t::component * cend(const abgr_t &c)   { return begin(c) + 4; }
 abgr_t::component * red  (abgr_t &c) { return &c.red;   }
 abgr_t::component * green(abgr_t &c) { return &c.green; }
@@ -382,6 +382,57 @@ double &set_white(double &c) { c = 1.0; return c; }
 double &set_gray(double &c, double g) { c = g; return c; }
 
 
+// number and type of color components per pixel
+//   rgb_t, bgr_t: 3 x unsigned char; rgba_t, abgr_t: 4 x unsigned char (alpha included)
+//   float, double: 1 component
+template <class PixelType>
+struct pixel_traits
+{
+    using component_t = typename PixelType::component;
+    static constexpr unsigned num_components = unsigned(sizeof(PixelType) / sizeof(component_t));
+    static constexpr bool is_floating = false;
+};
+
+template <>
+struct pixel_traits<float>
+{
+    using component_t = float;
+    static constexpr unsigned num_components = 1;
+    static constexpr bool is_floating = true;
+};
+
+template <>
+struct pixel_traits<double>
+{
+    using component_t = double;
+    static constexpr unsigned num_components = 1;
+    static constexpr bool is_floating = true;
+};
+
+// conversion of a (filtered) Float value back into a color component:
+//   rounded and saturated for integral components, unchanged for floating point
+template <class ComponentType, bool IsFloating = std::numeric_limits<ComponentType>::is_iec559>
+struct component_saturation
+{
+    template <class Float>
+    static inline ComponentType from(const Float v)
+    {
+        constexpr Float hi = Float(std::numeric_limits<ComponentType>::max());
+        return (v <= Float(0)) ? ComponentType(0) : (v >= hi) ? ComponentType(hi) : ComponentType(v + Float(0.5));
+    }
+};
+
+template <class ComponentType>
+struct component_saturation<ComponentType, true>
+{
+    template <class Float>
+    static inline ComponentType from(const Float v)
+    {
+        return ComponentType(v);
+    }
+};
+
+
 
 inline bool operator==(const rgb_t& c0, const rgb_t& c1)
 {
@@ -21,9 +21,13 @@
 #pragma once
 
 #include "bitmap_image_rgb.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
 
+#include <cmath>
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 
 namespace OffScreenBitmapDraw
@@ -49,6 +53,88 @@ inline std::size_t convert_rsp_to_image(const ResponseImage& resp_image, const P
     return (resp_image.width() * resp_image.height());
 }
 
+/// value range for colormapping a stream of frames:
+/// with reuse set and a valid range, convert_float_to_rgb() maps with the stored
+/// range and updates it from the current frame in the same pass - one pass per
+/// frame, the range lags one frame behind. without reuse the range is only reported
+template <class Float>
+struct colormap_range
+{
+    Float min = Float(0);
+    Float max = Float(0);
+    bool valid = false;
+    bool reuse = true;
+};
+
+/// parallel min/max reduction over the image: bands of rows
+template <class FloatImageType, class Float = typename FloatImageType::pixel_t>
+inline bool minmax_float_image(const FloatImageType& float_image, Float& fmin, Float& fmax, const unsigned num_threads = 1)
+{
+    const unsigned h = float_image.height();
+    std::vector<Float> band_min(parallel_num_bands(h, num_threads), std::numeric_limits<Float>::max());
+    std::vector<Float> band_max(band_min.size(), std::numeric_limits<Float>::lowest());
+    parallel_for_bands(h, num_threads, [&](const unsigned y0, const unsigned y1, const unsigned band) {
+        for (unsigned y = y0; y < y1; ++y)
+            min_max_values(float_image.row(y), float_image.row(y) + float_image.width(), band_min[band], band_max[band]);
+    });
+    fmin = std::numeric_limits<Float>::max();
+    fmax = std::numeric_limits<Float>::lowest();
+    for (std::size_t b = 0; b < band_min.size(); ++b)
+    {
+        fmin = std::min(fmin, band_min[b]);
+        fmax = std::max(fmax, band_max[b]);
+    }
+    return fmin <= fmax;
+}
+
+/// maps n values to the palette (already converted to the destination pixel type):
+/// indices are computed in chunks by a vectorizable loop, then looked up.
+/// with track_minmax, the min/max of the values are accumulated in the same pass
+template <class Float, class RGB>
+inline void colormap_row(
+    const Float* src,
+    RGB* dest,
+    const unsigned n,
+    const RGB* lut,
+    const Float fmin,
+    const Float scale,
+    const Float index_max,
+    const bool track_minmax,
+    Float& vmin,
+    Float& vmax
+    )
+{
+    constexpr unsigned chunk = 256;
+    int idx[chunk];
+    for (unsigned x0 = 0; x0 < n; x0 += chunk)
+    {
+        const unsigned m = std::min(chunk, n - x0);
+        const Float* s = src + x0;
+        for (unsigned i = 0; i < m; ++i)
+        {
+            Float t = (s[i] - fmin) * scale;
+            t = (t > Float(0)) ? t : Float(0);      // NaN -> 0
+            t = (t < index_max) ? t : index_max;
+            idx[i] = static_cast<int>(t);
+        }
+        if (track_minmax)
+        {
+            for (unsigned i = 0; i < m; ++i)
+            {
+                vmin = (s[i] < vmin) ? s[i] : vmin;
+                vmax = (s[i] > vmax) ? s[i] : vmax;
+            }
+        }
+        RGB* d = dest + x0;
+        for (unsigned i = 0; i < m; ++i)
+            d[i] = lut[idx[i]];
+    }
+}
+
+/// maps float_image to rgb_image through the palette, linear from min to max * max_factor
+/// (from 0, if abs_min is false). max_factor <= 0 maps the fixed range [0 .. 1].
+/// the min/max scan and the mapping run in bands on num_threads (0 = hardware concurrency).
+/// range: see colormap_range - reuse of the previous frame's range saves the min/max scan
 template <typename Palette, class FloatImageType, class RGBImageType = bitmap_image_rgb<> >
 inline bool convert_float_to_rgb(
     const FloatImageType& float_image,
@@ -56,54 +142,282 @@ inline bool convert_float_to_rgb(
     const Palette* palette,
     const int palette_size,
     typename FloatImageType::pixel_t max_factor,
-    bool abs_min = true
+    bool abs_min = true,
+    const unsigned num_threads = 1,
+    colormap_range<typename FloatImageType::pixel_t>* range = nullptr
     )
 {
     if ( float_image.width() > rgb_image.width() || float_image.height() > rgb_image.height() )
         return false;
+    if ( palette_size <= 0 )
+        return false;
 
     using Float = typename FloatImageType::pixel_t;
     using RGB = typename RGBImageType::pixel_t;
 
+    auto mapping_range = [&](Float vmin, Float vmax, Float& fmin, Float& fmax) {
+        fmin = abs_min ? vmin : Float(0);
+        fmax = vmax * max_factor;
+    };
+
     Float fmin = 0;
     Float fmax = 1;
-    if (max_factor > 0)
+    const bool fused = (max_factor > 0) && range && range->reuse && range->valid;
+    if (fused)
     {
-        fmin = std::numeric_limits<Float>::max();
-        fmax = std::numeric_limits<Float>::lowest();
-        const Float *row = float_image.row(0);
-        for (unsigned y = 0; y < float_image.height(); ++y)
-        {
-            // fmin = std::min( fmin, *std::min_element(row, row + float_image.width()) );
-            // fmax = std::max( fmax, *std::max_element(row, row + float_image.width()) );
-            auto minmax = std::minmax_element(row, row + float_image.width());
-            fmin = std::min( fmin, *minmax.first );
-            fmax = std::max( fmax, *minmax.second );
-            row += float_image.row_increment();
-        }
-        fmax *= max_factor;
-        if (!abs_min)
-            fmin = Float(0);
+        fmin = range->min;
+        fmax = range->max;
+    }
+    else if (max_factor > 0)
+    {
+        Float vmin, vmax;
+        if (!minmax_float_image(float_image, vmin, vmax, num_threads))
+            return false;
+        mapping_range(vmin, vmax, fmin, fmax);
     }
     const Float frange = fmax - fmin;
+    if (range && !fused)
+    {
+        range->min = fmin;
+        range->max = fmax;
+        range->valid = (frange > 0);
+    }
     if (frange <= 0)
         return false;
     const Float scale = (palette_size - Float(0.01)) / frange;
-    const int index_max = palette_size - 1;
+    const Float index_max = Float(palette_size - 1);
+
+    const std::vector<RGB> lut(palette, palette + palette_size);
+    const unsigned h = float_image.height();
+    const unsigned n_bands = parallel_num_bands(h, num_threads);
+    std::vector<Float> band_min(n_bands, std::numeric_limits<Float>::max());
+    std::vector<Float> band_max(n_bands, std::numeric_limits<Float>::lowest());
+    parallel_for_bands(h, num_threads, [&](const unsigned y0, const unsigned y1, const unsigned band) {
+        for (unsigned y = y0; y < y1; ++y)
+            colormap_row(float_image.row(y), rgb_image.row(y), float_image.width(), lut.data(),
+                         fmin, scale, index_max, fused, band_min[band], band_max[band]);
+    });
 
-    for (unsigned y = 0; y < float_image.height(); ++y)
+    if (fused)
     {
-        const Float *src_row = float_image.row(y);
-        RGB *dest_row = rgb_image.row(y);
-        for (unsigned x = 0; x < float_image.width(); ++x)
+        Float vmin = std::numeric_limits<Float>::max();
+        Float vmax = std::numeric_limits<Float>::lowest();
+        for (unsigned b = 0; b < n_bands; ++b)
         {
-            const Float v = *src_row++;
-            int index = static_cast<int>( (v - fmin) * scale );
-            // *dest_row++ = palette[std::clamp(index, 0, index_max)];  // requires c++17
-            *dest_row++ = palette[ (index < 0) ? 0 : (index > index_max ) ? index_max : index ];
+            vmin = std::min(vmin, band_min[b]);
+            vmax = std::max(vmax, band_max[b]);
         }
+        mapping_range(vmin, vmax, range->min, range->max);
+        range->valid = (range->max > range->min);
     }
     return true;
 }
 
+
+enum colormap_scale {
+    scale_linear   = 0,     // linear between the clip values
+    scale_sqrt     = 1,     // square root - more contrast in the low range
+    scale_log      = 2,     // logarithmic over log_decades
+    scale_equalize = 3      // histogram equalization: each color gets about the same number of pixels
+};
+
+/// autoscaling for convert_float_to_rgb_scaled().
+/// the percentiles clip outliers - e.g. 1 and 99 keep a few hot pixels from washing out the heatmap
+template <class Float>
+struct colormap_scaling
+{
+    colormap_scale scale = scale_linear;
+    Float low_percentile  = Float(0);       // 0: minimum - exact
+    Float high_percentile = Float(100);     // 100: maximum - exact
+    Float log_decades = Float(3);           // scale_log: dynamic range in decades
+    unsigned lut_size = 4096;               // LUT entries = histogram bins for scale_equalize
+    unsigned max_samples = 65536;           // values sampled for percentiles in (0 .. 100)
+};
+
+/// the approximate percentiles [0 .. 100] of float_image from at most max_samples
+/// pixels on a grid of evenly strided rows and columns - a single stride over all
+/// pixels could be a divisor of the width and see only a few columns.
+/// NaNs are skipped. returns false, if there are no values
+template <class FloatImageType, class Float = typename FloatImageType::pixel_t>
+inline bool sample_percentiles(
+    const FloatImageType& float_image,
+    const Float low_percentile,
+    const Float high_percentile,
+    const unsigned max_samples,
+    Float& low_value,
+    Float& high_value
+    )
+{
+    const std::size_t w = float_image.width();
+    const std::size_t h = float_image.height();
+    const std::size_t n = w * h;
+    if (!n)
+        return false;
+    const std::size_t m = std::max(1U, max_samples);
+    // about square cells of n / m pixels
+    std::size_t stride_x = std::min(w, std::max<std::size_t>(1, std::size_t(std::ceil(std::sqrt(double(n) / double(m))))));
+    if ((w + stride_x - 1) / stride_x > m)
+        stride_x = (w + m - 1) / m;
+    const std::size_t cols = (w + stride_x - 1) / stride_x;
+    const std::size_t rows = std::max<std::size_t>(1, m / cols);
+    const std::size_t stride_y = (h + rows - 1) / rows;
+    std::vector<Float> samples;
+    samples.reserve(cols * rows);
+    for (std::size_t y = stride_y / 2; y < h; y += stride_y)
+    {
+        const Float * row = float_image.row(unsigned(y));
+        for (std::size_t x = stride_x / 2; x < w; x += stride_x)
+        {
+            const Float v = row[x];
+            if (v == v)
+                samples.push_back(v);
+        }
+    }
+    if (samples.empty())
+        return false;
+
+    auto nth = [&](const Float p) -> Float {
+        const Float q = std::min(Float(100), std::max(Float(0), p)) / Float(100);
+        const std::size_t k = std::min(samples.size() - 1, std::size_t(q * Float(samples.size() - 1) + Float(0.5)));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    };
+    low_value = nth(low_percentile);
+    high_value = nth(high_percentile);
+    return true;
+}
+
+/// histogram of bins over [fmin .. fmax] - values outside go to the first/last bin, NaNs are skipped.
+/// bands of rows fill their own histogram, summed up at the end
+template <class FloatImageType, class Float = typename FloatImageType::pixel_t>
+inline std::vector<std::size_t> float_image_histogram(
+    const FloatImageType& float_image,
+    const Float fmin,
+    const Float fmax,
+    const unsigned bins,
+    const unsigned num_threads = 1
+    )
+{
+    std::vector<std::size_t> hist(bins, 0);
+    if (!bins || !(fmax > fmin))
+        return hist;
+    const unsigned h = float_image.height();
+    const unsigned w = float_image.width();
+    const Float scale = (bins - Float(0.01)) / (fmax - fmin);
+    const Float index_max = Float(bins - 1);
+    std::vector< std::vector<std::size_t> > band_hist(parallel_num_bands(h, num_threads));
+    parallel_for_bands(h, num_threads, [&](const unsigned y0, const unsigned y1, const unsigned band) {
+        std::vector<std::size_t>& bh = band_hist[band];
+        bh.assign(bins, 0);
+        for (unsigned y = y0; y < y1; ++y)
+        {
+            const Float *row = float_image.row(y);
+            for (unsigned x = 0; x < w; ++x)
+            {
+                const Float v = row[x];
+                if (v != v)
+                    continue;
+                Float t = (v - fmin) * scale;
+                t = (t > Float(0)) ? t : Float(0);
+                t = (t < index_max) ? t : index_max;
+                ++bh[static_cast<unsigned>(t)];
+            }
+        }
+    });
+    for (const std::vector<std::size_t>& bh : band_hist)
+        for (unsigned b = 0; b < bins; ++b)
+            hist[b] += bh[b];
+    return hist;
+}
+
+/// maps float_image to rgb_image through the palette with autoscaling:
+/// the clip range comes from exact min/max or sampled percentiles, the scale curve
+/// (and the histogram for scale_equalize) is evaluated once per LUT entry.
+/// then each pixel costs one LUT lookup - same mapping loop as convert_float_to_rgb()
+template <typename Palette, class FloatImageType, class RGBImageType = bitmap_image_rgb<> >
+inline bool convert_float_to_rgb_scaled(
+    const FloatImageType& float_image,
+    RGBImageType& rgb_image,
+    const Palette* palette,
+    const int palette_size,
+    const colormap_scaling<typename FloatImageType::pixel_t>& scaling,
+    const unsigned num_threads = 1,
+    colormap_range<typename FloatImageType::pixel_t>* used_range = nullptr
+    )
+{
+    if ( float_image.width() > rgb_image.width() || float_image.height() > rgb_image.height() )
+        return false;
+    if ( palette_size <= 0 || scaling.lut_size < 2 )
+        return false;
+
+    using Float = typename FloatImageType::pixel_t;
+    using RGB = typename RGBImageType::pixel_t;
+
+    Float fmin = Float(0), fmax = Float(0);
+    const bool exact_low = !(scaling.low_percentile > Float(0));
+    const bool exact_high = !(scaling.high_percentile < Float(100));
+    if (exact_low || exact_high)
+    {
+        if (!minmax_float_image(float_image, fmin, fmax, num_threads))
+            return false;
+    }
+    if (!exact_low || !exact_high)
+    {
+        Float lo, hi;
+        if (!sample_percentiles(float_image, scaling.low_percentile, scaling.high_percentile, scaling.max_samples, lo, hi))
+            return false;
+        if (!exact_low)  fmin = lo;
+        if (!exact_high) fmax = hi;
+    }
+    if (used_range)
+    {
+        used_range->min = fmin;
+        used_range->max = fmax;
+        used_range->valid = (fmax > fmin);
+    }
+    if (!(fmax > fmin))
+        return false;
+
+    const unsigned bins = scaling.lut_size;
+    std::vector<std::size_t> hist;
+    double total = 0;
+    if (scaling.scale == scale_equalize)
+    {
+        hist = float_image_histogram(float_image, fmin, fmax, bins, num_threads);
+        for (const std::size_t c : hist)
+            total += double(c);
+        if (total <= 0)
+            return false;
+    }
+
+    // curve per LUT entry: u in [0 .. 1] at the bin center -> t in [0 .. 1]
+    const double log_gain = std::pow(10.0, double(scaling.log_decades)) - 1.0;
+    std::vector<RGB> lut(bins);
+    double cumulated = 0;
+    for (unsigned b = 0; b < bins; ++b)
+    {
+        const double u = (b + 0.5) / double(bins);
+        double t = u;
+        switch (scaling.scale)
+        {
+        case scale_sqrt:        t = std::sqrt(u); break;
+        case scale_log:         t = (log_gain > 0) ? std::log1p(log_gain * u) / std::log1p(log_gain) : u; break;
+        case scale_equalize:    t = (cumulated + 0.5 * double(hist[b])) / total; cumulated += double(hist[b]); break;
+        default:                break;
+        }
+        const int index = static_cast<int>(t * (palette_size - 0.01));
+        lut[b] = palette[ (index < 0) ? 0 : (index > palette_size - 1) ? (palette_size - 1) : index ];
+    }
+
+    const Float scale = (bins - Float(0.01)) / (fmax - fmin);
+    const Float index_max = Float(bins - 1);
+    parallel_for_bands(float_image.height(), num_threads, [&](const unsigned y0, const unsigned y1, const unsigned) {
+        Float untracked_min = 0, untracked_max = 0;
+        for (unsigned y = y0; y < y1; ++y)
+            colormap_row(float_image.row(y), rgb_image.row(y), float_image.width(), lut.data(),
+                         fmin, scale, index_max, false, untracked_min, untracked_max);
+    });
+    return true;
+}
+
 }
@@ -0,0 +1,485 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "bitmap_image_generic.hpp"
+#include "colors.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+enum border_mode {
+    border_clamp    = 0,    // repeat the edge pixel
+    border_mirror   = 1,    // mirror at the edge - edge pixel included, as in reflective_image()
+    border_wrap     = 2,    // periodic continuation
+    border_constant = 3     // constant border_value outside the image
+};
+
+// maps coordinate i, which may lie outside [0 .. n), into [0 .. n)
+// returns -1 for border_constant, when i is outside
+inline int border_index(int i, const int n, const border_mode mode)
+{
+    if (i >= 0 && i < n)
+        return i;
+    switch (mode)
+    {
+    case border_clamp:
+        return (i < 0) ? 0 : (n - 1);
+    case border_mirror:
+    {
+        const int period = 2 * n;
+        i %= period;
+        if (i < 0)
+            i += period;
+        return (i < n) ? i : (period - 1 - i);
+    }
+    case border_wrap:
+        i %= n;
+        return (i < 0) ? (i + n) : i;
+    default:
+        return -1;
+    }
+}
+
+
+/// dense 2D kernel. applied as correlation:
+///   dst(x, y) = sum_{i,j} kernel(i, j) * src(x + i - anchor_x, y + j - anchor_y)
+template <class Float = float>
+class convolution_kernel
+{
+public:
+    using value_t = Float;
+
+    convolution_kernel()
+        : width_(0), height_(0), anchor_x_(0), anchor_y_(0), coeffs_()
+    {}
+
+    convolution_kernel(const unsigned width, const unsigned height, const Float* coeffs = nullptr)
+        : width_(width), height_(height)
+        , anchor_x_(width / 2), anchor_y_(height / 2)
+        , coeffs_(std::size_t(width) * height, Float(0))
+    {
+        if (coeffs)
+            std::copy(coeffs, coeffs + coeffs_.size(), coeffs_.begin());
+    }
+
+    inline unsigned width() const    { return width_;  }
+    inline unsigned height() const   { return height_; }
+    inline unsigned anchor_x() const { return anchor_x_; }
+    inline unsigned anchor_y() const { return anchor_y_; }
+
+    bool set_anchor(const unsigned x, const unsigned y)
+    {
+        if (x >= width_ || y >= height_)
+            return false;
+        anchor_x_ = x;
+        anchor_y_ = y;
+        return true;
+    }
+
+    inline const Float & operator()(const unsigned x, const unsigned y) const
+    {
+        return coeffs_[y * width_ + x];
+    }
+
+    inline Float & operator()(const unsigned x, const unsigned y)
+    {
+        return coeffs_[y * width_ + x];
+    }
+
+    inline const Float * data() const
+    {
+        return coeffs_.data();
+    }
+
+    Float sum() const
+    {
+        Float s = 0;
+        for (const Float c : coeffs_)
+            s += c;
+        return s;
+    }
+
+    convolution_kernel & normalize()
+    {
+        const Float s = sum();
+        if (s != Float(0))
+        {
+            for (Float & c : coeffs_)
+                c /= s;
+        }
+        return *this;
+    }
+
+    // rank-1 decomposition: (*this)(x, y) == col[y] * row[x]
+    // returns false, if the kernel is not separable within rel_eps
+    bool separate(std::vector<Float>& row, std::vector<Float>& col, const Float rel_eps = Float(1E-5)) const
+    {
+        if (coeffs_.empty())
+            return false;
+        unsigned px = 0, py = 0;
+        Float pivot = 0;
+        for (unsigned y = 0; y < height_; ++y)
+            for (unsigned x = 0; x < width_; ++x)
+                if (std::abs((*this)(x, y)) > std::abs(pivot))
+                {
+                    pivot = (*this)(x, y);
+                    px = x;
+                    py = y;
+                }
+
+        row.assign(width_, Float(0));
+        col.assign(height_, Float(0));
+        if (pivot == Float(0))
+            return true;
+
+        for (unsigned x = 0; x < width_; ++x)
+            row[x] = (*this)(x, py) / pivot;
+        for (unsigned y = 0; y < height_; ++y)
+            col[y] = (*this)(px, y);
+
+        const Float tolerance = rel_eps * std::abs(pivot);
+        for (unsigned y = 0; y < height_; ++y)
+            for (unsigned x = 0; x < width_; ++x)
+                if (std::abs((*this)(x, y) - col[y] * row[x]) > tolerance)
+                    return false;
+        return true;
+    }
+
+    // outer product: kernel(x, y) = col[y] * row[x]
+    static convolution_kernel outer_product(const std::vector<Float>& row, const std::vector<Float>& col)
+    {
+        convolution_kernel k(unsigned(row.size()), unsigned(col.size()));
+        for (unsigned y = 0; y < k.height_; ++y)
+            for (unsigned x = 0; x < k.width_; ++x)
+                k(x, y) = col[y] * row[x];
+        return k;
+    }
+
+    static convolution_kernel box(const unsigned width, const unsigned height)
+    {
+        convolution_kernel k(width, height);
+        std::fill(k.coeffs_.begin(), k.coeffs_.end(), Float(1) / Float(width * height));
+        return k;
+    }
+
+    // sampled and normalized 1D gaussian. radius 0: use ceil(3 * sigma).
+    // sigma <= 0 is the limit: 1 at the center
+    static std::vector<Float> gaussian_1d(const Float sigma, unsigned radius = 0)
+    {
+        if (!(sigma > Float(0)))
+        {
+            std::vector<Float> g(2 * radius + 1, Float(0));
+            g[radius] = Float(1);
+            return g;
+        }
+        if (!radius)
+            radius = unsigned(std::ceil(Float(3) * sigma));
+        std::vector<Float> g(2 * radius + 1);
+        const Float f = Float(-0.5) / (sigma * sigma);
+        Float s = 0;
+        for (unsigned i = 0; i < g.size(); ++i)
+        {
+            const Float d = Float(int(i) - int(radius));
+            g[i] = std::exp(f * d * d);
+            s += g[i];
+        }
+        for (Float & v : g)
+            v /= s;
+        return g;
+    }
+
+    static convolution_kernel gaussian(const Float sigma, const unsigned radius = 0)
+    {
+        const std::vector<Float> g = gaussian_1d(sigma, radius);
+        return outer_product(g, g);
+    }
+
+    // identity + amount * (identity - 3x3 box): not separable
+    static convolution_kernel sharpen(const Float amount = Float(1))
+    {
+        convolution_kernel k(3, 3);
+        std::fill(k.coeffs_.begin(), k.coeffs_.end(), -amount / Float(9));
+        k(1, 1) = Float(1) + amount - amount / Float(9);
+        return k;
+    }
+
+private:
+    unsigned width_;
+    unsigned height_;
+    unsigned anchor_x_;
+    unsigned anchor_y_;
+    std::vector<Float> coeffs_;
+};
+
+
+// row/column loops of the convolution. all work happens on interleaved Float rows
+// of (tile width x components) - with contiguous inner loops, which the compiler vectorizes.
+// the image is processed in column tiles of tile_width pixels, so that the ring buffers
+// of intermediate rows stay in cache; output rows are split into bands for the threads.
+template <class BitmapImageType, class Float>
+struct convolution_impl
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using component_t = typename pixel_traits<pixel_t>::component_t;
+    static constexpr unsigned N = pixel_traits<pixel_t>::num_components;
+    static constexpr unsigned tile_width = 256;
+
+    // loads n pixels of source row sy, using x index map, into buf (n * N values)
+    static void load_row(
+        const BitmapImageType& src, const int sy,
+        const int* xmap, const unsigned n,
+        const Float border_value, Float* buf)
+    {
+        if (sy < 0)
+        {
+            std::fill(buf, buf + n * N, border_value);
+            return;
+        }
+        const component_t* comps = cbegin(*src.row(unsigned(sy)));
+        for (unsigned i = 0; i < n; ++i, buf += N)
+        {
+            const int sx = xmap[i];
+            if (sx < 0)
+            {
+                for (unsigned c = 0; c < N; ++c)
+                    buf[c] = border_value;
+            }
+            else
+            {
+                const component_t* p = comps + std::size_t(sx) * N;
+                for (unsigned c = 0; c < N; ++c)
+                    buf[c] = Float(p[c]);
+            }
+        }
+    }
+
+    static void store_row(const Float* buf, const unsigned n, pixel_t* dst)
+    {
+        component_t* comps = begin(*dst);
+        for (unsigned i = 0; i < n * N; ++i)
+            comps[i] = component_saturation<component_t>::from(buf[i]);
+    }
+
+    static void setup_xmap(
+        std::vector<int>& xmap, const unsigned tx0, const unsigned n_padded,
+        const int anchor_x, const unsigned width, const border_mode border)
+    {
+        for (unsigned i = 0; i < n_padded; ++i)
+            xmap[i] = border_index(int(tx0 + i) - anchor_x, int(width), border);
+    }
+
+    static void separable_band(
+        const BitmapImageType& src, BitmapImageType& dst,
+        const std::vector<Float>& row_k, const int anchor_x,
+        const std::vector<Float>& col_k, const int anchor_y,
+        const border_mode border, const Float border_value,
+        const unsigned y0, const unsigned y1)
+    {
+        const unsigned w = src.width();
+        const unsigned h = src.height();
+        const unsigned kw = unsigned(row_k.size());
+        const unsigned kh = unsigned(col_k.size());
+        const unsigned stride = tile_width * N;
+        std::vector<int> xmap(tile_width + kw - 1);
+        std::vector<Float> padded((tile_width + kw - 1) * N);
+        std::vector<Float> ring(std::size_t(kh) * stride);
+        std::vector<Float> out(stride);
+        const int first_sy = int(y0) - anchor_y;
+
+        for (unsigned tx0 = 0; tx0 < w; tx0 += tile_width)
+        {
+            const unsigned tw = std::min(unsigned(tile_width), w - tx0);
+            const unsigned n = tw * N;
+            setup_xmap(xmap, tx0, tw + kw - 1, anchor_x, w, border);
+            int next_sy = first_sy;
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                const int last_sy = int(y) - anchor_y + int(kh) - 1;
+                for (; next_sy <= last_sy; ++next_sy)
+                {
+                    load_row(src, border_index(next_sy, int(h), border), xmap.data(), tw + kw - 1, border_value, padded.data());
+                    Float* hrow = &ring[ unsigned(next_sy - first_sy) % kh * stride ];
+                    std::fill(hrow, hrow + n, Float(0));
+                    for (unsigned k = 0; k < kw; ++k)
+                    {
+                        const Float c = row_k[k];
+                        const Float* p = &padded[k * N];
+                        for (unsigned i = 0; i < n; ++i)
+                            hrow[i] += c * p[i];
+                    }
+                }
+                std::fill(out.begin(), out.begin() + n, Float(0));
+                for (unsigned k = 0; k < kh; ++k)
+                {
+                    const Float c = col_k[k];
+                    const Float* hrow = &ring[ unsigned(int(y + k) - anchor_y - first_sy) % kh * stride ];
+                    for (unsigned i = 0; i < n; ++i)
+                        out[i] += c * hrow[i];
+                }
+                store_row(out.data(), tw, dst.row(y) + tx0);
+            }
+        }
+    }
+
+    static void dense_band(
+        const BitmapImageType& src, BitmapImageType& dst,
+        const convolution_kernel<Float>& kernel,
+        const border_mode border, const Float border_value,
+        const unsigned y0, const unsigned y1)
+    {
+        const unsigned w = src.width();
+        const unsigned h = src.height();
+        const unsigned kw = kernel.width();
+        const unsigned kh = kernel.height();
+        const int anchor_x = int(kernel.anchor_x());
+        const int anchor_y = int(kernel.anchor_y());
+        const unsigned stride = (tile_width + kw - 1) * N;
+        std::vector<int> xmap(tile_width + kw - 1);
+        std::vector<Float> ring(std::size_t(kh) * stride);
+        std::vector<Float> out(tile_width * N);
+        const int first_sy = int(y0) - anchor_y;
+
+        for (unsigned tx0 = 0; tx0 < w; tx0 += tile_width)
+        {
+            const unsigned tw = std::min(unsigned(tile_width), w - tx0);
+            const unsigned n = tw * N;
+            setup_xmap(xmap, tx0, tw + kw - 1, anchor_x, w, border);
+            int next_sy = first_sy;
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                const int last_sy = int(y) - anchor_y + int(kh) - 1;
+                for (; next_sy <= last_sy; ++next_sy)
+                    load_row(src, border_index(next_sy, int(h), border), xmap.data(), tw + kw - 1, border_value,
+                             &ring[ unsigned(next_sy - first_sy) % kh * stride ]);
+
+                std::fill(out.begin(), out.begin() + n, Float(0));
+                for (unsigned ky = 0; ky < kh; ++ky)
+                {
+                    const Float* srow = &ring[ unsigned(int(y + ky) - anchor_y - first_sy) % kh * stride ];
+                    for (unsigned kx = 0; kx < kw; ++kx)
+                    {
+                        const Float c = kernel(kx, ky);
+                        if (c == Float(0))
+                            continue;
+                        const Float* p = srow + kx * N;
+                        for (unsigned i = 0; i < n; ++i)
+                            out[i] += c * p[i];
+                    }
+                }
+                store_row(out.data(), tw, dst.row(y) + tx0);
+            }
+        }
+    }
+
+    static bool prepare_dst(const BitmapImageType& src, BitmapImageType& dst)
+    {
+        if (!src)
+            return false;
+        if (dst.width() != src.width() || dst.height() != src.height())
+            return dst.setwidth_height(src.width(), src.height());
+        return true;
+    }
+};
+
+
+/// dst := src convolved with row_kernel (horizontal) and col_kernel (vertical)
+/// anchors are at the kernel centers (size / 2)
+/// dst gets resized, if its dimension differs from src. src and dst may be the same image,
+///   but must not be partially overlapping slices.
+/// num_threads: 0 = hardware concurrency
+template <class BitmapImageType, class Float = float>
+inline bool convolve_separable(
+    const BitmapImageType& src,
+    BitmapImageType& dst,
+    const std::vector<Float>& row_kernel,
+    const std::vector<Float>& col_kernel,
+    const border_mode border = border_clamp,
+    const Float border_value = Float(0),
+    const unsigned num_threads = 1,
+    const int anchor_x = -1,
+    const int anchor_y = -1
+    )
+{
+    using Impl = convolution_impl<BitmapImageType, Float>;
+    if (row_kernel.empty() || col_kernel.empty())
+        return false;
+    if (src.cdata() == dst.cdata())
+    {
+        BitmapImageType copy;
+        copy = src;
+        return convolve_separable(copy, dst, row_kernel, col_kernel, border, border_value, num_threads, anchor_x, anchor_y);
+    }
+    if (!Impl::prepare_dst(src, dst))
+        return false;
+    const int ax = (anchor_x < 0) ? int(row_kernel.size() / 2) : anchor_x;
+    const int ay = (anchor_y < 0) ? int(col_kernel.size() / 2) : anchor_y;
+    parallel_for_bands(src.height(), num_threads,
+        [&](const unsigned y0, const unsigned y1, const unsigned) {
+            Impl::separable_band(src, dst, row_kernel, ax, col_kernel, ay, border, border_value, y0, y1);
+        });
+    return true;
+}
+
+/// dst := src convolved with kernel
+/// separable kernels are detected and decomposed automatically - then
+/// costing (kernel.width() + kernel.height()) instead of (kernel.width() * kernel.height()) per pixel
+template <class BitmapImageType, class Float = float>
+inline bool convolve(
+    const BitmapImageType& src,
+    BitmapImageType& dst,
+    const convolution_kernel<Float>& kernel,
+    const border_mode border = border_clamp,
+    const Float border_value = Float(0),
+    const unsigned num_threads = 1
+    )
+{
+    using Impl = convolution_impl<BitmapImageType, Float>;
+    if (kernel.width() == 0 || kernel.height() == 0)
+        return false;
+    std::vector<Float> row, col;
+    if (kernel.separate(row, col))
+        return convolve_separable(src, dst, row, col, border, border_value, num_threads,
+                                  int(kernel.anchor_x()), int(kernel.anchor_y()));
+
+    if (src.cdata() == dst.cdata())
+    {
+        BitmapImageType copy;
+        copy = src;
+        return convolve(copy, dst, kernel, border, border_value, num_threads);
+    }
+    if (!Impl::prepare_dst(src, dst))
+        return false;
+    parallel_for_bands(src.height(), num_threads,
+        [&](const unsigned y0, const unsigned y1, const unsigned) {
+            Impl::dense_band(src, dst, kernel, border, border_value, y0, y1);
+        });
+    return true;
+}
+
+}
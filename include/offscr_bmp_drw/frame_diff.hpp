@@ -0,0 +1,158 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "bitmap_image_generic.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+struct dirty_rect
+{
+    unsigned x, y, width, height;
+};
+
+/// compares two equally sized frames on a grid of tile_width x tile_height tiles
+/// and returns the changed area as few rectangles as possible:
+/// horizontal runs of dirty tiles are merged, then runs with identical extent
+/// in consecutive tile rows. rectangles are clipped to the image.
+/// row compares use memcmp() - vectorized in the C library and exits on the
+/// first difference. a tile is not compared anymore, once it is known to be dirty.
+/// frames of different size give a single rectangle covering cur_frame.
+/// num_threads: 0 = hardware concurrency; bands of tile rows are compared in parallel
+template <class BitmapImageType>
+inline std::vector<dirty_rect> dirty_rectangles(
+    const BitmapImageType& prev_frame,
+    const BitmapImageType& cur_frame,
+    const unsigned tile_width = 32,
+    const unsigned tile_height = 32,
+    const unsigned num_threads = 1
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    std::vector<dirty_rect> rects;
+    const unsigned w = cur_frame.width(), h = cur_frame.height();
+    if (!w || !h)
+        return rects;
+    if ( prev_frame.width() != w || prev_frame.height() != h || !tile_width || !tile_height )
+    {
+        rects.push_back(dirty_rect{ 0, 0, w, h });
+        return rects;
+    }
+
+    const unsigned tiles_x = (w + tile_width  - 1) / tile_width;
+    const unsigned tiles_y = (h + tile_height - 1) / tile_height;
+    std::vector<char> dirty(std::size_t(tiles_x) * tiles_y, 0);
+
+    parallel_for_bands(tiles_y, num_threads, [&](const unsigned ty0, const unsigned ty1, const unsigned) {
+        for (unsigned ty = ty0; ty < ty1; ++ty)
+        {
+            char* dirty_row = &dirty[std::size_t(ty) * tiles_x];
+            unsigned num_clean = tiles_x;
+            const unsigned y_end = std::min(h, (ty + 1) * tile_height);
+            for (unsigned y = ty * tile_height; y < y_end && num_clean; ++y)
+            {
+                const pixel_t* a = prev_frame.row(y);
+                const pixel_t* b = cur_frame.row(y);
+                if ( !std::memcmp(a, b, std::size_t(w) * sizeof(pixel_t)) )
+                    continue;
+                for (unsigned tx = 0; tx < tiles_x; ++tx)
+                {
+                    if (dirty_row[tx])
+                        continue;
+                    const unsigned x0 = tx * tile_width;
+                    const unsigned n = std::min(tile_width, w - x0);
+                    if ( std::memcmp(a + x0, b + x0, std::size_t(n) * sizeof(pixel_t)) )
+                    {
+                        dirty_row[tx] = 1;
+                        --num_clean;
+                    }
+                }
+            }
+        }
+    });
+
+    // merge: runs of tiles per tile row, extended downwards while the run below matches
+    std::vector<char> taken(dirty.size(), 0);
+    for (unsigned ty = 0; ty < tiles_y; ++ty)
+    {
+        for (unsigned tx = 0; tx < tiles_x; )
+        {
+            const std::size_t idx = std::size_t(ty) * tiles_x + tx;
+            if (!dirty[idx] || taken[idx])
+            {
+                ++tx;
+                continue;
+            }
+            unsigned tx_end = tx;
+            while (tx_end < tiles_x && dirty[idx + (tx_end - tx)] && !taken[idx + (tx_end - tx)])
+                ++tx_end;
+
+            unsigned ty_end = ty + 1;
+            for (; ty_end < tiles_y; ++ty_end)
+            {
+                const std::size_t row_idx = std::size_t(ty_end) * tiles_x;
+                bool same_run = (tx == 0 || !dirty[row_idx + tx - 1] || taken[row_idx + tx - 1])
+                             && (tx_end == tiles_x || !dirty[row_idx + tx_end] || taken[row_idx + tx_end]);
+                for (unsigned k = tx; k < tx_end && same_run; ++k)
+                    same_run = dirty[row_idx + k] && !taken[row_idx + k];
+                if (!same_run)
+                    break;
+            }
+            for (unsigned ry = ty; ry < ty_end; ++ry)
+                std::fill(&taken[std::size_t(ry) * tiles_x + tx], &taken[std::size_t(ry) * tiles_x + tx_end], char(1));
+
+            const unsigned x0 = tx * tile_width, y0 = ty * tile_height;
+            rects.push_back(dirty_rect{
+                x0, y0,
+                std::min(w, tx_end * tile_width ) - x0,
+                std::min(h, ty_end * tile_height) - y0 });
+            tx = tx_end;
+        }
+    }
+    return rects;
+}
+
+/// copies the rectangles from source into the equally sized dest - e.g. to keep the previous frame up to date
+template <class BitmapImageType>
+inline void copy_rectangles(
+    const BitmapImageType& source,
+    BitmapImageType& dest,
+    const std::vector<dirty_rect>& rects
+    )
+{
+    if ( source.width() != dest.width() || source.height() != dest.height() )
+        return;
+    for (const dirty_rect& r : rects)
+    {
+        for (unsigned y = r.y; y < r.y + r.height; ++y)
+            std::copy(source.row(y) + r.x, source.row(y) + r.x + r.width, dest.row(y) + r.x);
+    }
+}
+
+}
@@ -0,0 +1,355 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "bitmap_image_generic.hpp"
+#include "colors.hpp"
+#include "integral_image.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+/// one value per color component - in memory order of the pixel type,
+/// e.g. for bgr_t: [0] = blue, [1] = green, [2] = red. use pixel_t::offset() for lookup
+template <class BitmapImageType>
+using channel_values = std::array<double, pixel_traits<typename BitmapImageType::pixel_t>::num_components>;
+
+template <class BitmapImageType>
+inline double channel_average(const channel_values<BitmapImageType>& v)
+{
+    double s = 0;
+    for (const double c : v)
+        s += c;
+    return s / double(v.size());
+}
+
+template <class Float = double>
+inline Float psnr_from_mse(const Float mse, const Float peak = Float(255))
+{
+    if (mse <= Float(0.0000001))
+        return Float(1000000.0);
+    return Float(20) * std::log10(peak / std::sqrt(mse));
+}
+
+
+/// adds the squared differences of n interleaved components to acc[i % N]
+template <unsigned N, class ComponentType, class SumType>
+inline void accumulate_squared_differences(
+    const ComponentType* a, const ComponentType* b, const unsigned n, SumType* acc)
+{
+    for (unsigned i = 0; i < n; i += N)
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const SumType d = SumType(a[i + c]) - SumType(b[i + c]);
+            acc[c] += d * d;
+        }
+}
+
+/// 8-bit components: SSE2 integer path
+///   |a - b| with saturated subtractions, squares in 16 bit, sums in 32 bit lanes per
+///   byte position of a period of 16 pixels - flushed into the 64 bit channel sums
+template <unsigned N>
+inline void accumulate_squared_differences(
+    const unsigned char* a, const unsigned char* b, const unsigned n, uint64_t* acc)
+{
+    unsigned i = 0;
+#if defined(OFFSCR_BMP_DRW_HAVE_SSE2)
+    constexpr unsigned period = 16 * N;
+    constexpr unsigned max_periods = 65536;     // 65536 * 255^2 < 2^32
+    if (n >= period)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc32[4 * N];
+        unsigned periods = 0;
+
+        auto flush = [&]() {
+            alignas(16) uint32_t lanes[4];
+            for (unsigned j = 0; j < 4 * N; ++j)
+            {
+                _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc32[j]);
+                for (unsigned l = 0; l < 4; ++l)
+                    acc[(4 * j + l) % N] += lanes[l];
+                acc32[j] = zero;
+            }
+            periods = 0;
+        };
+
+        for (unsigned j = 0; j < 4 * N; ++j)
+            acc32[j] = zero;
+        for (; i + period <= n; i += period)
+        {
+            for (unsigned k = 0; k < N; ++k)
+            {
+                const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16 * k));
+                const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16 * k));
+                const __m128i d = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+                const __m128i dlo = _mm_unpacklo_epi8(d, zero);
+                const __m128i dhi = _mm_unpackhi_epi8(d, zero);
+                const __m128i slo = _mm_mullo_epi16(dlo, dlo);
+                const __m128i shi = _mm_mullo_epi16(dhi, dhi);
+                acc32[4 * k + 0] = _mm_add_epi32(acc32[4 * k + 0], _mm_unpacklo_epi16(slo, zero));
+                acc32[4 * k + 1] = _mm_add_epi32(acc32[4 * k + 1], _mm_unpackhi_epi16(slo, zero));
+                acc32[4 * k + 2] = _mm_add_epi32(acc32[4 * k + 2], _mm_unpacklo_epi16(shi, zero));
+                acc32[4 * k + 3] = _mm_add_epi32(acc32[4 * k + 3], _mm_unpackhi_epi16(shi, zero));
+            }
+            if (++periods == max_periods)
+                flush();
+        }
+        flush();
+    }
+#endif
+    for (; i < n; i += N)
+        for (unsigned c = 0; c < N; ++c)
+        {
+            const int d = int(a[i + c]) - int(b[i + c]);
+            acc[c] += uint64_t(d * d);
+        }
+}
+
+
+/// mean squared error per channel of region (width x height) at (x1, y1) in image1
+/// and at (x2, y2) in image2. rows are split into bands for num_threads (0 = hardware concurrency)
+/// returns all zeros for an invalid region
+template <class BitmapImageType>
+inline channel_values<BitmapImageType> mse_region(
+    const unsigned int width,
+    const unsigned int height,
+    const BitmapImageType& image1,
+    const unsigned int x1,
+    const unsigned int y1,
+    const BitmapImageType& image2,
+    const unsigned int x2,
+    const unsigned int y2,
+    const unsigned num_threads = 1
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using SumType = typename integral_sum_type<pixel_t>::type;
+    constexpr unsigned N = pixel_traits<pixel_t>::num_components;
+
+    channel_values<BitmapImageType> result;
+    result.fill(0.0);
+    if (!width || !height)
+        return result;
+    if ((x1 + width ) > image1.width() ) { return result; }
+    if ((y1 + height) > image1.height()) { return result; }
+    if ((x2 + width ) > image2.width() ) { return result; }
+    if ((y2 + height) > image2.height()) { return result; }
+
+    const unsigned n_bands = parallel_num_bands(height, num_threads);
+    std::vector< std::array<SumType, N> > band_sums(n_bands);
+    parallel_for_bands(height, num_threads, [&](const unsigned r0, const unsigned r1, const unsigned band) {
+        std::array<SumType, N> acc;
+        acc.fill(SumType(0));
+        for (unsigned r = r0; r < r1; ++r)
+            accumulate_squared_differences<N>(
+                cbegin(image1.row(r + y1)[x1]), cbegin(image2.row(r + y2)[x2]), width * N, acc.data());
+        band_sums[band] = acc;
+    });
+
+    const double n = double(width) * double(height);
+    for (unsigned c = 0; c < N; ++c)
+    {
+        SumType s = 0;
+        for (const std::array<SumType, N>& b : band_sums)
+            s += b[c];
+        result[c] = double(s) / n;
+    }
+    return result;
+}
+
+template <class BitmapImageType>
+inline channel_values<BitmapImageType> mse_per_channel(
+    const BitmapImageType& image1,
+    const BitmapImageType& image2,
+    const unsigned num_threads = 1
+    )
+{
+    if ( image1.width() != image2.width() || image1.height() != image2.height() )
+    {
+        channel_values<BitmapImageType> result;
+        result.fill(0.0);
+        return result;
+    }
+    return mse_region(image1.width(), image1.height(), image1, 0, 0, image2, 0, 0, num_threads);
+}
+
+/// peak: 255 for 8-bit components, 1 for normalized float images
+template <class BitmapImageType>
+inline channel_values<BitmapImageType> psnr_per_channel(
+    const BitmapImageType& image1,
+    const BitmapImageType& image2,
+    const unsigned num_threads = 1,
+    const double peak = 255.0
+    )
+{
+    channel_values<BitmapImageType> v = mse_per_channel(image1, image2, num_threads);
+    for (double & c : v)
+        c = psnr_from_mse(c, peak);
+    return v;
+}
+
+
+/// structural similarity index (Wang, Bovik, Sheikh, Simoncelli 2004) per channel,
+/// averaged over all valid positions of a window x window sliding window.
+/// window statistics (population variances) are updated incrementally:
+/// column sums move down one row, the window sums move right one column.
+/// dynamic_range: 255 for 8-bit components, 1 for normalized float images
+/// returns all zeros, if the images differ in size or are smaller than the window
+template <class BitmapImageType>
+inline channel_values<BitmapImageType> ssim_per_channel(
+    const BitmapImageType& image1,
+    const BitmapImageType& image2,
+    const unsigned window = 7,
+    const unsigned num_threads = 1,
+    const double dynamic_range = 255.0
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using component_t = typename pixel_traits<pixel_t>::component_t;
+    using SumType = typename integral_sum_type<pixel_t>::type;
+    constexpr unsigned N = pixel_traits<pixel_t>::num_components;
+
+    channel_values<BitmapImageType> result;
+    result.fill(0.0);
+    const unsigned w = image1.width(), h = image1.height();
+    if ( w != image2.width() || h != image2.height() || window < 2 || w < window || h < window )
+        return result;
+
+    const unsigned out_w = w - window + 1;
+    const unsigned out_h = h - window + 1;
+    const unsigned n = w * N;
+    const double C1 = (0.01 * dynamic_range) * (0.01 * dynamic_range);
+    const double C2 = (0.03 * dynamic_range) * (0.03 * dynamic_range);
+    const double inv_area = 1.0 / (double(window) * window);
+
+    const unsigned n_bands = parallel_num_bands(out_h, num_threads);
+    std::vector< std::array<double, N> > band_sums(n_bands);
+    parallel_for_bands(out_h, num_threads, [&](const unsigned oy0, const unsigned oy1, const unsigned band) {
+        // column sums of x, y, x^2, y^2, x*y
+        std::vector<SumType> cs(5 * std::size_t(n), SumType(0));
+        SumType* sx  = &cs[0];
+        SumType* sy  = &cs[n];
+        SumType* sxx = &cs[2 * n];
+        SumType* syy = &cs[3 * n];
+        SumType* sxy = &cs[4 * n];
+
+        auto add_row = [&](const unsigned y, const bool subtract) {
+            const component_t* a = cbegin(*image1.row(y));
+            const component_t* b = cbegin(*image2.row(y));
+            if (subtract)
+            {
+                for (unsigned i = 0; i < n; ++i)
+                {
+                    const SumType va = SumType(a[i]), vb = SumType(b[i]);
+                    sx[i] -= va; sy[i] -= vb;
+                    sxx[i] -= va * va; syy[i] -= vb * vb; sxy[i] -= va * vb;
+                }
+            }
+            else
+            {
+                for (unsigned i = 0; i < n; ++i)
+                {
+                    const SumType va = SumType(a[i]), vb = SumType(b[i]);
+                    sx[i] += va; sy[i] += vb;
+                    sxx[i] += va * va; syy[i] += vb * vb; sxy[i] += va * vb;
+                }
+            }
+        };
+
+        std::array<double, N> acc;
+        acc.fill(0.0);
+        for (unsigned y = oy0; y < oy0 + window - 1; ++y)
+            add_row(y, false);
+
+        for (unsigned oy = oy0; oy < oy1; ++oy)
+        {
+            add_row(oy + window - 1, false);
+            for (unsigned c = 0; c < N; ++c)
+            {
+                SumType wx = 0, wy = 0, wxx = 0, wyy = 0, wxy = 0;
+                for (unsigned k = 0; k < window; ++k)
+                {
+                    const unsigned i = k * N + c;
+                    wx += sx[i]; wy += sy[i]; wxx += sxx[i]; wyy += syy[i]; wxy += sxy[i];
+                }
+                double s = 0;
+                for (unsigned ox = 0; ; ++ox)
+                {
+                    const double mx = double(wx) * inv_area;
+                    const double my = double(wy) * inv_area;
+                    const double vx = double(wxx) * inv_area - mx * mx;
+                    const double vy = double(wyy) * inv_area - my * my;
+                    const double cxy = double(wxy) * inv_area - mx * my;
+                    s += ((2.0 * mx * my + C1) * (2.0 * cxy + C2))
+                       / ((mx * mx + my * my + C1) * (vx + vy + C2));
+                    if (ox + 1 == out_w)
+                        break;
+                    const unsigned i_out = ox * N + c;
+                    const unsigned i_in = (ox + window) * N + c;
+                    wx  += sx [i_in] - sx [i_out];
+                    wy  += sy [i_in] - sy [i_out];
+                    wxx += sxx[i_in] - sxx[i_out];
+                    wyy += syy[i_in] - syy[i_out];
+                    wxy += sxy[i_in] - sxy[i_out];
+                }
+                acc[c] += s;
+            }
+            add_row(oy, true);
+        }
+        band_sums[band] = acc;
+    });
+
+    const double n_windows = double(out_w) * double(out_h);
+    for (unsigned c = 0; c < N; ++c)
+    {
+        double s = 0;
+        for (const std::array<double, N>& b : band_sums)
+            s += b[c];
+        result[c] = s / n_windows;
+    }
+    return result;
+}
+
+/// mean SSIM over all channels
+template <class BitmapImageType>
+inline double ssim(
+    const BitmapImageType& image1,
+    const BitmapImageType& image2,
+    const unsigned window = 7,
+    const unsigned num_threads = 1,
+    const double dynamic_range = 255.0
+    )
+{
+    return channel_average<BitmapImageType>( ssim_per_channel(image1, image2, window, num_threads, dynamic_range) );
+}
+
+}
@@ -0,0 +1,260 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "bitmap_image_generic.hpp"
+#include "colors.hpp"
+#include "parallel.hpp"
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+// exact 64-bit integer sums for integral components, double for floating point
+template <class PixelType>
+struct integral_sum_type
+{
+    using type = typename std::conditional< pixel_traits<PixelType>::is_floating, double, uint64_t >::type;
+};
+
+
+/// summed-area table with Channels values per pixel
+/// entry (x, y) holds the sums over all pixels in [0 .. x) x [0 .. y)
+/// thus any rectangular region sum costs 4 lookups
+template <class SumType = double, unsigned Channels = 1>
+class summed_area_table
+{
+public:
+    using sum_t = SumType;
+
+    summed_area_table()
+        : width_(0), height_(0), data_()
+    {}
+
+    inline unsigned width() const  { return width_;  }
+    inline unsigned height() const { return height_; }
+
+    /// row_func(y, SumType* values) has to fill width * Channels values of row y
+    /// pass 1 (row bands): prefix sums inside each row
+    /// pass 2 (column bands): accumulation over the rows - contiguous per row
+    template <class RowFunc>
+    void build(const unsigned width, const unsigned height, RowFunc row_func, const unsigned num_threads = 1)
+    {
+        width_ = width;
+        height_ = height;
+        const unsigned stride = (width_ + 1) * Channels;
+        data_.assign(std::size_t(stride) * (height_ + 1), SumType(0));
+
+        parallel_for_bands(height_, num_threads, [&](const unsigned y0, const unsigned y1, const unsigned) {
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                SumType* row = entry(0, y + 1);
+                row_func(y, row + Channels);
+                for (unsigned i = Channels; i < stride; ++i)
+                    row[i] += row[i - Channels];
+            }
+        });
+
+        parallel_for_bands(stride, num_threads, [&](const unsigned i0, const unsigned i1, const unsigned) {
+            for (unsigned y = 2; y <= height_; ++y)
+            {
+                SumType* row = entry(0, y);
+                const SumType* prev = entry(0, y - 1);
+                for (unsigned i = i0; i < i1; ++i)
+                    row[i] += prev[i];
+            }
+        });
+    }
+
+    /// sum of channel c over region [x0 .. x0 + w) x [y0 .. y0 + h)
+    inline SumType sum(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h, const unsigned c = 0) const
+    {
+        const unsigned x1 = x0 + w, y1 = y0 + h;
+        return entry(x1, y1)[c] + entry(x0, y0)[c] - entry(x1, y0)[c] - entry(x0, y1)[c];
+    }
+
+    inline bool is_valid_region(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h) const
+    {
+        return (x0 + w <= width_) && (y0 + h <= height_);
+    }
+
+private:
+    inline SumType* entry(const unsigned x, const unsigned y)
+    {
+        return &data_[ (std::size_t(y) * (width_ + 1) + x) * Channels ];
+    }
+
+    inline const SumType* entry(const unsigned x, const unsigned y) const
+    {
+        return &data_[ (std::size_t(y) * (width_ + 1) + x) * Channels ];
+    }
+
+    unsigned width_;
+    unsigned height_;
+    std::vector<SumType> data_;
+};
+
+
+/// integral image of a bitmap_image_generic<> (or derived) with the sum and sum of squares
+/// of each color component - for O(1) region sum / mean / variance
+/// memory: 2 * components * sizeof(SumType) per pixel
+template <class BitmapImageType, class SumType = typename integral_sum_type<typename BitmapImageType::pixel_t>::type >
+class integral_image
+{
+public:
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using component_t = typename pixel_traits<pixel_t>::component_t;
+    using sum_t = SumType;
+    static constexpr unsigned N = pixel_traits<pixel_t>::num_components;
+
+    integral_image() = default;
+
+    explicit integral_image(const BitmapImageType& image, const unsigned num_threads = 1)
+    {
+        build(image, num_threads);
+    }
+
+    void build(const BitmapImageType& image, const unsigned num_threads = 1)
+    {
+        const unsigned w = image.width();
+        table_.build(w, image.height(), [&](const unsigned y, SumType* values) {
+            const component_t* comps = cbegin(*image.row(y));
+            for (unsigned x = 0; x < w; ++x, comps += N, values += 2 * N)
+            {
+                for (unsigned c = 0; c < N; ++c)
+                {
+                    const SumType v = SumType(comps[c]);
+                    values[c]     = v;
+                    values[N + c] = v * v;
+                }
+            }
+        }, num_threads);
+    }
+
+    inline unsigned width() const  { return table_.width();  }
+    inline unsigned height() const { return table_.height(); }
+
+    inline bool is_valid_region(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h) const
+    {
+        return table_.is_valid_region(x0, y0, w, h);
+    }
+
+    inline SumType sum(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h, const unsigned c = 0) const
+    {
+        return table_.sum(x0, y0, w, h, c);
+    }
+
+    inline SumType sum_sq(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h, const unsigned c = 0) const
+    {
+        return table_.sum(x0, y0, w, h, N + c);
+    }
+
+    template <class Float = double>
+    inline Float mean(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h, const unsigned c = 0) const
+    {
+        return Float(sum(x0, y0, w, h, c)) / Float(double(w) * h);
+    }
+
+    /// population variance
+    template <class Float = double>
+    inline Float variance(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h, const unsigned c = 0) const
+    {
+        const Float n = Float(double(w) * h);
+        const Float m = Float(sum(x0, y0, w, h, c)) / n;
+        const Float v = Float(sum_sq(x0, y0, w, h, c)) / n - m * m;
+        return (v > Float(0)) ? v : Float(0);
+    }
+
+private:
+    summed_area_table<SumType, 2 * N> table_;
+};
+
+
+/// summed-area table of the squared component differences (summed over all components)
+/// between two equally sized images: O(1) mean squared error of any region
+template <class BitmapImageType, class SumType = typename integral_sum_type<typename BitmapImageType::pixel_t>::type >
+class squared_difference_table
+{
+public:
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using component_t = typename pixel_traits<pixel_t>::component_t;
+    using sum_t = SumType;
+    static constexpr unsigned N = pixel_traits<pixel_t>::num_components;
+
+    squared_difference_table() = default;
+
+    squared_difference_table(const BitmapImageType& image1, const BitmapImageType& image2, const unsigned num_threads = 1)
+    {
+        build(image1, image2, num_threads);
+    }
+
+    bool build(const BitmapImageType& image1, const BitmapImageType& image2, const unsigned num_threads = 1)
+    {
+        if ( image1.width() != image2.width() || image1.height() != image2.height() )
+            return false;
+        const unsigned w = image1.width();
+        table_.build(w, image1.height(), [&](const unsigned y, SumType* values) {
+            const component_t* itr1 = cbegin(*image1.row(y));
+            const component_t* itr2 = cbegin(*image2.row(y));
+            for (unsigned x = 0; x < w; ++x, itr1 += N, itr2 += N)
+            {
+                SumType s = 0;
+                for (unsigned c = 0; c < N; ++c)
+                {
+                    const SumType d = (itr1[c] > itr2[c]) ? SumType(itr1[c] - itr2[c]) : SumType(itr2[c] - itr1[c]);
+                    s += d * d;
+                }
+                values[x] = s;
+            }
+        }, num_threads);
+        return true;
+    }
+
+    inline unsigned width() const  { return table_.width();  }
+    inline unsigned height() const { return table_.height(); }
+
+    inline bool is_valid_region(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h) const
+    {
+        return table_.is_valid_region(x0, y0, w, h);
+    }
+
+    inline SumType sum(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h) const
+    {
+        return table_.sum(x0, y0, w, h, 0);
+    }
+
+    /// mean over pixels and components
+    template <class Float = double>
+    inline Float mse(const unsigned x0, const unsigned y0, const unsigned w, const unsigned h) const
+    {
+        return Float(sum(x0, y0, w, h)) / (Float(N) * Float(double(w) * h));
+    }
+
+private:
+    summed_area_table<SumType, 1> table_;
+};
+
+}
@@ -21,6 +21,8 @@
 #pragma once
 
 #include "bitmap_image_rgb.hpp"
+#include "image_metrics.hpp"
+#include "integral_image.hpp"
 
 
 namespace OffScreenBitmapDraw
@@ -35,72 +37,77 @@ inline Float psnr_region(
     const unsigned int& y1,
     const BitmapImageType& image2,
     const unsigned int& x2,
-    const unsigned int& y2
+    const unsigned int& y2,
+    const unsigned num_threads = 1
     )
 {
+    if (!width || !height) { return Float(0); }
     if ((x1 + width ) > image1.width() ) { return Float(0); }
     if ((y1 + height) > image1.height()) { return Float(0); }
     if ((x2 + width ) > image2.width() ) { return Float(0); }
     if ((y2 + height) > image2.height()) { return Float(0); }
 
-    Float mse = 0;
-    for (unsigned int r = 0; r < height; ++r)
-    {
-        const typename BitmapImageType::component_t * itr1     = cbegin(image1.row(r + y1)[x1]);
-        const typename BitmapImageType::component_t * itr1_end = cend(image1.row(r + y1)[x1 +width -1]);
-        const typename BitmapImageType::component_t * itr2     = cbegin(image2.row(r + y2)[x2]);
-        while (itr1 != itr1_end)
-        {
-            Float v = (static_cast<Float>(*itr1) - static_cast<Float>(*itr2));
-            mse += v * v;
-            ++itr1;
-            ++itr2;
-        }
-    }
-    if (mse <= Float(0.0000001))
-        return Float(1000000.0);
-    else
-    {
-        mse /= (Float(3) * width * height);
-        return Float(20) * std::log10(Float(255) / std::sqrt(mse));
-    }
+    const channel_values<BitmapImageType> mse = mse_region(width, height, image1, x1, y1, image2, x2, y2, num_threads);
+    return psnr_from_mse<Float>( Float(channel_average<BitmapImageType>(mse)) );
 }
 
 template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
 inline Float psnr(
     const BitmapImageType& image1,
-    const BitmapImageType& image2
+    const BitmapImageType& image2,
+    const unsigned num_threads = 1
     )
 {
     return psnr_region<BitmapImageType, Float>(
         image1.width(), image1.height(),
         image1, 0, 0,
-        image2, 0, 0
+        image2, 0, 0,
+        num_threads
         );
 }
 
+// whole image1 against the equally sized region of image2 at (x, y)
 template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
 inline Float psnr(
     const unsigned int& x,
     const unsigned int& y,
     const BitmapImageType& image1,
-    const BitmapImageType& image2
+    const BitmapImageType& image2,
+    const unsigned num_threads = 1
     )
 {
     return psnr_region<BitmapImageType, Float>(
-        x, y, image1.width(), image1.height(),
-        image1, image2
+        image1.width(), image1.height(),
+        image1, 0, 0,
+        image2, x, y,
+        num_threads
         );
 }
 
 
+// O(1) per region - after building the table in one pass
+template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
+inline Float psnr_region(
+    const squared_difference_table<BitmapImageType>& sqd_table,
+    const unsigned int& x,
+    const unsigned int& y,
+    const unsigned int& width,
+    const unsigned int& height
+    )
+{
+    if (!width || !height || !sqd_table.is_valid_region(x, y, width, height))
+        return Float(0);
+    return psnr_from_mse<Float>( sqd_table.template mse<Float>(x, y, width, height) );
+}
+
+
 template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
 inline void hierarchical_psnr_r(
     const Float& x,
     const Float& y,
     const Float& width,
     const Float& height,
-    const BitmapImageType& image1,
+    const squared_difference_table<BitmapImageType>& sqd_table,
     BitmapImageType& image2,
     const Float& threshold,
     const rgb_t colormap[]
@@ -108,22 +115,22 @@ inline void hierarchical_psnr_r(
 {
     if ( width <= Float(4) || height <= Float(4) )
     {
-        const Float psnr = psnr_region(
-            static_cast<unsigned int>(x),
-            static_cast<unsigned int>(y),
-            static_cast<unsigned int>(width),
-            static_cast<unsigned int>(height),
-            image1, image2
-            );
+        const unsigned int ux = static_cast<unsigned int>(x);
+        const unsigned int uy = static_cast<unsigned int>(y);
+        const unsigned int uw = static_cast<unsigned int>(width);
+        const unsigned int uh = static_cast<unsigned int>(height);
+        const Float psnr = psnr_region<BitmapImageType, Float>(sqd_table, ux, uy, uw, uh);
         if (psnr < threshold)
         {
-            rgb_t c = colormap[static_cast<unsigned int>(Float(1000) * (Float(1) - (psnr / threshold)))];
+            const unsigned int cidx = static_cast<unsigned int>(Float(1000) * (Float(1) - (psnr / threshold)));
+            const rgb_t c = colormap[ std::min(cidx, 999U) ];
+            typename BitmapImageType::pixel_t color;
+            set_rgb(color, c.red, c.green, c.blue);
             image2.set_region(
-                static_cast<unsigned int>(x),
-                static_cast<unsigned int>(y),
-                static_cast<unsigned int>(width + 1),
-                static_cast<unsigned int>(height + 1),
-                c.red, c.green, c.blue
+                ux, uy,
+                std::min(uw + 1, image2.width()  - ux),
+                std::min(uh + 1, image2.height() - uy),
+                color
                 );
         }
     }
@@ -131,13 +138,31 @@ inline void hierarchical_psnr_r(
     {
         const Float half_width  =  width / Float(2);
         const Float half_height = height / Float(2);
-        hierarchical_psnr_r(x             , y              , half_width, half_height, image1, image2, threshold, colormap);
-        hierarchical_psnr_r(x + half_width, y              , half_width, half_height, image1, image2, threshold, colormap);
-        hierarchical_psnr_r(x + half_width, y + half_height, half_width, half_height, image1, image2, threshold, colormap);
-        hierarchical_psnr_r(x             , y + half_height, half_width, half_height, image1, image2, threshold, colormap);
+        hierarchical_psnr_r(x             , y              , half_width, half_height, sqd_table, image2, threshold, colormap);
+        hierarchical_psnr_r(x + half_width, y              , half_width, half_height, sqd_table, image2, threshold, colormap);
+        hierarchical_psnr_r(x + half_width, y + half_height, half_width, half_height, sqd_table, image2, threshold, colormap);
+        hierarchical_psnr_r(x             , y + half_height, half_width, half_height, sqd_table, image2, threshold, colormap);
     }
 }
 
+template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
+inline void hierarchical_psnr_r(
+    const Float& x,
+    const Float& y,
+    const Float& width,
+    const Float& height,
+    const BitmapImageType& image1,
+    BitmapImageType& image2,
+    const Float& threshold,
+    const rgb_t colormap[]
+    )
+{
+    const squared_difference_table<BitmapImageType> sqd_table(image1, image2);
+    hierarchical_psnr_r(x, y, width, height, sqd_table, image2, threshold, colormap);
+}
+
+// the squared differences are summed up only once - not per recursion level
+// image2 gets painted with colormap where the psnr is below threshold
 template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
 inline void hierarchical_psnr(
     const BitmapImageType& image1,
@@ -149,16 +174,16 @@ inline void hierarchical_psnr(
     if ( image1.width()  != image2.width () || image1.height() != image2.height() )
         return;
 
-    const Float psnr = psnr_region(
-        0, 0, image1.width(), image1.height(),
-        image1, image2
+    const squared_difference_table<BitmapImageType> sqd_table(image1, image2);
+    const Float psnr = psnr_region<BitmapImageType, Float>(
+        sqd_table, 0, 0, image1.width(), image1.height()
         );
 
     if (psnr < threshold)
     {
-        hierarchical_psnr_r(
+        hierarchical_psnr_r<BitmapImageType, Float>(
             0, 0, image1.width(), image1.height(),
-            image1, image2,
+            sqd_table, image2,
             threshold,
             colormap
             );
@@ -0,0 +1,308 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "colors.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+/// nearest color lookup in a fixed palette - same metric as find_nearest_color()
+/// (euclidean in RGB), ties resolved to the lowest index.
+/// a k-d tree over the palette colors answers queries in logarithmic time.
+/// the optional RGB555 cache holds for each of the 32768 cells of 8x8x8 colors the
+/// few palette entries, which can be nearest to any color in the cell:
+/// queries then scan only these candidates - still exact, in near constant time
+template <class RGBColorType = rgb_t>
+class palette_index
+{
+public:
+    static constexpr unsigned cache_size = 32768;
+
+    palette_index() = default;
+
+    palette_index(const RGBColorType* colors, const std::size_t num_colors, const bool with_cache = true)
+    {
+        assign(colors, num_colors, with_cache);
+    }
+
+    template <std::size_t N>
+    explicit palette_index(const RGBColorType (&colors)[N], const bool with_cache = true)
+    {
+        assign(colors, N, with_cache);
+    }
+
+    void assign(const RGBColorType* colors, const std::size_t num_colors, const bool with_cache = true)
+    {
+        colors_.assign(colors, colors + num_colors);
+        nodes_.clear();
+        cache_offsets_.clear();
+        candidates_.clear();
+        std::vector<unsigned> idx(num_colors);
+        for (std::size_t k = 0; k < num_colors; ++k)
+            idx[k] = unsigned(k);
+        nodes_.reserve(num_colors);
+        root_ = build(idx, 0, num_colors);
+
+        if (with_cache && !colors_.empty())
+            build_cache();
+    }
+
+    inline std::size_t size() const { return colors_.size(); }
+    inline bool empty() const { return colors_.empty(); }
+    inline bool has_cache() const { return !cache_offsets_.empty(); }
+    inline const RGBColorType& color(const unsigned index) const { return colors_[index]; }
+
+    /// nearest palette index. palette must not be empty
+    unsigned nearest_index(const int r, const int g, const int b) const
+    {
+        if (!cache_offsets_.empty())
+        {
+            const unsigned cell = ((unsigned(r) >> 3) << 10) | ((unsigned(g) >> 3) << 5) | (unsigned(b) >> 3);
+            const unsigned* itr = &candidates_[ cache_offsets_[cell] ];
+            const unsigned* itr_end = &candidates_[0] + cache_offsets_[cell + 1];
+            unsigned best_index = *itr;
+            int best_d = distance(*itr, r, g, b);
+            for (++itr; itr != itr_end; ++itr)
+            {
+                const int d = distance(*itr, r, g, b);
+                if (d < best_d)     // candidates are sorted by index: first minimum wins
+                {
+                    best_d = d;
+                    best_index = *itr;
+                }
+            }
+            return best_index;
+        }
+        return nearest_index_tree(r, g, b);
+    }
+
+    template <class PixelType>
+    inline unsigned nearest_index(const PixelType& c) const
+    {
+        return nearest_index(*red(c), *green(c), *blue(c));
+    }
+
+    template <class PixelType>
+    inline const RGBColorType& nearest_color(const PixelType& c) const
+    {
+        return colors_[ nearest_index(c) ];
+    }
+
+private:
+    struct node
+    {
+        int c[3];
+        unsigned index;
+        int axis;
+        int left;
+        int right;
+    };
+
+    inline int distance(const unsigned index, const int r, const int g, const int b) const
+    {
+        const RGBColorType& c = colors_[index];
+        const int dr = r - *red(c), dg = g - *green(c), db = b - *blue(c);
+        return dr * dr + dg * dg + db * db;
+    }
+
+    unsigned nearest_index_tree(const int r, const int g, const int b) const
+    {
+        const int q[3] = { r, g, b };
+        unsigned best_index = std::numeric_limits<unsigned>::max();
+        int best_d = std::numeric_limits<int>::max();
+        search(root_, q, best_index, best_d);
+        return best_index;
+    }
+
+    // candidates of a cell: within distance (nearest to cell center + 2 * half diagonal) of its center.
+    // the nearest color of any color p in the cell is within that distance, because
+    // |center - nearest(p)| <= |center - p| + |p - nearest(center)| <= 2 * half diagonal + |center - nearest(center)|
+    void build_cache()
+    {
+        const double half_diagonal = 3.5 * std::sqrt(3.0);
+        cache_offsets_.resize(cache_size + 1);
+        candidates_.clear();
+        std::vector<unsigned> found;
+        for (unsigned k = 0; k < cache_size; ++k)
+        {
+            cache_offsets_[k] = unsigned(candidates_.size());
+            const double q[3] = { (k >> 10) * 8 + 3.5, ((k >> 5) & 31) * 8 + 3.5, (k & 31) * 8 + 3.5 };
+            const unsigned nearest = nearest_index_tree(int(q[0]), int(q[1]), int(q[2]));
+            double dn = 0;
+            for (int a = 0; a < 3; ++a)
+                dn += (q[a] - component(nearest, a)) * (q[a] - component(nearest, a));
+            const double radius = std::sqrt(dn) + 2.0 * half_diagonal + 0.001;
+            found.clear();
+            collect(root_, q, radius * radius, found);
+            std::sort(found.begin(), found.end());
+            candidates_.insert(candidates_.end(), found.begin(), found.end());
+        }
+        cache_offsets_[cache_size] = unsigned(candidates_.size());
+    }
+
+    void collect(const int n, const double q[3], const double radius2, std::vector<unsigned>& found) const
+    {
+        if (n < 0)
+            return;
+        const node& nd = nodes_[n];
+        double d = 0;
+        for (int a = 0; a < 3; ++a)
+            d += (q[a] - nd.c[a]) * (q[a] - nd.c[a]);
+        if (d <= radius2)
+            found.push_back(nd.index);
+        const double diff = q[nd.axis] - nd.c[nd.axis];
+        collect(diff < 0 ? nd.left : nd.right, q, radius2, found);
+        if (diff * diff <= radius2)
+            collect(diff < 0 ? nd.right : nd.left, q, radius2, found);
+    }
+
+    inline int component(const unsigned index, const int axis) const
+    {
+        const RGBColorType& c = colors_[index];
+        return (axis == 0) ? *red(c) : (axis == 1) ? *green(c) : *blue(c);
+    }
+
+    // balanced tree: median split on the axis with the widest extent
+    int build(std::vector<unsigned>& idx, const std::size_t b, const std::size_t e)
+    {
+        if (b >= e)
+            return -1;
+        int lo[3] = { 255, 255, 255 }, hi[3] = { 0, 0, 0 };
+        for (std::size_t k = b; k < e; ++k)
+            for (int a = 0; a < 3; ++a)
+            {
+                lo[a] = std::min(lo[a], component(idx[k], a));
+                hi[a] = std::max(hi[a], component(idx[k], a));
+            }
+        int axis = 0;
+        for (int a = 1; a < 3; ++a)
+            if (hi[a] - lo[a] > hi[axis] - lo[axis])
+                axis = a;
+
+        const std::size_t m = (b + e) / 2;
+        std::nth_element(idx.begin() + b, idx.begin() + m, idx.begin() + e,
+            [&](const unsigned i, const unsigned j) {
+                const int ci = component(i, axis), cj = component(j, axis);
+                return (ci < cj) || (ci == cj && i < j);
+            });
+
+        const int n = int(nodes_.size());
+        nodes_.push_back(node{ { component(idx[m], 0), component(idx[m], 1), component(idx[m], 2) }, idx[m], axis, -1, -1 });
+        const int left = build(idx, b, m);
+        const int right = build(idx, m + 1, e);
+        nodes_[n].left = left;
+        nodes_[n].right = right;
+        return n;
+    }
+
+    void search(const int n, const int q[3], unsigned& best_index, int& best_d) const
+    {
+        if (n < 0)
+            return;
+        const node& nd = nodes_[n];
+        const int dr = q[0] - nd.c[0], dg = q[1] - nd.c[1], db = q[2] - nd.c[2];
+        const int d = dr * dr + dg * dg + db * db;
+        if (d < best_d || (d == best_d && nd.index < best_index))
+        {
+            best_d = d;
+            best_index = nd.index;
+        }
+        const int diff = q[nd.axis] - nd.c[nd.axis];
+        search(diff < 0 ? nd.left : nd.right, q, best_index, best_d);
+        if (diff * diff <= best_d)     // equal: a lower index on the far side may tie
+            search(diff < 0 ? nd.right : nd.left, q, best_index, best_d);
+    }
+
+    std::vector<RGBColorType> colors_;
+    std::vector<node> nodes_;
+    std::vector<unsigned> cache_offsets_;   // cache_size + 1 offsets into candidates_
+    std::vector<unsigned> candidates_;
+    int root_ = -1;
+};
+
+
+/// replaces each pixel with its nearest palette color - bands of rows on num_threads (0 = hardware concurrency)
+template <class BitmapImageType, class RGBColorType>
+inline bool remap_to_palette(
+    BitmapImageType& image,
+    const palette_index<RGBColorType>& palette,
+    const unsigned num_threads = 1
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    if (palette.empty())
+        return false;
+    parallel_for_bands(image.height(), num_threads, [&](const unsigned y0, const unsigned y1, const unsigned) {
+        for (unsigned y = y0; y < y1; ++y)
+        {
+            pixel_t* row = image.row(y);
+            for (unsigned x = 0; x < image.width(); ++x)
+            {
+                const RGBColorType& c = palette.nearest_color(row[x]);
+                set_rgb(row[x], *red(c), *green(c), *blue(c));
+            }
+        }
+    });
+    return true;
+}
+
+/// writes the nearest palette index of each pixel into index_image (e.g. bitmap_image_generic<unsigned char>),
+/// resized to the size of image. the index type must hold palette.size() - 1
+template <class BitmapImageType, class RGBColorType, class IndexImageType>
+inline bool remap_to_palette(
+    const BitmapImageType& image,
+    const palette_index<RGBColorType>& palette,
+    IndexImageType& index_image,
+    const unsigned num_threads = 1
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using index_t = typename IndexImageType::pixel_t;
+    if ( palette.empty() || palette.size() - 1 > std::size_t(std::numeric_limits<index_t>::max()) )
+        return false;
+    if ( index_image.width() != image.width() || index_image.height() != image.height() )
+    {
+        if (!index_image.setwidth_height(image.width(), image.height()))
+            return false;
+    }
+    parallel_for_bands(image.height(), num_threads, [&](const unsigned y0, const unsigned y1, const unsigned) {
+        for (unsigned y = y0; y < y1; ++y)
+        {
+            const pixel_t* row = image.row(y);
+            index_t* dest = index_image.row(y);
+            for (unsigned x = 0; x < image.width(); ++x)
+                dest[x] = index_t( palette.nearest_index(row[x]) );
+        }
+    });
+    return true;
+}
+
+}
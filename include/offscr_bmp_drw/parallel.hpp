@@ -0,0 +1,94 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+// num_threads == 0: use std::thread::hardware_concurrency()
+// never more bands than items; at least 1 band
+inline unsigned parallel_num_bands(const unsigned n_items, const unsigned num_threads)
+{
+    unsigned n = num_threads;
+    if (!n)
+        n = std::max(1U, std::thread::hardware_concurrency());
+    return std::max(1U, std::min(n, n_items));
+}
+
+// splits [0 .. n_items) into contiguous bands and calls func(begin, end, band_index)
+// for each band - on separate threads when there's more than 1 band.
+// the calling thread processes the last band itself.
+// num_threads == 1 calls func(0, n_items, 0) directly without any thread overhead
+template <class BandFunc>
+inline void parallel_for_bands(const unsigned n_items, const unsigned num_threads, BandFunc func)
+{
+    if (!n_items)
+        return;
+    const unsigned n_bands = parallel_num_bands(n_items, num_threads);
+    if (n_bands == 1)
+    {
+        func(0U, n_items, 0U);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(n_bands - 1);
+    for (unsigned b = 0; b < n_bands - 1; ++b)
+    {
+        const unsigned begin = unsigned( (std::size_t(n_items) * b) / n_bands );
+        const unsigned end   = unsigned( (std::size_t(n_items) * (b + 1)) / n_bands );
+        threads.emplace_back(func, begin, end, b);
+    }
+    func(unsigned( (std::size_t(n_items) * (n_bands - 1)) / n_bands ), n_items, n_bands - 1);
+    for (std::thread & t : threads)
+        t.join();
+}
+
+// calls func(item, worker_index) for each item in [0 .. n_items).
+// workers fetch the next item from a shared counter - for items of uneven cost,
+// e.g. image tiles of a fractal, where fixed bands would leave threads idle.
+// num_threads == 1 processes all items in order on the calling thread
+template <class ItemFunc>
+inline void parallel_for_dynamic(const unsigned n_items, const unsigned num_threads, ItemFunc func)
+{
+    const unsigned n_workers = parallel_num_bands(n_items, num_threads);
+    if (n_workers <= 1)
+    {
+        for (unsigned i = 0; i < n_items; ++i)
+            func(i, 0U);
+        return;
+    }
+
+    std::atomic<unsigned> next_item(0);
+    parallel_for_bands(n_workers, n_workers, [&](const unsigned, const unsigned, const unsigned worker) {
+        for (unsigned i = next_item++; i < n_items; i = next_item++)
+            func(i, worker);
+    });
+}
+
+}
@@ -0,0 +1,261 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "bitmap_image_generic.hpp"
+#include "zingl_image_drawer.hpp"
+
+#include <algorithm>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+/// a repeating tile of tile_width x tile_height pixels.
+/// every tile row is stored as template row, repeated up to a length of
+/// tile_width + max_span, so that a span of up to max_span pixels starting at
+/// any x is a single contiguous copy - without per pixel modulo or branches.
+template <class PixelType>
+class pixel_pattern
+{
+public:
+    typedef PixelType pixel_t;
+
+    /// tile filled with background
+    pixel_pattern(const unsigned tile_width, const unsigned tile_height, const pixel_t background = pixel_t())
+        : tile_width_(std::max(1U, tile_width))
+        , tile_height_(std::max(1U, tile_height))
+        , max_span_(0)
+        , row_length_(tile_width_)
+        , rows_(std::size_t(tile_width_) * tile_height_, background)
+    { }
+
+    /// arbitrary repeating tile, e.g. loaded from a bitmap
+    template <class BitmapImageType>
+    explicit pixel_pattern(const BitmapImageType& tile)
+        : pixel_pattern(tile.width(), tile.height())
+    {
+        for (unsigned y = 0; y < tile_height_ && y < tile.height(); ++y)
+            std::copy(tile.row(y), tile.row(y) + std::min(tile_width_, tile.width()), &rows_[std::size_t(y) * row_length_]);
+    }
+
+    /// squares of cell_width x cell_height, starting with color0 at the top left
+    static pixel_pattern checkered(const unsigned cell_width, const unsigned cell_height,
+                                   const pixel_t color0, const pixel_t color1)
+    {
+        pixel_pattern p(2 * cell_width, 2 * cell_height, color0);
+        const unsigned cw = p.tile_width_ / 2, ch = p.tile_height_ / 2;
+        for (unsigned y = 0; y < p.tile_height_; ++y)
+            p.fill_tile_row(y, (y < ch) ? cw : 0, cw, color1);
+        return p;
+    }
+
+    /// stripes of width0 pixels color0 followed by width1 pixels color1;
+    /// vertical stripes repeat along x, horizontal stripes along y
+    static pixel_pattern stripes(const unsigned width0, const unsigned width1,
+                                 const pixel_t color0, const pixel_t color1, const bool vertical = true)
+    {
+        const unsigned period = std::max(1U, width0 + width1);
+        pixel_pattern p(vertical ? period : 1U, vertical ? 1U : period, color0);
+        if (vertical)
+            p.fill_tile_row(0, width0, width1, color1);
+        else
+            for (unsigned y = width0; y < period; ++y)
+                p.fill_tile_row(y, 0, 1, color1);
+        return p;
+    }
+
+    /// grid of lines of line_width pixels every cell_width / cell_height pixels
+    static pixel_pattern grid(const unsigned cell_width, const unsigned cell_height, const unsigned line_width,
+                              const pixel_t line_color, const pixel_t background)
+    {
+        pixel_pattern p(cell_width, cell_height, background);
+        for (unsigned y = 0; y < p.tile_height_; ++y)
+            p.fill_tile_row(y, 0, (y < line_width) ? p.tile_width_ : line_width, line_color);
+        return p;
+    }
+
+    /// diagonal hatching: lines of line_width pixels every spacing pixels,
+    /// rising from bottom left to top right - or falling, when rising is false
+    static pixel_pattern hatch(const unsigned spacing, const unsigned line_width,
+                               const pixel_t line_color, const pixel_t background, const bool rising = true)
+    {
+        pixel_pattern p(spacing, spacing, background);
+        const unsigned s = p.tile_width_;
+        for (unsigned y = 0; y < s; ++y)
+        {
+            const unsigned x0 = rising ? (s - y % s) % s : y;
+            p.fill_tile_row(y, x0, std::min(line_width, s - x0), line_color);
+            if (line_width > s - x0)
+                p.fill_tile_row(y, 0, std::min(line_width - (s - x0), s), line_color);
+        }
+        return p;
+    }
+
+    unsigned tile_width()  const { return tile_width_; }
+    unsigned tile_height() const { return tile_height_; }
+    unsigned max_span()    const { return max_span_ + 1; }
+
+    /// tile pixel at image position (x, y)
+    const pixel_t& at(const unsigned x, const unsigned y) const
+    {
+        return rows_[std::size_t(y % tile_height_) * row_length_ + x % tile_width_];
+    }
+
+    /// pointer to the pattern at image position (x, y); valid for max_span() pixels
+    const pixel_t* span(const unsigned x, const unsigned y) const
+    {
+        return &rows_[std::size_t(y % tile_height_) * row_length_ + x % tile_width_];
+    }
+
+    /// extends the template rows, so span() covers at least n pixels.
+    /// called by pattern_fill() with the image width
+    void reserve_span(const unsigned n)
+    {
+        if (n <= max_span())
+            return;
+        const unsigned new_length = tile_width_ + n - 1;
+        std::vector<pixel_t> rows(std::size_t(new_length) * tile_height_);
+        for (unsigned y = 0; y < tile_height_; ++y)
+        {
+            const pixel_t* src = &rows_[std::size_t(y) * row_length_];
+            pixel_t* dest = &rows[std::size_t(y) * new_length];
+            for (unsigned x = 0; x < new_length; x += tile_width_)
+                std::copy(src, src + std::min(tile_width_, new_length - x), dest + x);
+        }
+        rows_.swap(rows);
+        row_length_ = new_length;
+        max_span_ = n - 1;
+    }
+
+private:
+    // only before reserve_span()
+    void fill_tile_row(const unsigned y, const unsigned x0, const unsigned n, const pixel_t color)
+    {
+        pixel_t* row = &rows_[std::size_t(y) * row_length_];
+        std::fill(row + std::min(x0, tile_width_), row + std::min(x0 + n, tile_width_), color);
+    }
+
+    unsigned tile_width_;
+    unsigned tile_height_;
+    unsigned max_span_;     // row_length_ == tile_width_ + max_span_
+    unsigned row_length_;
+    std::vector<pixel_t> rows_;
+};
+
+/// fills the whole image (or Slice) with the pattern. the tile is anchored at
+/// image position (-x_origin, -y_origin) - pattern pixel (x_origin, y_origin) is at (0, 0).
+/// each row is one contiguous copy from the template row
+template <class BitmapImageType>
+inline void pattern_fill(
+    BitmapImageType& image,
+    pixel_pattern<typename BitmapImageType::pixel_t>& pattern,
+    const unsigned x_origin = 0,
+    const unsigned y_origin = 0
+    )
+{
+    const unsigned w = image.width(), h = image.height();
+    pattern.reserve_span(w);
+    for (unsigned y = 0; y < h; ++y)
+    {
+        const typename BitmapImageType::pixel_t* src = pattern.span(x_origin, y + y_origin);
+        std::copy(src, src + w, image.row(y));
+    }
+}
+
+/// Setter policy for zingl_image_drawer: draws with the pattern of the drawer instead of
+/// the color - anchored at the image origin. clipped like PixelSetterClippedUsingXY.
+/// hLine() copies the span from the template row - in pieces of max_span() pixels, when
+/// the pattern wasn't reserved for the image width. coverage() blends the pattern, as
+/// PixelBlenderClippedUsingXY the color. without pattern the color is drawn:
+///     pattern.reserve_span(image.width());
+///     zingl_image_drawer<BitmapRGBImage> drawer(image, &pattern);
+///     drawer.fillCircle< pattern_setter<BitmapRGBImage> >(x, y, r, color_is_ignored);
+template <class BitmapImageType>
+struct pattern_setter
+{
+    typedef typename BitmapImageType::pixel_t pixel_t;
+    // the setter context of zingl_image_drawer
+    typedef pixel_pattern<pixel_t> context_type;
+
+    pattern_setter(BitmapImageType &image, const pixel_pattern<pixel_t>* pattern = nullptr)
+        : w(image.width()), h(image.height()), image_(image), pattern_(pattern)
+    { }
+    // prevent copying
+    pattern_setter() = delete;
+    pattern_setter(const pattern_setter&) = delete;
+    pattern_setter(pattern_setter&&) = delete;
+    pattern_setter& operator=(const pattern_setter&) = delete;
+
+    inline void operator()(int x, int y, pixel_t* pos, pixel_t value)
+    {
+        (void)pos;
+        if ( x >= 0 && x < w && y >= 0 && y < h )
+            image_.pixel(x, y) = pattern_ ? pattern_->at(unsigned(x), unsigned(y)) : value;
+    }
+
+    inline void hLine(int x0, int x1, int y, pixel_t* pos0, pixel_t* pos1, pixel_t value)
+    {
+        (void)pos0; (void)pos1;
+        if ( y >= 0 && y < h && x0 < w && x1 >= 0 )
+        {
+            if ( x0 < 0 ) x0 = 0;
+            if ( x1 >= w ) x1 = w - 1;
+            pixel_t* dest = image_.row(y) + x0;
+            if (!pattern_)
+            {
+                std::fill(dest, dest + (x1 - x0 + 1), value);
+                return;
+            }
+            const int max_span = int(pattern_->max_span());
+            for ( ; x0 <= x1; x0 += max_span, dest += max_span)
+            {
+                const pixel_t* src = pattern_->span(unsigned(x0), unsigned(y));
+                std::copy(src, src + std::min(x1 - x0 + 1, max_span), dest);
+            }
+        }
+    }
+
+    inline void hLineCorners(int x0, int x1, int y, pixel_t* pos0, pixel_t* pos1, pixel_t value)
+    {
+        (void)pos0; (void)pos1;
+        (*this)(x0, y, nullptr, value);
+        if (x1 != x0)
+            (*this)(x1, y, nullptr, value);
+    }
+
+    // anti-aliased pixel: the pattern blended over the image by coverage
+    inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+    {
+        (void)pos;
+        if ( x >= 0 && x < w && y >= 0 && y < h )
+            zingl_detail::blend_coverage(image_.pixel(x, y), pattern_ ? pattern_->at(unsigned(x), unsigned(y)) : value, cov);
+    }
+
+private:
+    const int w, h;
+    BitmapImageType &image_;
+    const pixel_pattern<pixel_t>* pattern_;
+};
+
+}
@@ -0,0 +1,135 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "parallel.hpp"
+
+#include <algorithm>
+
+
+namespace OffScreenBitmapDraw
+{
+
+// forward declaration - see cartesian_canvas.hpp
+template <class BitmapImageType, class Float>
+class cartesian_canvas;
+
+/// tile size of the pixel shader functions below.
+/// tiles are distributed over the threads dynamically, so that expensive
+/// image regions (e.g. the inside of a fractal) don't serialize on one thread.
+/// a tile row is a contiguous span of pixels - keep tile_width large
+struct pixel_tiling
+{
+    pixel_tiling(const unsigned width = 256, const unsigned height = 16)
+        : tile_width(width), tile_height(height)
+    { }
+
+    unsigned tile_width;
+    unsigned tile_height;
+};
+
+/// batch form: calls func(pixel_t* span, unsigned x0, unsigned y, unsigned n)
+/// for contiguous spans of n pixels starting at pixel (x0, y) - span[i] is pixel (x0 + i, y).
+/// a loop over i inside func with no dependency between pixels is vectorized by the compiler.
+/// coordinates are relative to the image - for a Slice relative to the slice origin.
+/// num_threads: 0 = hardware concurrency
+template <class BitmapImageType, class SpanFunc>
+inline void for_each_pixel_span(
+    BitmapImageType& image,
+    SpanFunc func,
+    const unsigned num_threads = 1,
+    const pixel_tiling tiling = pixel_tiling()
+    )
+{
+    const unsigned w = image.width(), h = image.height();
+    if (!w || !h)
+        return;
+    const unsigned tw = tiling.tile_width  ? std::min(tiling.tile_width , w) : w;
+    const unsigned th = tiling.tile_height ? std::min(tiling.tile_height, h) : h;
+    const unsigned tiles_x = (w + tw - 1) / tw;
+    const unsigned tiles_y = (h + th - 1) / th;
+
+    parallel_for_dynamic(tiles_x * tiles_y, num_threads, [&](const unsigned tile, const unsigned) {
+        const unsigned x0 = (tile % tiles_x) * tw;
+        const unsigned y0 = (tile / tiles_x) * th;
+        const unsigned n = std::min(tw, w - x0);
+        const unsigned y_end = std::min(y0 + th, h);
+        for (unsigned y = y0; y < y_end; ++y)
+            func(image.row(y) + x0, x0, y, n);
+    });
+}
+
+/// scalar form: calls func(pixel_t& pixel, unsigned x, unsigned y) for every pixel
+template <class BitmapImageType, class PixelFunc>
+inline void for_each_pixel(
+    BitmapImageType& image,
+    PixelFunc func,
+    const unsigned num_threads = 1,
+    const pixel_tiling tiling = pixel_tiling()
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    for_each_pixel_span(image, [&func](pixel_t* span, const unsigned x0, const unsigned y, const unsigned n) {
+        for (unsigned i = 0; i < n; ++i)
+            func(span[i], x0 + i, y);
+    }, num_threads, tiling);
+}
+
+/// sets every pixel to func(unsigned x, unsigned y), which returns a pixel_t
+template <class BitmapImageType, class ShaderFunc>
+inline void transform_pixels(
+    BitmapImageType& image,
+    ShaderFunc func,
+    const unsigned num_threads = 1,
+    const pixel_tiling tiling = pixel_tiling()
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    for_each_pixel_span(image, [&func](pixel_t* span, const unsigned x0, const unsigned y, const unsigned n) {
+        for (unsigned i = 0; i < n; ++i)
+            span[i] = func(x0 + i, y);
+    }, num_threads, tiling);
+}
+
+/// sets every pixel of the canvas image to func(Float x, Float y), called with
+/// the cartesian coordinates of the pixel: x grows to the right, y upwards and
+/// (0, 0) is the center of the canvas
+template <class BitmapImageType, class Float, class ShaderFunc>
+inline void transform_pixels(
+    cartesian_canvas<BitmapImageType, Float>& canvas,
+    ShaderFunc func,
+    const unsigned num_threads = 1,
+    const pixel_tiling tiling = pixel_tiling()
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    const Float min_x = canvas.min_x();
+    const Float max_y = canvas.max_y();
+    for_each_pixel_span(canvas.image(), [&](pixel_t* span, const unsigned x0, const unsigned y, const unsigned n) {
+        const Float cy = max_y - Float(y);
+        const Float cx0 = min_x + Float(x0);
+        for (unsigned i = 0; i < n; ++i)
+            span[i] = func(cx0 + Float(i), cy);
+    }, num_threads, tiling);
+}
+
+}
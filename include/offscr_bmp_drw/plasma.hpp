@@ -21,11 +21,104 @@
 #pragma once
 
 #include "bitmap_image_rgb.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
 
 namespace OffScreenBitmapDraw
 {
 
+/// counter based random number generator: the n-th number is a hash of (seed, n).
+/// there's no state besides the seed, so numbers can be drawn in any order
+/// and from any thread, always giving the same results on every platform
+struct counter_rng
+{
+    explicit counter_rng(const uint64_t seed_ = 0)
+        : seed(seed_)
+    { }
+
+    // splitmix64 finalizer over seed and counter
+    uint64_t operator()(const uint64_t counter) const
+    {
+        uint64_t z = seed + (counter + 1) * UINT64_C(0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+        z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+        return z ^ (z >> 31);
+    }
+
+    // uniform in [0 .. 1)
+    template <class Float>
+    Float uniform(const uint64_t counter) const
+    {
+        return Float( (*this)(counter) >> 11 ) * Float(1.0 / 9007199254740992.0);
+    }
+
+    uint64_t seed;
+};
+
+namespace plasma_detail
+{
+
+// unique counter for the center of cell (ix, iy) on subdivision level
+inline uint64_t cell_counter(const unsigned level, const unsigned ix, const unsigned iy)
+{
+    return (uint64_t(level) << 58) ^ (uint64_t(iy) << 29) ^ uint64_t(ix);
+}
+
+// one tile of the midpoint displacement: lattice holds (n+1) x (n+1) values,
+// only the 4 corners are set on entry. tile (tx, ty) is a cell of level top_level;
+// it's subdivided down to cells of level top_level + log2(n).
+// edge midpoints are the average of their end points - identical for neighbouring
+// cells/tiles - and the centers get a random displacement, which only depends on
+// the global cell index: tiles are independent of each other.
+template <class Float>
+inline void subdivide(
+    std::vector<Float>& lattice, const unsigned n,
+    const unsigned top_level, const unsigned tx, const unsigned ty,
+    const counter_rng& rng, const Float& roughness
+    )
+{
+    const unsigned stride = n + 1;
+    Float amplitude = roughness / Float(uint64_t(1) << (top_level + 1));
+    unsigned cells = 1;     // cells per tile side on current level
+    unsigned level = top_level;
+    for (unsigned step = n; step > 1; step /= 2, cells *= 2, amplitude /= Float(2), ++level)
+    {
+        const unsigned half = step / 2;
+        for (unsigned cy = 0; cy < cells; ++cy)
+        {
+            Float* r0 = &lattice[std::size_t(cy * step) * stride];
+            Float* rm = r0 + std::size_t(half) * stride;
+            Float* r1 = r0 + std::size_t(step) * stride;
+            for (unsigned cx = 0, x = 0; cx < cells; ++cx, x += step)
+            {
+                const Float c00 = r0[x], c10 = r0[x + step];
+                const Float c01 = r1[x], c11 = r1[x + step];
+                r0[x + half]   = (c00 + c10) / Float(2);
+                r1[x + half]   = (c01 + c11) / Float(2);
+                rm[x]          = (c00 + c01) / Float(2);
+                rm[x + step]   = (c10 + c11) / Float(2);
+                const Float noise = rng.template uniform<Float>(
+                    cell_counter(level, tx * cells + cx, ty * cells + cy)) - Float(0.5);
+                const Float center = (c00 + c10 + c01 + c11) / Float(4) + noise * amplitude;
+                rm[x + half] = std::min<Float>(std::max<Float>(Float(0), center), Float(1));
+            }
+        }
+    }
+}
+
+}
+
+/// plasma (midpoint displacement) in the region (x, y, width, height) of the image.
+/// corner values c1 (top left), c2 (top right), c3 (bottom right), c4 (bottom left) in [0.0 .. 1.0],
+/// the result is mapped through a 1000 entry colormap.
+/// the region is subdivided iteratively on a square lattice of power of 2 cells,
+/// until cells are at most one pixel. random displacements come from counter_rng,
+/// so the image only depends on the seed: tiles of 64 x 64 cells are generated
+/// independently and give the same output for any num_threads (0 = hardware concurrency).
 template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
 inline void plasma(
     BitmapImageType& image,
@@ -34,33 +127,71 @@ inline void plasma(
     const Float& c1,    const Float& c2,
     const Float& c3,    const Float& c4,
     const Float& roughness  = Float(3),
-    const rgb_t colormap[] = 0
+    const rgb_t colormap[] = 0,
+    const uint64_t seed = 0,
+    const unsigned num_threads = 1
     )
 {
-    // Note: c1,c2,c3,c4 -> [0.0,1.0]
-    const Float half_width  = ( width / Float(2));
-    const Float half_height = (height / Float(2));
+    using pixel_t = typename BitmapImageType::pixel_t;
 
-    if ( width >= Float(1) || height >= Float(1) )
-    {
-        const Float corner1 = (c1 + c2) / Float(2);
-        const Float corner2 = (c2 + c3) / Float(2);
-        const Float corner3 = (c3 + c4) / Float(2);
-        const Float corner4 = (c4 + c1) / Float(2);
-        Float center  = (c1 + c2 + c3 + c4) / Float(4)
-                       + (( Float(1) * ::rand() / (Float(1) * RAND_MAX))  - Float(0.5))   // should use a better rng
-                             * ( (Float(1) * half_width + half_height) / (image.width() + image.height()) * roughness );
-        center = std::min<Float>(std::max<Float>(Float(0),center), Float(1));
-        plasma(image, x,                            y, half_width, half_height,      c1, corner1,  center, corner4,roughness,colormap);
-        plasma(image, x + half_width,               y, half_width, half_height, corner1,      c2, corner2,  center,roughness,colormap);
-        plasma(image, x + half_width, y + half_height, half_width, half_height,  center, corner2,      c3, corner3,roughness,colormap);
-        plasma(image, x,              y + half_height, half_width, half_height, corner4,  center, corner3,      c4,roughness,colormap);
-    }
-    else
-    {
-        rgb_t color = colormap[static_cast<unsigned int>(Float(1000) * ((c1 + c2 + c3 + c4) / Float(4))) % 1000];
-        image.set_pixel(static_cast<unsigned int>(x), static_cast<unsigned int>(y), color);
-    }
+    const unsigned x0 = static_cast<unsigned>(std::max(Float(0), x));
+    const unsigned y0 = static_cast<unsigned>(std::max(Float(0), y));
+    if (!colormap || x0 >= image.width() || y0 >= image.height() || width < Float(1) || height < Float(1))
+        return;
+    const unsigned w = std::min(static_cast<unsigned>(width ), image.width()  - x0);
+    const unsigned h = std::min(static_cast<unsigned>(height), image.height() - y0);
+
+    // levels: 2^levels >= cells per side; tiles: 2^top_level per side with 2^tile_levels cells each
+    unsigned levels = 0;
+    while ((1U << levels) < std::max(w, h))
+        ++levels;
+    const unsigned tile_levels = std::min(levels, 6U);
+    const unsigned top_level   = levels - tile_levels;
+    const unsigned tiles       = 1U << top_level;
+    const unsigned tile_cells  = 1U << tile_levels;
+    const counter_rng rng(seed);
+
+    // the tile corners: the top levels of the subdivision
+    std::vector<Float> corners((tiles + 1) * (tiles + 1));
+    corners[0] = c1;
+    corners[tiles] = c2;
+    corners[std::size_t(tiles) * (tiles + 1) + tiles] = c3;
+    corners[std::size_t(tiles) * (tiles + 1)] = c4;
+    plasma_detail::subdivide(corners, tiles, 0, 0, 0, rng, roughness);
+
+    std::vector<pixel_t> palette(colormap, colormap + 1000);
+
+    parallel_for_dynamic(tiles * tiles, num_threads, [&](const unsigned tile, const unsigned) {
+        const unsigned tx = tile % tiles;
+        const unsigned ty = tile / tiles;
+        const unsigned stride = tile_cells + 1;
+        std::vector<Float> lattice(std::size_t(stride) * stride);
+        lattice[0] = corners[std::size_t(ty) * (tiles + 1) + tx];
+        lattice[tile_cells] = corners[std::size_t(ty) * (tiles + 1) + tx + 1];
+        lattice[std::size_t(tile_cells) * stride] = corners[std::size_t(ty + 1) * (tiles + 1) + tx];
+        lattice[std::size_t(tile_cells) * stride + tile_cells] = corners[std::size_t(ty + 1) * (tiles + 1) + tx + 1];
+        plasma_detail::subdivide(lattice, tile_cells, top_level, tx, ty, rng, roughness);
+
+        // pixels, whose cell (px * 2^levels / w) is in this tile; a pixel gets the average of its cell corners
+        const uint64_t n = uint64_t(1) << levels;
+        const unsigned px_begin = unsigned( (uint64_t(tx    ) * tile_cells * w + n - 1) >> levels );
+        const unsigned px_end   = unsigned( (uint64_t(tx + 1) * tile_cells * w + n - 1) >> levels );
+        const unsigned py_begin = unsigned( (uint64_t(ty    ) * tile_cells * h + n - 1) >> levels );
+        const unsigned py_end   = unsigned( (uint64_t(ty + 1) * tile_cells * h + n - 1) >> levels );
+        for (unsigned py = py_begin; py < py_end; ++py)
+        {
+            const unsigned cy = unsigned( (uint64_t(py) << levels) / h ) - ty * tile_cells;
+            const Float* r0 = &lattice[std::size_t(cy) * stride];
+            const Float* r1 = r0 + stride;
+            pixel_t* dest = image.row(y0 + py) + x0;
+            for (unsigned px = px_begin; px < px_end; ++px)
+            {
+                const unsigned cx = unsigned( (uint64_t(px) << levels) / w ) - tx * tile_cells;
+                const Float v = (r0[cx] + r0[cx + 1] + r1[cx] + r1[cx + 1]) / Float(4);
+                dest[px] = palette[static_cast<unsigned>(Float(1000) * v) % 1000];
+            }
+        }
+    });
 }
 
 template <class BitmapImageType = bitmap_image_rgb<>, class Float = double>
@@ -69,13 +200,15 @@ inline void plasma(
     const Float& c1, const Float& c2,
     const Float& c3, const Float& c4,
     const Float& roughness  = Float(3),
-    const rgb_t colormap[] = 0
+    const rgb_t colormap[] = 0,
+    const uint64_t seed = 0,
+    const unsigned num_threads = 1
     )
 {
     plasma(
-        image, 0, 0, image.width(), image.height(),
+        image, Float(0), Float(0), Float(image.width()), Float(image.height()),
         c1, c2, c3, c4,
-        roughness, colormap
+        roughness, colormap, seed, num_threads
         );
 }
 
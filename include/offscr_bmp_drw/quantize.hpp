@@ -0,0 +1,374 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "colors.hpp"
+#include "palette_index.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+namespace OffScreenBitmapDraw
+{
+
+/// color histogram on RGB555 cells: count and sums of the exact colors per cell
+struct color_histogram
+{
+    static constexpr unsigned num_cells = 32768;
+
+    struct cell
+    {
+        uint64_t count;
+        uint64_t sum[3];
+    };
+
+    std::vector<cell> cells;
+
+    static inline unsigned cell_of(const unsigned r, const unsigned g, const unsigned b)
+    {
+        return ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+    }
+
+    /// bands of rows fill their own histogram - summed up at the end
+    template <class BitmapImageType>
+    void build(const BitmapImageType& image, const unsigned num_threads = 1)
+    {
+        using pixel_t = typename BitmapImageType::pixel_t;
+        const unsigned n_bands = parallel_num_bands(image.height(), num_threads);
+        std::vector< std::vector<cell> > band_cells(n_bands);
+        parallel_for_bands(image.height(), num_threads, [&](const unsigned y0, const unsigned y1, const unsigned band) {
+            std::vector<cell>& bc = band_cells[band];
+            bc.assign(num_cells, cell{ 0, { 0, 0, 0 } });
+            for (unsigned y = y0; y < y1; ++y)
+            {
+                const pixel_t* row = image.row(y);
+                for (unsigned x = 0; x < image.width(); ++x)
+                {
+                    const unsigned r = *red(row[x]), g = *green(row[x]), b = *blue(row[x]);
+                    cell& c = bc[cell_of(r, g, b)];
+                    ++c.count;
+                    c.sum[0] += r;
+                    c.sum[1] += g;
+                    c.sum[2] += b;
+                }
+            }
+        });
+        cells.assign(num_cells, cell{ 0, { 0, 0, 0 } });
+        for (const std::vector<cell>& bc : band_cells)
+            for (unsigned k = 0; k < num_cells; ++k)
+            {
+                cells[k].count += bc[k].count;
+                for (int a = 0; a < 3; ++a)
+                    cells[k].sum[a] += bc[k].sum[a];
+            }
+    }
+};
+
+namespace quantize_detail
+{
+
+struct weighted_color
+{
+    int c[3];           // mean color of the histogram cell
+    uint64_t count;
+};
+
+struct box
+{
+    std::size_t begin, end;     // range in the weighted_color vector
+    uint64_t count;
+    int lo[3], hi[3];
+    int widest_axis() const
+    {
+        int axis = 0;
+        for (int a = 1; a < 3; ++a)
+            if (hi[a] - lo[a] > hi[axis] - lo[axis])
+                axis = a;
+        return axis;
+    }
+    int extent() const
+    {
+        const int a = widest_axis();
+        return hi[a] - lo[a];
+    }
+};
+
+inline box make_box(const std::vector<weighted_color>& colors, const std::size_t b, const std::size_t e)
+{
+    box bx{ b, e, 0, { 255, 255, 255 }, { 0, 0, 0 } };
+    for (std::size_t k = b; k < e; ++k)
+    {
+        bx.count += colors[k].count;
+        for (int a = 0; a < 3; ++a)
+        {
+            bx.lo[a] = std::min(bx.lo[a], colors[k].c[a]);
+            bx.hi[a] = std::max(bx.hi[a], colors[k].c[a]);
+        }
+    }
+    return bx;
+}
+
+template <class RGBColorType>
+inline RGBColorType mean_color(const uint64_t count, const uint64_t sum[3])
+{
+    RGBColorType c;
+    set_rgb(c,
+        typename RGBColorType::component((sum[0] + count / 2) / count),
+        typename RGBColorType::component((sum[1] + count / 2) / count),
+        typename RGBColorType::component((sum[2] + count / 2) / count));
+    return c;
+}
+
+}
+
+/// palette of at most num_colors for the image:
+/// median cut on the RGB555 histogram - the box with the largest count * extent
+/// is split at the weighted median of its widest axis - followed by
+/// kmeans_iterations of k-means (Lloyd) on the histogram cells.
+/// distances as weighted_rgb_distance(), assignment through palette_index<>
+template <class RGBColorType = rgb_t, class BitmapImageType>
+inline std::vector<RGBColorType> median_cut_palette(
+    const BitmapImageType& image,
+    const unsigned num_colors,
+    const unsigned kmeans_iterations = 3,
+    const unsigned num_threads = 1
+    )
+{
+    using namespace quantize_detail;
+    std::vector<RGBColorType> palette;
+    if (!num_colors || !image.width() || !image.height())
+        return palette;
+
+    color_histogram hist;
+    hist.build(image, num_threads);
+    std::vector<weighted_color> colors;
+    for (const color_histogram::cell& c : hist.cells)
+    {
+        if (!c.count)
+            continue;
+        weighted_color wc;
+        for (int a = 0; a < 3; ++a)
+            wc.c[a] = int((c.sum[a] + c.count / 2) / c.count);
+        wc.count = c.count;
+        colors.push_back(wc);
+    }
+
+    // median cut
+    std::vector<box> boxes(1, make_box(colors, 0, colors.size()));
+    while (boxes.size() < num_colors)
+    {
+        std::size_t best = boxes.size();
+        double best_score = 0;
+        for (std::size_t k = 0; k < boxes.size(); ++k)
+        {
+            const double score = double(boxes[k].count) * boxes[k].extent();
+            if (boxes[k].end - boxes[k].begin > 1 && score > best_score)
+            {
+                best_score = score;
+                best = k;
+            }
+        }
+        if (best == boxes.size())
+            break;      // no box left to split
+        const box bx = boxes[best];
+        const int axis = bx.widest_axis();
+        std::sort(colors.begin() + bx.begin, colors.begin() + bx.end,
+            [axis](const weighted_color& p, const weighted_color& q) { return p.c[axis] < q.c[axis]; });
+        uint64_t acc = 0;
+        std::size_t m = bx.begin;
+        while (m + 1 < bx.end && (acc + colors[m].count) * 2 <= bx.count)
+            acc += colors[m++].count;
+        if (m == bx.begin)
+            ++m;
+        boxes[best] = make_box(colors, bx.begin, m);
+        boxes.push_back(make_box(colors, m, bx.end));
+    }
+
+    for (const box& bx : boxes)
+    {
+        uint64_t sum[3] = { 0, 0, 0 };
+        for (std::size_t k = bx.begin; k < bx.end; ++k)
+            for (int a = 0; a < 3; ++a)
+                sum[a] += uint64_t(colors[k].c[a]) * colors[k].count;
+        palette.push_back(mean_color<RGBColorType>(bx.count, sum));
+    }
+
+    // k-means refinement
+    std::vector<color_histogram::cell> clusters;
+    for (unsigned it = 0; it < kmeans_iterations; ++it)
+    {
+        const palette_index<RGBColorType> index(palette.data(), palette.size(), false);
+        clusters.assign(palette.size(), color_histogram::cell{ 0, { 0, 0, 0 } });
+        for (const weighted_color& wc : colors)
+        {
+            color_histogram::cell& cl = clusters[ index.nearest_index(wc.c[0], wc.c[1], wc.c[2]) ];
+            cl.count += wc.count;
+            for (int a = 0; a < 3; ++a)
+                cl.sum[a] += uint64_t(wc.c[a]) * wc.count;
+        }
+        for (std::size_t k = 0; k < palette.size(); ++k)
+            if (clusters[k].count)
+                palette[k] = mean_color<RGBColorType>(clusters[k].count, clusters[k].sum);
+    }
+    return palette;
+}
+
+
+/// ordered dithering with the 8x8 Bayer matrix: each pixel is offset by its threshold
+/// (within +/- spread / 2 on each channel) before the palette lookup.
+/// no dependencies between pixels: bands of rows on num_threads (0 = hardware concurrency)
+template <class BitmapImageType, class RGBColorType, class IndexImageType>
+inline bool dither_ordered(
+    const BitmapImageType& image,
+    const palette_index<RGBColorType>& palette,
+    IndexImageType& index_image,
+    const int spread = 32,
+    const unsigned num_threads = 1
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using index_t = typename IndexImageType::pixel_t;
+    static const unsigned char bayer[8][8] = {
+        {  0, 32,  8, 40,  2, 34, 10, 42 },
+        { 48, 16, 56, 24, 50, 18, 58, 26 },
+        { 12, 44,  4, 36, 14, 46,  6, 38 },
+        { 60, 28, 52, 20, 62, 30, 54, 22 },
+        {  3, 35, 11, 43,  1, 33,  9, 41 },
+        { 51, 19, 59, 27, 49, 17, 57, 25 },
+        { 15, 47,  7, 39, 13, 45,  5, 37 },
+        { 63, 31, 55, 23, 61, 29, 53, 21 }
+    };
+    if ( palette.empty() || palette.size() - 1 > std::size_t(std::numeric_limits<index_t>::max()) )
+        return false;
+    if ( index_image.width() != image.width() || index_image.height() != image.height() )
+    {
+        if (!index_image.setwidth_height(image.width(), image.height()))
+            return false;
+    }
+    auto clamp = [](const int v) { return (v < 0) ? 0 : (v > 255) ? 255 : v; };
+    parallel_for_bands(image.height(), num_threads, [&](const unsigned y0, const unsigned y1, const unsigned) {
+        for (unsigned y = y0; y < y1; ++y)
+        {
+            const pixel_t* row = image.row(y);
+            index_t* dest = index_image.row(y);
+            for (unsigned x = 0; x < image.width(); ++x)
+            {
+                // threshold in (-spread/2 .. spread/2)
+                const int t = ((2 * bayer[y & 7][x & 7] + 1 - 64) * spread) / 128;
+                dest[x] = index_t( palette.nearest_index(
+                    clamp(*red(row[x]) + t), clamp(*green(row[x]) + t), clamp(*blue(row[x]) + t)) );
+            }
+        }
+    });
+    return true;
+}
+
+/// Floyd-Steinberg error diffusion with serpentine scan - even rows left to right, odd rows
+/// right to left. the error of the current and the next row is kept in two row buffers
+template <class BitmapImageType, class RGBColorType, class IndexImageType>
+inline bool dither_floyd_steinberg(
+    const BitmapImageType& image,
+    const palette_index<RGBColorType>& palette,
+    IndexImageType& index_image
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using index_t = typename IndexImageType::pixel_t;
+    if ( palette.empty() || palette.size() - 1 > std::size_t(std::numeric_limits<index_t>::max()) )
+        return false;
+    if ( index_image.width() != image.width() || index_image.height() != image.height() )
+    {
+        if (!index_image.setwidth_height(image.width(), image.height()))
+            return false;
+    }
+    const int w = int(image.width());
+    // errors in 1/16 units, with a guard entry on both sides
+    std::vector<int> err_cur(3 * (w + 2), 0), err_next(3 * (w + 2), 0);
+    auto clamp = [](const int v) { return (v < 0) ? 0 : (v > 255) ? 255 : v; };
+    auto div16 = [](const int v) { return (v >= 0) ? (v + 8) / 16 : -((8 - v) / 16); };
+
+    for (unsigned y = 0; y < image.height(); ++y)
+    {
+        const pixel_t* row = image.row(y);
+        index_t* dest = index_image.row(y);
+        const bool reverse = (y & 1);
+        const int dir = reverse ? -1 : 1;
+        std::fill(err_next.begin(), err_next.end(), 0);
+        for (int i = 0; i < w; ++i)
+        {
+            const int x = reverse ? (w - 1 - i) : i;
+            const int e = 3 * (x + 1);
+            const int c[3] = {
+                clamp(int(*red  (row[x])) + div16(err_cur[e + 0])),
+                clamp(int(*green(row[x])) + div16(err_cur[e + 1])),
+                clamp(int(*blue (row[x])) + div16(err_cur[e + 2])) };
+            const unsigned k = palette.nearest_index(c[0], c[1], c[2]);
+            dest[x] = index_t(k);
+            const RGBColorType& p = palette.color(k);
+            const int q[3] = { int(*red(p)), int(*green(p)), int(*blue(p)) };
+            for (int a = 0; a < 3; ++a)
+            {
+                const int d = c[a] - q[a];
+                err_cur [e + 3 * dir + a] += 7 * d;
+                err_next[e - 3 * dir + a] += 3 * d;
+                err_next[e           + a] += 5 * d;
+                err_next[e + 3 * dir + a] += 1 * d;
+            }
+        }
+        std::swap(err_cur, err_next);
+    }
+    return true;
+}
+
+/// expands an index image with the palette into image (resized if necessary)
+template <class IndexImageType, class RGBColorType, class BitmapImageType>
+inline bool indices_to_image(
+    const IndexImageType& index_image,
+    const std::vector<RGBColorType>& palette,
+    BitmapImageType& image
+    )
+{
+    using pixel_t = typename BitmapImageType::pixel_t;
+    using index_t = typename IndexImageType::pixel_t;
+    if ( image.width() != index_image.width() || image.height() != index_image.height() )
+    {
+        if (!image.setwidth_height(index_image.width(), index_image.height()))
+            return false;
+    }
+    for (unsigned y = 0; y < image.height(); ++y)
+    {
+        const index_t* src = index_image.row(y);
+        pixel_t* row = image.row(y);
+        for (unsigned x = 0; x < image.width(); ++x)
+        {
+            const RGBColorType& c = palette[ src[x] ];
+            set_rgb(row[x], *red(c), *green(c), *blue(c));
+        }
+    }
+    return true;
+}
+
+}
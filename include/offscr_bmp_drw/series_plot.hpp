@@ -0,0 +1,230 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+
+namespace OffScreenBitmapDraw
+{
+
+// maps the samples (x, y) of a series to pixels:
+//   column = round(x_offset + x * x_scale), row = round(y_offset + y * y_scale)
+// x_scale > 0 and the x of the samples must not decrease.
+// pixels are clamped to +-2^28
+template <class Float = double>
+struct series_mapping
+{
+    Float x_offset, x_scale;
+    Float y_offset, y_scale;
+
+    int column(const Float x) const { return to_pixel(x_offset + x * x_scale); }
+    int row(const Float y) const    { return to_pixel(y_offset + y * y_scale); }
+
+    static int to_pixel(const Float p)
+    {
+        const Float limit = Float(1 << 28);
+        return int(std::floor(std::min(limit, std::max(-limit, p)) + Float(0.5)));
+    }
+};
+
+// the samples of one pixel column: index range [begin, end) - empty when begin == end.
+// the rows of the first and the last sample and the row range min .. max
+struct column_extent
+{
+    size_t begin, end;
+    int first, last;
+    int min, max;
+};
+
+namespace series_detail
+{
+
+// T of xs is deduced from ys only: xs may be nullptr
+template <class T>
+struct identity { typedef T type; };
+
+// first index in [lo .. n) with a column >= c. xs == nullptr: x of sample i is i
+template <class T, class Float>
+inline size_t lower_column(const T* xs, const size_t n, const series_mapping<Float>& m, const int c, size_t lo)
+{
+    size_t hi = n;
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (m.column(xs ? Float(xs[mid]) : Float(mid)) < c)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// the rows [ya .. yb] of each column x in [0 .. w) of the line (x0, y0) - (x1, y1), as set
+// by zingl_image_drawer<>::plotLine(): for |dx| >= |dy| the k-th column gets row
+// k*|dy|/|dx| rounded half up - else the k-th row the column k*|dx|/|dy|
+template <class F>
+inline void line_columns(const int x0, const int y0, const int x1, const int y1, const int w, F f)
+{
+    using zingl_detail::floor_div;
+    using zingl_detail::ceil_div;
+    const long long dx = std::abs((long long)x1 - x0), sx = x0 < x1 ? 1 : -1;
+    const long long dy = std::abs((long long)y1 - y0), sy = y0 < y1 ? 1 : -1;
+    const long long ka = std::max(0LL, sx > 0 ? -(long long)x0 : (long long)x0 - (w - 1));
+    const long long kb = std::min(dx, sx > 0 ? (long long)(w - 1) - x0 : (long long)x0);
+    for (long long kx = ka; kx <= kb; ++kx)
+    {
+        long long ky0, ky1;
+        if (dx >= dy)
+            ky0 = ky1 = dx ? (2*dy*kx + dx) / (2*dx) : 0;
+        else if (!dx)
+        {
+            ky0 = 0;
+            ky1 = dy;
+        }
+        else
+        {
+            ky0 = std::max(0LL, ceil_div(2*dy*kx - dy, 2*dx));
+            ky1 = std::min(dy, floor_div(2*dy*(kx+1) - dy - 1, 2*dx));
+        }
+        const long long ya = y0 + sy*ky0, yb = y0 + sy*ky1;
+        f(int(x0 + sx*kx), int(std::min(ya, yb)), int(std::max(ya, yb)));
+    }
+}
+
+}
+
+// extents of the pixel columns [col0 .. col0 + n_cols) of the series (xs[i], ys[i]), i < n.
+// xs == nullptr for samples at x == i. a binary search per column boundary and
+// a vectorized min/max over the samples of each column - the columns are
+// split into bands for num_threads
+template <class T, class Float>
+void column_extents(
+    const typename series_detail::identity<T>::type* xs, const T* ys, const size_t n, const series_mapping<Float>& m,
+    const int col0, const unsigned n_cols, column_extent* extents,
+    const unsigned num_threads = 1
+    )
+{
+    parallel_for_bands(n_cols, num_threads, [&](unsigned b, unsigned e, unsigned) {
+        size_t idx = series_detail::lower_column(xs, n, m, col0 + int(b), 0);
+        for (unsigned k = b; k < e; ++k)
+        {
+            column_extent& ext = extents[k];
+            const size_t next = series_detail::lower_column(xs, n, m, col0 + int(k) + 1, idx);
+            ext.begin = idx;
+            ext.end = next;
+            ext.first = ext.last = ext.min = ext.max = 0;
+            if (next > idx)
+            {
+                T lo = ys[idx], hi = lo;
+                min_max_values(ys + idx + 1, ys + next, lo, hi);
+                ext.first = m.row(Float(ys[idx]));
+                ext.last = m.row(Float(ys[next - 1]));
+                ext.min = m.row(Float(lo));
+                ext.max = m.row(Float(hi));
+                if (ext.min > ext.max)      // y_scale < 0
+                    std::swap(ext.min, ext.max);
+            }
+            idx = next;
+        }
+    });
+}
+
+// draws the polyline through the mapped samples of the series - the same pixels as
+// zingl_image_drawer<>::plotPolyline() with PixelSetter, but oscilloscope-like: per pixel
+// column the rows from the min to the max sample and of the lines between the last
+// sample of a column and the first sample of the next one. these lines start and end
+// within the sample rows, so each column is a single vertical line: every pixel is set
+// once, also with PixelAdder. besides the min/max pass, the cost depends on the image
+// width, not on the number of samples
+template <class Setter, class BitmapImageType, class T, class Float>
+void plot_series(
+    BitmapImageType& image,
+    const typename series_detail::identity<T>::type* xs, const T* ys, const size_t n, const series_mapping<Float>& m,
+    const typename BitmapImageType::pixel_t color,
+    const unsigned num_threads = 1
+    )
+{
+    const unsigned w = image.width();
+    if (!n || !w)
+        return;
+    std::vector<column_extent> extents(w);
+    column_extents(xs, ys, n, m, 0, w, extents.data(), num_threads);
+
+    typedef zingl_image_drawer<BitmapImageType> drawer_t;
+    drawer_t drawer(image);
+    const auto sample = [&](const size_t i) {
+        return typename drawer_t::Point(m.column(xs ? Float(xs[i]) : Float(i)), m.row(Float(ys[i])));
+    };
+
+    // rows [lo .. hi] of each column
+    std::vector<int> lo(w, std::numeric_limits<int>::max()), hi(w, std::numeric_limits<int>::min());
+    const auto add_rows = [&](const int x, const int ya, const int yb) {
+        lo[x] = std::min(lo[x], ya);
+        hi[x] = std::max(hi[x], yb);
+    };
+
+    // the last sample left of the image connects into it
+    bool have_prev = (extents[0].begin > 0);
+    typename drawer_t::Point prev = have_prev ? sample(extents[0].begin - 1) : typename drawer_t::Point();
+    for (unsigned c = 0; c < w; ++c)
+    {
+        const column_extent& ext = extents[c];
+        if (ext.begin == ext.end)
+            continue;
+        add_rows(int(c), ext.min, ext.max);
+        if (have_prev)
+            series_detail::line_columns(prev.first, prev.second, int(c), ext.first, int(w), add_rows);
+        prev = typename drawer_t::Point(int(c), ext.last);
+        have_prev = true;
+    }
+    if (have_prev && extents[w - 1].end < n)
+    {
+        const typename drawer_t::Point next = sample(extents[w - 1].end);
+        series_detail::line_columns(prev.first, prev.second, next.first, next.second, int(w), add_rows);
+    }
+
+    for (unsigned c = 0; c < w; ++c)
+        if (lo[c] <= hi[c])
+            drawer.template plotVLine<Setter>(int(c), lo[c], hi[c], color);
+}
+
+template <class BitmapImageType, class T, class Float>
+void plot_series(
+    BitmapImageType& image,
+    const typename series_detail::identity<T>::type* xs, const T* ys, const size_t n, const series_mapping<Float>& m,
+    const typename BitmapImageType::pixel_t color,
+    const unsigned num_threads = 1
+    )
+{
+    plot_series<typename zingl_image_drawer<BitmapImageType>::PixelSetter>(image, xs, ys, n, m, color, num_threads);
+}
+
+}
@@ -0,0 +1,232 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+// compile time detection of the SIMD instruction sets used in some row kernels.
+// all kernels have a portable fallback
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OFFSCR_BMP_DRW_HAVE_SSE2  1
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define OFFSCR_BMP_DRW_HAVE_SSSE3  1
+#endif
+
+#include <algorithm>
+#include <cstdint>
+
+
+namespace OffScreenBitmapDraw
+{
+
+namespace simd_detail
+{
+
+// reverses P pixels of the 16 * V bytes starting at src into dst - per pixel size
+template <unsigned PixelSize>
+struct pixel_reverser
+{
+    static constexpr unsigned P = 0;    // no vector kernel
+};
+
+#if defined(OFFSCR_BMP_DRW_HAVE_SSE2)
+template <>
+struct pixel_reverser<4>
+{
+    static constexpr unsigned P = 4;
+    static inline void reverse(const void* src, void* dst)
+    {
+        const __m128i v = _mm_loadu_si128(static_cast<const __m128i*>(src));
+        _mm_storeu_si128(static_cast<__m128i*>(dst), _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)));
+    }
+};
+#endif
+
+#if defined(OFFSCR_BMP_DRW_HAVE_SSSE3)
+// 16 pixels of 3 bytes in 3 registers: output register k takes its bytes
+// from at most 2 input registers - masked byte shuffles, or-ed together
+template <>
+struct pixel_reverser<3>
+{
+    static constexpr unsigned P = 16;
+
+    struct masks
+    {
+        alignas(16) int8_t m[3][3][16];
+        masks()
+        {
+            for (unsigned j = 0; j < 48; ++j)
+            {
+                const unsigned p = j / 3, c = j % 3;
+                const unsigned s = (15 - p) * 3 + c;
+                for (unsigned in = 0; in < 3; ++in)
+                    m[j / 16][in][j % 16] = (s / 16 == in) ? int8_t(s % 16) : int8_t(-128);
+            }
+        }
+    };
+
+    static inline void reverse(const void* src, void* dst)
+    {
+        static const masks mk;
+        const __m128i* s = static_cast<const __m128i*>(src);
+        __m128i* d = static_cast<__m128i*>(dst);
+        const __m128i in[3] = { _mm_loadu_si128(s), _mm_loadu_si128(s + 1), _mm_loadu_si128(s + 2) };
+        __m128i out[3];
+        for (unsigned k = 0; k < 3; ++k)
+        {
+            out[k] = _mm_setzero_si128();
+            for (unsigned i = 0; i < 3; ++i)
+                out[k] = _mm_or_si128(out[k], _mm_shuffle_epi8(in[i],
+                    _mm_load_si128(reinterpret_cast<const __m128i*>(mk.m[k][i]))));
+        }
+        for (unsigned k = 0; k < 3; ++k)
+            _mm_storeu_si128(d + k, out[k]);
+    }
+};
+#endif
+
+template <class PixelType, unsigned P>
+struct reverse_pixels_impl
+{
+    static inline void run(PixelType* first, PixelType* last)
+    {
+        using R = pixel_reverser<sizeof(PixelType)>;
+        alignas(16) unsigned char a[P * sizeof(PixelType)];
+        while (last - first >= std::ptrdiff_t(2 * P))
+        {
+            // front block goes to the back and vice versa
+            R::reverse(first, a);
+            R::reverse(last - P, first);
+            std::copy(a, a + sizeof(a), reinterpret_cast<unsigned char*>(last - P));
+            first += P;
+            last -= P;
+        }
+        std::reverse(first, last);
+    }
+};
+
+template <class PixelType>
+struct reverse_pixels_impl<PixelType, 0>
+{
+    static inline void run(PixelType* first, PixelType* last)
+    {
+        std::reverse(first, last);
+    }
+};
+
+}
+
+/// reverses the pixels in [first, last) - with byte shuffles for 3- and 4-byte pixels
+template <class PixelType>
+inline void reverse_pixels(PixelType* first, PixelType* last)
+{
+    simd_detail::reverse_pixels_impl<PixelType, simd_detail::pixel_reverser<sizeof(PixelType)>::P>::run(first, last);
+}
+
+/// accumulates the minimum and maximum of the values in [first, last) into lo and hi -
+/// the range so far, e.g. *first or numeric_limits max() / lowest(). NaN values are skipped
+template <class T>
+inline void min_max_values(const T* first, const T* last, T& lo, T& hi)
+{
+    for ( ; first < last; ++first)
+    {
+        lo = (*first < lo) ? *first : lo;
+        hi = (hi < *first) ? *first : hi;
+    }
+}
+
+#if defined(OFFSCR_BMP_DRW_HAVE_SSE2)
+// the vector min/max keep their 2nd operand, when one is NaN: the accumulator
+inline void min_max_values(const float* first, const float* last, float& lo, float& hi)
+{
+    if (last - first >= 8)
+    {
+        __m128 vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+        for ( ; last - first >= 4; first += 4)
+        {
+            const __m128 v = _mm_loadu_ps(first);
+            vlo = _mm_min_ps(v, vlo);
+            vhi = _mm_max_ps(v, vhi);
+        }
+        alignas(16) float a[4], b[4];
+        _mm_store_ps(a, vlo);
+        _mm_store_ps(b, vhi);
+        min_max_values<float>(a, a + 4, lo, hi);
+        min_max_values<float>(b, b + 4, lo, hi);
+    }
+    min_max_values<float>(first, last, lo, hi);
+}
+
+inline void min_max_values(const double* first, const double* last, double& lo, double& hi)
+{
+    if (last - first >= 4)
+    {
+        __m128d vlo = _mm_set1_pd(lo), vhi = _mm_set1_pd(hi);
+        for ( ; last - first >= 2; first += 2)
+        {
+            const __m128d v = _mm_loadu_pd(first);
+            vlo = _mm_min_pd(v, vlo);
+            vhi = _mm_max_pd(v, vhi);
+        }
+        alignas(16) double a[2], b[2];
+        _mm_store_pd(a, vlo);
+        _mm_store_pd(b, vhi);
+        min_max_values<double>(a, a + 2, lo, hi);
+        min_max_values<double>(b, b + 2, lo, hi);
+    }
+    min_max_values<double>(first, last, lo, hi);
+}
+#endif
+
+
+/// adds value to each of [first, last) - the spans of the pixel adders
+template <class T>
+inline void add_to_values(T* first, T* last, const T value)
+{
+    for ( ; first < last; ++first)
+        *first += value;
+}
+
+#if defined(OFFSCR_BMP_DRW_HAVE_SSE2)
+inline void add_to_values(float* first, float* last, const float value)
+{
+    const __m128 v = _mm_set1_ps(value);
+    for ( ; last - first >= 4; first += 4)
+        _mm_storeu_ps(first, _mm_add_ps(_mm_loadu_ps(first), v));
+    for ( ; first < last; ++first)
+        *first += value;
+}
+
+inline void add_to_values(double* first, double* last, const double value)
+{
+    const __m128d v = _mm_set1_pd(value);
+    for ( ; last - first >= 2; first += 2)
+        _mm_storeu_pd(first, _mm_add_pd(_mm_loadu_pd(first), v));
+    for ( ; first < last; ++first)
+        *first += value;
+}
+#endif
+
+}
@@ -0,0 +1,433 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+
+namespace OffScreenBitmapDraw
+{
+
+/* Bezier curves after Zingl: the curve is cut where its gradient changes sign.
+   each part is rasterized with the error of its implicit equation - like the lines.
+   pixels are set once: each part leaves out its end pixel, which the next part starts with */
+
+template <class BitmapImageType>
+struct zingl_image_drawer<BitmapImageType>::BezierSegmentOp
+{
+    template <class Setter>
+    void quad(zingl_image_drawer& drawer, Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+              bool plot_end) const
+    {
+        drawer.quadBezierSegment(setPixel, x0, y0, x1, y1, x2, y2, color, plot_end);
+    }
+    template <class Setter>
+    void quadRational(zingl_image_drawer& drawer, Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                      double w, bool plot_first, bool plot_end) const
+    {
+        drawer.quadRationalBezierSegment(setPixel, x0, y0, x1, y1, x2, y2, w, color, plot_first, plot_end);
+    }
+    const pixel_t color;
+};
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadBezier(
+    int x0, int y0, int x1, int y1, int x2, int y2, const pixel_t color)
+{
+    const int xa = std::min(x0, std::min(x1, x2)), xb = std::max(x0, std::max(x1, x2));
+    const int ya = std::min(y0, std::min(y1, y2)), yb = std::max(y0, std::max(y1, y2));
+    if (outsideImage(xa, ya, xb, yb))
+        return;         /* the curve stays inside the hull of its control points */
+    if (fullyVisible<Setter>(xa, ya, xb, yb))
+        return plotQuadBezier<NoClipOf<Setter> >(x0, y0, x1, y1, x2, y2, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    quadBezierCuts(setPixel, x0, y0, x1, y1, x2, y2, BezierSegmentOp{ color });
+}
+
+template <class BitmapImageType>
+template <class Setter, class Segment>
+void zingl_image_drawer<BitmapImageType>::quadBezierCuts(
+    Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2, const Segment& segment)
+{
+    const int ox = x0, oy = y0;   /* relative to P0: the same pixels at each position */
+    x1 -= ox; y1 -= oy; x2 -= ox; y2 -= oy; x0 = y0 = 0;
+    int x = x0-x1, y = y0-y1;
+    double t = x0-2*x1+x2, r;
+
+    if ((long long)x*(x2-x1) > 0) {                     /* horizontal cut at P4? */
+        if ((long long)y*(y2-y1) > 0)                /* vertical cut at P6 too? */
+            if (std::fabs((y0-2*y1+y2)/t*x) > std::abs(y)) {   /* which first? */
+                x0 = x2; x2 = x+x1; y0 = y2; y2 = y+y1;        /* swap points */
+            }                          /* now horizontal cut at P4 comes first */
+        t = (x0-x1)/t;
+        r = (1-t)*((1-t)*y0+2.0*t*y1)+t*t*y2;                     /* By(t=P4) */
+        t = ((double)x0*x2-(double)x1*x1)*t/(x0-x1);     /* gradient dP4/dx=0 */
+        x = int(std::floor(t+0.5)); y = int(std::floor(r+0.5));
+        r = (y1-y0)*(t-x0)/(x1-x0)+y0;                /* intersect P3 | P0 P1 */
+        segment.quad(*this, setPixel, ox+x0, oy+y0, ox+x, oy+int(std::floor(r+0.5)), ox+x, oy+y, false);
+        r = (y1-y2)*(t-x2)/(x1-x2)+y2;                /* intersect P4 | P1 P2 */
+        x0 = x1 = x; y0 = y; y1 = int(std::floor(r+0.5));   /* P0 = P4, P1 = P8 */
+    }
+    if ((long long)(y0-y1)*(y2-y1) > 0) {                  /* vertical cut at P6? */
+        t = y0-2*y1+y2; t = (y0-y1)/t;
+        r = (1-t)*((1-t)*x0+2.0*t*x1)+t*t*x2;                     /* Bx(t=P6) */
+        t = ((double)y0*y2-(double)y1*y1)*t/(y0-y1);     /* gradient dP6/dy=0 */
+        x = int(std::floor(r+0.5)); y = int(std::floor(t+0.5));
+        r = (x1-x0)*(t-y0)/(y1-y0)+x0;                /* intersect P6 | P0 P1 */
+        segment.quad(*this, setPixel, ox+x0, oy+y0, ox+int(std::floor(r+0.5)), oy+y, ox+x, oy+y, false);
+        r = (x1-x2)*(t-y2)/(y1-y2)+x2;                /* intersect P7 | P1 P2 */
+        x0 = x; x1 = int(std::floor(r+0.5)); y0 = y1 = y;   /* P0 = P6, P1 = P7 */
+    }
+    segment.quad(*this, setPixel, ox+x0, oy+y0, ox+x1, oy+y1, ox+x2, oy+y2, true);   /* remaining part */
+}
+
+/* part of a quadratic curve, whose gradient doesn't change its sign */
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::quadBezierSegment(
+    Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+    const pixel_t color, const bool plot_end)
+{
+    int sx = x2-x1, sy = y2-y1;
+    long long xx = x0-x1, yy = y0-y1, xy;               /* relative values for checks */
+    double dx, dy, err, cur = double(xx*sy-yy*sx);                        /* curvature */
+    bool skip_first = false, skip_last = !plot_end;
+
+    if ((long long)sx*sx+(long long)sy*sy > xx*xx+yy*yy) {   /* begin with longer part */
+        x2 = x0; x0 = sx+x1; y2 = y0; y0 = sy+y1; cur = -cur;        /* swap P0 P2 */
+        std::swap(skip_first, skip_last);
+    }
+    if (cur != 0) {                                                /* no straight line */
+        xx += sx; xx *= sx = x0 < x2 ? 1 : -1;                     /* x step direction */
+        yy += sy; yy *= sy = y0 < y2 ? 1 : -1;                     /* y step direction */
+        xy = 2*xx*yy; xx *= xx; yy *= yy;                    /* differences 2nd degree */
+        if (cur*sx*sy < 0) {                                     /* negated curvature? */
+            xx = -xx; yy = -yy; xy = -xy; cur = -cur;
+        }
+        dx = 4.0*sy*cur*(x1-x0)+xx-xy;                       /* differences 1st degree */
+        dy = 4.0*sx*cur*(y0-y1)+yy-xy;
+        xx += xx; yy += yy; err = dx+dy+xy;                          /* error 1st step */
+        const std::ptrdiff_t dy_inc = sy * std::ptrdiff_t(image_.row_increment());
+        pixel_t * pos = signedRow(y0) + x0;
+        do {
+            if (x0 == x2 && y0 == y2) {                /* last pixel -> curve finished */
+                if (!skip_last)
+                    setPixel(x0, y0, pos, color);
+                return;
+            }
+            if (!skip_first)
+                setPixel(x0, y0, pos, color);                            /* plot curve */
+            skip_first = false;
+            const bool y_step = 2*err < dx;           /* save value for test of y step */
+            if (2*err > dy) { x0 += sx; pos += sx; dx -= xy; err += dy += yy; } /* x step */
+            if (y_step)     { y0 += sy; pos += dy_inc; dy -= xy; err += dx += xx; } /* y step */
+        } while (dy < 0 && dx > 0);             /* gradient negates -> algorithm fails */
+    }
+    /* remaining part as line - from the end, when the end pixel is left out */
+    if (skip_last)
+        lineSegment(setPixel, signedRow(y2), x2, y2, x0, y0, color, false);
+    else
+        lineSegment(setPixel, signedRow(y0), x0, y0, x2, y2, color, !skip_first);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadRationalBezier(
+    int x0, int y0, int x1, int y1, int x2, int y2, float w, const pixel_t color)
+{
+    const int xa = std::min(x0, std::min(x1, x2)), xb = std::max(x0, std::max(x1, x2));
+    const int ya = std::min(y0, std::min(y1, y2)), yb = std::max(y0, std::max(y1, y2));
+    if (!(w >= 0.0F) || outsideImage(xa, ya, xb, yb))
+        return;
+    if (fullyVisible<Setter>(xa, ya, xb, yb))
+        return plotQuadRationalBezier<NoClipOf<Setter> >(x0, y0, x1, y1, x2, y2, w, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    quadRationalBezierCuts(setPixel, x0, y0, x1, y1, x2, y2, w, BezierSegmentOp{ color }, true);
+}
+
+template <class BitmapImageType>
+template <class Setter, class Segment>
+void zingl_image_drawer<BitmapImageType>::quadRationalBezierCuts(
+    Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2, const double w,
+    const Segment& segment, const bool plot_end)
+{
+    const int ox = x0, oy = y0;   /* relative to P0: the same pixels at each position */
+    x1 -= ox; y1 -= oy; x2 -= ox; y2 -= oy; x0 = y0 = 0;
+    int x = x0-2*x1+x2, y = y0-2*y1+y2;
+    double xx = x0-x1, yy = y0-y1, ww, t, q;
+    double wd = w;
+    bool plot_first = true, plot_last = plot_end;
+
+    if (xx*(x2-x1) > 0) {                               /* horizontal cut at P4? */
+        if (yy*(y2-y1) > 0)                          /* vertical cut at P6 too? */
+            if (std::fabs(xx*y) > std::fabs(yy*x)) {           /* which first? */
+                x0 = x2; x2 = int(xx)+x1; y0 = y2; y2 = int(yy)+y1; /* swap points */
+                std::swap(plot_first, plot_last);
+            }                          /* now horizontal cut at P4 comes first */
+        if (x0 == x2 || wd == 1.0) t = (x0-x1)/(double)x;
+        else {                               /* non-rational or rational case */
+            q = std::sqrt(4.0*wd*wd*(x0-x1)*(x2-x1)+(double)(x2-x0)*(x2-x0));
+            if (x1 < x0) q = -q;
+            t = (2.0*wd*(x0-x1)-x0+x2+q)/(2.0*(1.0-wd)*(x2-x0));      /* t at P4 */
+        }
+        q = 1.0/(2.0*t*(1.0-t)*(wd-1.0)+1.0);              /* sub-divide at t */
+        xx = (t*t*(x0-2.0*wd*x1+x2)+2.0*t*(wd*x1-x0)+x0)*q;           /* = P4 */
+        yy = (t*t*(y0-2.0*wd*y1+y2)+2.0*t*(wd*y1-y0)+y0)*q;
+        ww = t*(wd-1.0)+1.0; ww *= ww*q;                /* squared weight P3 */
+        wd = ((1.0-t)*(wd-1.0)+1.0)*std::sqrt(q);                /* weight P8 */
+        x = int(std::floor(xx+0.5)); y = int(std::floor(yy+0.5));       /* P4 */
+        yy = (xx-x0)*(y1-y0)/(x1-x0)+y0;              /* intersect P3 | P0 P1 */
+        segment.quadRational(*this, setPixel, ox+x0, oy+y0, ox+x, oy+int(std::floor(yy+0.5)), ox+x, oy+y,
+                             ww, plot_first, false);
+        plot_first = true;
+        yy = (xx-x2)*(y1-y2)/(x1-x2)+y2;              /* intersect P4 | P1 P2 */
+        y1 = int(std::floor(yy+0.5)); x0 = x1 = x; y0 = y;   /* P0 = P4, P1 = P8 */
+    }
+    if ((y0-y1)*(long long)(y2-y1) > 0) {                  /* vertical cut at P6? */
+        if (y0 == y2 || wd == 1.0) t = (y0-y1)/(y0-2.0*y1+y2);
+        else {                               /* non-rational or rational case */
+            q = std::sqrt(4.0*wd*wd*(y0-y1)*(y2-y1)+(double)(y2-y0)*(y2-y0));
+            if (y1 < y0) q = -q;
+            t = (2.0*wd*(y0-y1)-y0+y2+q)/(2.0*(1.0-wd)*(y2-y0));      /* t at P6 */
+        }
+        q = 1.0/(2.0*t*(1.0-t)*(wd-1.0)+1.0);              /* sub-divide at t */
+        xx = (t*t*(x0-2.0*wd*x1+x2)+2.0*t*(wd*x1-x0)+x0)*q;           /* = P6 */
+        yy = (t*t*(y0-2.0*wd*y1+y2)+2.0*t*(wd*y1-y0)+y0)*q;
+        ww = t*(wd-1.0)+1.0; ww *= ww*q;                /* squared weight P5 */
+        wd = ((1.0-t)*(wd-1.0)+1.0)*std::sqrt(q);                /* weight P7 */
+        x = int(std::floor(xx+0.5)); y = int(std::floor(yy+0.5));       /* P6 */
+        xx = (x1-x0)*(yy-y0)/(y1-y0)+x0;              /* intersect P6 | P0 P1 */
+        segment.quadRational(*this, setPixel, ox+x0, oy+y0, ox+int(std::floor(xx+0.5)), oy+y, ox+x, oy+y,
+                             ww, plot_first, false);
+        plot_first = true;
+        xx = (x1-x2)*(yy-y2)/(y1-y2)+x2;              /* intersect P7 | P1 P2 */
+        x1 = int(std::floor(xx+0.5)); x0 = x; y0 = y1 = y;   /* P0 = P6, P1 = P7 */
+    }
+    segment.quadRational(*this, setPixel, ox+x0, oy+y0, ox+x1, oy+y1, ox+x2, oy+y2,
+                         wd*wd, plot_first, plot_last);                     /* remaining */
+}
+
+/* part of a rational quadratic curve without gradient sign change - w is the squared weight */
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::quadRationalBezierSegment(
+    Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2, double w,
+    const pixel_t color, const bool plot_first, const bool plot_end)
+{
+    int sx = x2-x1, sy = y2-y1;                          /* relative values for checks */
+    double dx = x0-x2, dy = y0-y2, xx = x0-x1, yy = y0-y1;
+    double xy = xx*sy+yy*sx, cur = xx*sy-yy*sx, err;                      /* curvature */
+    bool skip_first = !plot_first, skip_last = !plot_end;
+
+    if (cur != 0.0 && w > 0.0) {                                   /* no straight line */
+        if ((long long)sx*sx+(long long)sy*sy > xx*xx+yy*yy) {   /* begin with longer part */
+            x2 = x0; x0 -= int(dx); y2 = y0; y0 -= int(dy); cur = -cur;  /* swap P0 P2 */
+            std::swap(skip_first, skip_last);
+        }
+        xx = 2.0*(4.0*w*sx*xx+dx*dx);                        /* differences 2nd degree */
+        yy = 2.0*(4.0*w*sy*yy+dy*dy);
+        sx = x0 < x2 ? 1 : -1;                                     /* x step direction */
+        sy = y0 < y2 ? 1 : -1;                                     /* y step direction */
+        xy = -2.0*sx*sy*(2.0*w*xy+dx*dy);
+
+        if (cur*sx*sy < 0.0) {                                   /* negated curvature? */
+            xx = -xx; yy = -yy; xy = -xy; cur = -cur;
+        }
+        dx = 4.0*w*(x1-x0)*sy*cur+xx/2.0+xy;                 /* differences 1st degree */
+        dy = 4.0*w*(y0-y1)*sx*cur+yy/2.0+xy;
+
+        if (w < 0.5 && (dy > xy || dx < xy)) {          /* flat ellipse, algorithm fails */
+            cur = (w+1.0)/2.0; w = std::sqrt(w); xy = 1.0/(w+1.0);
+            /* sub-divide in half - relative to P1, the same pixels at each position */
+            const int xm = x1+int(std::floor((x0-x1+x2-x1)*xy/2.0+0.5));
+            const int ym = y1+int(std::floor((y0-y1+y2-y1)*xy/2.0+0.5));
+            const int xc0 = x1+int(std::floor((x0-x1)*xy+0.5)), yc0 = y1+int(std::floor((y0-y1)*xy+0.5));
+            const int xc2 = x1+int(std::floor((x2-x1)*xy+0.5)), yc2 = y1+int(std::floor((y2-y1)*xy+0.5));
+            quadRationalBezierSegment(setPixel, x0, y0, xc0, yc0, xm, ym, cur, color, !skip_first, false);
+            quadRationalBezierSegment(setPixel, xm, ym, xc2, yc2, x2, y2, cur, color, true, !skip_last);
+            return;
+        }
+        err = dx+dy-xy;                                                /* error 1.step */
+        const std::ptrdiff_t dy_inc = sy * std::ptrdiff_t(image_.row_increment());
+        pixel_t * pos = signedRow(y0) + x0;
+        do {
+            if (x0 == x2 && y0 == y2) {                /* last pixel -> curve finished */
+                if (!skip_last)
+                    setPixel(x0, y0, pos, color);
+                return;
+            }
+            if (!skip_first)
+                setPixel(x0, y0, pos, color);                            /* plot curve */
+            skip_first = false;
+            const bool x_step = 2*err > dy, y_step = 2*(err+yy) < -dy;  /* save values */
+            if (2*err < dx || y_step) { y0 += sy; pos += dy_inc; dy += xy; err += dx += xx; }
+            if (2*err > dx || x_step) { x0 += sx; pos += sx; dx += xy; err += dy += yy; }
+        } while (dy <= xy && dx >= xy);         /* gradient negates -> algorithm fails */
+    }
+    /* remaining needle as line - from the end, when the end pixel is left out */
+    if (!skip_last)
+        lineSegment(setPixel, signedRow(y0), x0, y0, x2, y2, color, !skip_first);
+    else if (!skip_first)
+        lineSegment(setPixel, signedRow(y2), x2, y2, x0, y0, color, false);
+    else if (x0 != x2 || y0 != y2) {                  /* straight, both ends left out */
+        PixelExcept<Setter> except(setPixel, x0, y0);
+        lineSegment(except, signedRow(y2), x2, y2, x0, y0, color, false);
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotCubicBezier(
+    int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, const pixel_t color)
+{
+    const int xa = std::min(std::min(x0, x1), std::min(x2, x3)), xb = std::max(std::max(x0, x1), std::max(x2, x3));
+    const int ya = std::min(std::min(y0, y1), std::min(y2, y3)), yb = std::max(std::max(y0, y1), std::max(y2, y3));
+    if (outsideImage(xa, ya, xb, yb))
+        return;
+    if (fullyVisible<Setter>(xa, ya, xb, yb))
+        return plotCubicBezier<NoClipOf<Setter> >(x0, y0, x1, y1, x2, y2, x3, y3, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    cubicBezierCuts(setPixel, x0, y0, x1, y1, x2, y2, x3, y3, BezierSegmentOp{ color });
+}
+
+template <class BitmapImageType>
+template <class Setter, class Segment>
+void zingl_image_drawer<BitmapImageType>::cubicBezierCuts(
+    Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, const Segment& segment)
+{
+    const int ox = x0, oy = y0;   /* relative to P0: the same pixels at each position */
+    x1 -= ox; y1 -= oy; x2 -= ox; y2 -= oy; x3 -= ox; y3 -= oy; x0 = y0 = 0;
+    int n = 0, i = 0;
+    const long long xc = x0+x1-x2-x3, xa3 = xc-4*(x1-x2);
+    const long long xb3 = x0-x1-x2+x3, xd = xb3+4*(x1+x2);
+    const long long yc = y0+y1-y2-y3, ya3 = yc-4*(y1-y2);
+    const long long yb3 = y0-y1-y2+y3, yd = yb3+4*(y1+y2);
+    double fx0 = x0, fx1, fx2, fx3, fy0 = y0, fy1, fy2, fy3;
+    double t1 = double(xb3*xb3-xa3*xc), t2, t[5];
+                                   /* sub-divide curve at gradient sign changes */
+    if (xa3 == 0) {                                                 /* horizontal */
+        if (std::llabs(xc) < 2*std::llabs(xb3)) t[n++] = xc/(2.0*xb3);    /* one change */
+    } else if (t1 > 0.0) {                                        /* two changes */
+        t2 = std::sqrt(t1);
+        t1 = (xb3-t2)/xa3; if (std::fabs(t1) < 1.0) t[n++] = t1;
+        t1 = (xb3+t2)/xa3; if (std::fabs(t1) < 1.0) t[n++] = t1;
+    }
+    t1 = double(yb3*yb3-ya3*yc);
+    if (ya3 == 0) {                                                   /* vertical */
+        if (std::llabs(yc) < 2*std::llabs(yb3)) t[n++] = yc/(2.0*yb3);    /* one change */
+    } else if (t1 > 0.0) {                                        /* two changes */
+        t2 = std::sqrt(t1);
+        t1 = (yb3-t2)/ya3; if (std::fabs(t1) < 1.0) t[n++] = t1;
+        t1 = (yb3+t2)/ya3; if (std::fabs(t1) < 1.0) t[n++] = t1;
+    }
+    std::sort(t, t + n);
+
+    t1 = -1.0; t[n] = 1.0;                                  /* begin / end point */
+    for (i = 0; i <= n; i++) {                   /* plot each segment separately */
+        t2 = t[i];                                  /* sub-divide at t[i-1], t[i] */
+        fx1 = (t1*(t1*xb3-2*xc)-t2*(t1*(t1*xa3-2*xb3)+xc)+xd)/8-fx0;
+        fy1 = (t1*(t1*yb3-2*yc)-t2*(t1*(t1*ya3-2*yb3)+yc)+yd)/8-fy0;
+        fx2 = (t2*(t2*xb3-2*xc)-t1*(t2*(t2*xa3-2*xb3)+xc)+xd)/8-fx0;
+        fy2 = (t2*(t2*yb3-2*yc)-t1*(t2*(t2*ya3-2*yb3)+yc)+yd)/8-fy0;
+        fx0 -= fx3 = (t2*(t2*(3*xb3-t2*xa3)-3*xc)+xd)/8;
+        fy0 -= fy3 = (t2*(t2*(3*yb3-t2*ya3)-3*yc)+yd)/8;
+        x3 = int(std::floor(fx3+0.5)); y3 = int(std::floor(fy3+0.5));   /* scale bounds to int */
+        if (fx0 != 0.0) { fx1 *= fx0 = (x0-x3)/fx0; fx2 *= fx0; }
+        if (fy0 != 0.0) { fy1 *= fy0 = (y0-y3)/fy0; fy2 *= fy0; }
+        if (x0 != x3 || y0 != y3 || i == n)                 /* segment t1 - t2 */
+            cubicBezierSegment(setPixel, ox+x0, oy+y0, fx1, fy1, fx2, fy2,
+                               ox+x3, oy+y3, segment, i == n);
+        x0 = x3; y0 = y3; fx0 = fx3; fy0 = fy3; t1 = t2;
+    }
+}
+
+/* part of a cubic curve without gradient sign change: Zingl's cubic loop falls back
+   to a straight line at nearly cusps. instead the part is split into quadratic pieces
+   within 0.2 pixel - the distance of a cubic to its quadratic of the same tangents at
+   the ends is sqrt(3)/36 |P3 - 3 P2 + 3 P1 - P0|, shrinking with the cube of the piece */
+template <class BitmapImageType>
+template <class Setter, class Segment>
+void zingl_image_drawer<BitmapImageType>::cubicBezierSegment(
+    Setter& setPixel, const int x0, const int y0, const double x1, const double y1,
+    const double x2, const double y2, const int x3, const int y3, const Segment& segment, const bool plot_end)
+{
+    const double ex = x3-x0-3*x2+3*x1, ey = y3-y0-3*y2+3*y1;
+    const int n = std::max(1, std::min(64, int(std::ceil(std::cbrt(0.2406 * std::sqrt(ex*ex+ey*ey))))));
+    const double h3 = 1.0 / (3.0*n);
+    /* point relative to P0 and derivative at t */
+    auto curve = [&](const double t, double& px, double& py, double& vx, double& vy) {
+        const double u = 1.0 - t;
+        px = 3.0*u*t*(u*x1 + t*x2) + t*t*t*(x3-x0);
+        py = 3.0*u*t*(u*y1 + t*y2) + t*t*t*(y3-y0);
+        vx = 3.0*(u*u*x1 + 2.0*u*t*(x2-x1) + t*t*(x3-x0-x2));
+        vy = 3.0*(u*u*y1 + 2.0*u*t*(y2-y1) + t*t*(y3-y0-y2));
+    };
+    int xa = x0, ya = y0;
+    double pax = 0.0, pay = 0.0, vax, vay, pbx, pby, vbx, vby;
+    curve(0.0, pbx, pby, vax, vay);
+
+    for (int k = 1; k <= n; ++k)
+    {
+        curve(double(k) / n, pbx, pby, vbx, vby);
+        const int xb = (k == n) ? x3 : x0+int(std::floor(pbx+0.5));
+        const int yb = (k == n) ? y3 : y0+int(std::floor(pby+0.5));
+        /* control point of the quadratic piece - inside the box of its ends,
+           as the gradient doesn't change its sign */
+        const double qx = (3.0*(pax + pbx + h3*(vax - vbx)) - pax - pbx) / 4.0;
+        const double qy = (3.0*(pay + pby + h3*(vay - vby)) - pay - pby) / 4.0;
+        const int xq = std::min(std::max(x0+int(std::floor(qx+0.5)), std::min(xa, xb)), std::max(xa, xb));
+        const int yq = std::min(std::max(y0+int(std::floor(qy+0.5)), std::min(ya, yb)), std::max(ya, yb));
+        segment.quad(*this, setPixel, xa, ya, xq, yq, xb, yb, k == n && plot_end);
+        xa = xb; ya = yb; pax = pbx; pay = pby; vax = vbx; vay = vby;
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadBezier(
+    const Point pt0, const Point pt1, const Point pt2, const pixel_t color)
+{
+    plotQuadBezier<Setter>(pt0.first, pt0.second, pt1.first, pt1.second, pt2.first, pt2.second, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadRationalBezier(
+    const Point pt0, const Point pt1, const Point pt2, float w, const pixel_t color)
+{
+    plotQuadRationalBezier<Setter>(pt0.first, pt0.second, pt1.first, pt1.second, pt2.first, pt2.second, w, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotCubicBezier(
+    const Point pt0, const Point pt1, const Point pt2, const Point pt3, const pixel_t color)
+{
+    plotCubicBezier<Setter>(pt0.first, pt0.second, pt1.first, pt1.second,
+                            pt2.first, pt2.second, pt3.first, pt3.second, color);
+}
+
+}
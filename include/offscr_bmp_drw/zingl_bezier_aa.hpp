@@ -0,0 +1,249 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+
+namespace OffScreenBitmapDraw
+{
+
+/* anti-aliased Bezier curves after Zingl's plotQuadBezierSegAA() and
+   plotQuadRationalBezierSegAA(): cut like the aliased curves, each part steps along
+   the curve and blends the pixel on it and the one beside it with 1 minus their
+   distance. the distance is the error of the implicit equation over the length of
+   its gradient at the pixel on the curve - one step further for the pixel beside.
+   the pixels at the cuts are set once, the cubic curve goes as quadratic pieces */
+
+template <class BitmapImageType>
+struct zingl_image_drawer<BitmapImageType>::BezierAASegmentOp
+{
+    template <class Setter>
+    void quad(zingl_image_drawer& drawer, Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+              bool plot_end) const
+    {
+        drawer.quadBezierSegmentAA(setPixel, x0, y0, x1, y1, x2, y2, color, plot_end);
+    }
+    template <class Setter>
+    void quadRational(zingl_image_drawer& drawer, Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                      double w, bool plot_first, bool plot_end) const
+    {
+        drawer.quadRationalBezierSegmentAA(setPixel, x0, y0, x1, y1, x2, y2, w, color, plot_first, plot_end);
+    }
+    const pixel_t color;
+};
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadBezierAA(
+    int x0, int y0, int x1, int y1, int x2, int y2, const pixel_t color)
+{
+    const int xa = std::min(x0, std::min(x1, x2)) - 1, xb = std::max(x0, std::max(x1, x2)) + 1;
+    const int ya = std::min(y0, std::min(y1, y2)) - 1, yb = std::max(y0, std::max(y1, y2)) + 1;
+    if (outsideImage(xa, ya, xb, yb))
+        return;
+    if (fullyVisible<Setter>(xa, ya, xb, yb))
+        return plotQuadBezierAA<NoClipOf<Setter> >(x0, y0, x1, y1, x2, y2, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    quadBezierCuts(setPixel, x0, y0, x1, y1, x2, y2, BezierAASegmentOp{ color });
+}
+
+/* part of a quadratic curve, whose gradient doesn't change its sign */
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::quadBezierSegmentAA(
+    Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+    const pixel_t color, const bool plot_end)
+{
+    int sx = x2-x1, sy = y2-y1;
+    long long xx = x0-x1, yy = y0-y1, xy;               /* relative values for checks */
+    double dx, dy, err, ed, cur = double(xx*sy-yy*sx);                    /* curvature */
+    bool skip_first = false, skip_last = !plot_end;
+
+    if ((long long)sx*sx+(long long)sy*sy > xx*xx+yy*yy) {   /* begin with longer part */
+        x2 = x0; x0 = sx+x1; y2 = y0; y0 = sy+y1; cur = -cur;        /* swap P0 P2 */
+        std::swap(skip_first, skip_last);
+    }
+    if (cur != 0) {                                                /* no straight line */
+        xx += sx; xx *= sx = x0 < x2 ? 1 : -1;                     /* x step direction */
+        yy += sy; yy *= sy = y0 < y2 ? 1 : -1;                     /* y step direction */
+        xy = 2*xx*yy; xx *= xx; yy *= yy;                    /* differences 2nd degree */
+        if (cur*sx*sy < 0) {                                     /* negated curvature? */
+            xx = -xx; yy = -yy; xy = -xy; cur = -cur;
+        }
+        dx = 4.0*sy*cur*(x1-x0)+xx-xy;                       /* differences 1st degree */
+        dy = 4.0*sx*cur*(y0-y1)+yy-xy;
+        xx += xx; yy += yy; err = dx+dy+xy;                          /* error 1st step */
+        const std::ptrdiff_t dy_inc = sy * std::ptrdiff_t(image_.row_increment());
+        pixel_t * pos = signedRow(y0) + x0;
+        do {
+            const double e = err-dx-dy-xy;                         /* error of the pixel */
+            const double gx = dy+xy-yy/2.0, gy = dx+xy-xx/2.0;      /* gradient there */
+            ed = std::sqrt(gx*gx+gy*gy);
+            if (x0 == x2 && y0 == y2) {                /* last pixel -> curve finished */
+                if (!skip_last)
+                    zingl_detail::set_coverage(setPixel, x0, y0, pos, color, zingl_detail::distance_coverage(e, ed));
+                return;
+            }
+            if (x0 == x2 || y0 == y2)                           /* straight rest as line */
+                break;
+            if (!skip_first)                                             /* plot curve */
+                zingl_detail::set_coverage(setPixel, x0, y0, pos, color, zingl_detail::distance_coverage(e, ed));
+            skip_first = false;
+            const bool y_step = 2*err+dy < 0;                /* save values for the y step */
+            const int x_side = x0+sx;
+            pixel_t * const pos_side = pos + sx;
+            if (2*err+dx > 0) {                                                /* x step */
+                if (std::fabs(e+gy) < ed)                        /* pixel beside in y */
+                    zingl_detail::set_coverage(setPixel, x0, y0+sy, pos + dy_inc, color,
+                                               zingl_detail::distance_coverage(e+gy, ed));
+                x0 += sx; pos += sx; dx -= xy; err += dy += yy;
+            }
+            if (y_step) {                                                      /* y step */
+                if (std::fabs(e+gx) < ed)                        /* pixel beside in x */
+                    zingl_detail::set_coverage(setPixel, x_side, y0, pos_side, color,
+                                               zingl_detail::distance_coverage(e+gx, ed));
+                y0 += sy; pos += dy_inc; dy -= xy; err += dx += xx;
+            }
+        } while (dy < dx);                    /* gradient negates -> algorithm fails */
+    }
+    /* remaining part as line - from the end, when the end pixel is left out */
+    if (skip_last)
+        lineAASegment(setPixel, signedRow(y2), x2, y2, x0, y0, color, false);
+    else
+        lineAASegment(setPixel, signedRow(y0), x0, y0, x2, y2, color, !skip_first);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadRationalBezierAA(
+    int x0, int y0, int x1, int y1, int x2, int y2, float w, const pixel_t color)
+{
+    const int xa = std::min(x0, std::min(x1, x2)) - 1, xb = std::max(x0, std::max(x1, x2)) + 1;
+    const int ya = std::min(y0, std::min(y1, y2)) - 1, yb = std::max(y0, std::max(y1, y2)) + 1;
+    if (!(w >= 0.0F) || outsideImage(xa, ya, xb, yb))
+        return;
+    if (fullyVisible<Setter>(xa, ya, xb, yb))
+        return plotQuadRationalBezierAA<NoClipOf<Setter> >(x0, y0, x1, y1, x2, y2, w, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    quadRationalBezierCuts(setPixel, x0, y0, x1, y1, x2, y2, w, BezierAASegmentOp{ color }, true);
+}
+
+/* part of a rational quadratic curve without gradient sign change - w is the squared weight */
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::quadRationalBezierSegmentAA(
+    Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2, double w,
+    const pixel_t color, const bool plot_first, const bool plot_end)
+{
+    int sx = x2-x1, sy = y2-y1;                          /* relative values for checks */
+    double dx = x0-x2, dy = y0-y2, xx = x0-x1, yy = y0-y1;
+    double xy = xx*sy+yy*sx, cur = xx*sy-yy*sx, err, ed;                  /* curvature */
+    bool skip_first = !plot_first, skip_last = !plot_end;
+
+    if (cur != 0.0 && w > 0.0) {                                   /* no straight line */
+        if ((long long)sx*sx+(long long)sy*sy > xx*xx+yy*yy) {   /* begin with longer part */
+            x2 = x0; x0 -= int(dx); y2 = y0; y0 -= int(dy); cur = -cur;  /* swap P0 P2 */
+            std::swap(skip_first, skip_last);
+        }
+        xx = 2.0*(4.0*w*sx*xx+dx*dx);                        /* differences 2nd degree */
+        yy = 2.0*(4.0*w*sy*yy+dy*dy);
+        sx = x0 < x2 ? 1 : -1;                                     /* x step direction */
+        sy = y0 < y2 ? 1 : -1;                                     /* y step direction */
+        xy = -2.0*sx*sy*(2.0*w*xy+dx*dy);
+
+        if (cur*sx*sy < 0.0) {                                   /* negated curvature? */
+            xx = -xx; yy = -yy; xy = -xy; cur = -cur;
+        }
+        dx = 4.0*w*(x1-x0)*sy*cur+xx/2.0+xy;                 /* differences 1st degree */
+        dy = 4.0*w*(y0-y1)*sx*cur+yy/2.0+xy;
+
+        if (w < 0.5 && (dy > xy || dx < xy)) {          /* flat ellipse, algorithm fails */
+            cur = (w+1.0)/2.0; w = std::sqrt(w); xy = 1.0/(w+1.0);
+            /* sub-divide in half - relative to P1, the same pixels at each position */
+            const int xm = x1+int(std::floor((x0-x1+x2-x1)*xy/2.0+0.5));
+            const int ym = y1+int(std::floor((y0-y1+y2-y1)*xy/2.0+0.5));
+            const int xc0 = x1+int(std::floor((x0-x1)*xy+0.5)), yc0 = y1+int(std::floor((y0-y1)*xy+0.5));
+            const int xc2 = x1+int(std::floor((x2-x1)*xy+0.5)), yc2 = y1+int(std::floor((y2-y1)*xy+0.5));
+            quadRationalBezierSegmentAA(setPixel, x0, y0, xc0, yc0, xm, ym, cur, color, !skip_first, false);
+            quadRationalBezierSegmentAA(setPixel, xm, ym, xc2, yc2, x2, y2, cur, color, true, !skip_last);
+            return;
+        }
+        err = dx+dy-xy;                                                /* error 1.step */
+        const std::ptrdiff_t dy_inc = sy * std::ptrdiff_t(image_.row_increment());
+        pixel_t * pos = signedRow(y0) + x0;
+        do {
+            const double e = err-dx-dy+xy;                         /* error of the pixel */
+            const double gx = dy-xy-yy/2.0, gy = dx-xy-xx/2.0;      /* gradient there */
+            ed = std::sqrt(gx*gx+gy*gy);
+            if (x0 == x2 && y0 == y2) {                /* last pixel -> curve finished */
+                if (!skip_last)
+                    zingl_detail::set_coverage(setPixel, x0, y0, pos, color, zingl_detail::distance_coverage(e, ed));
+                return;
+            }
+            if (x0 == x2 || y0 == y2)                           /* straight rest as line */
+                break;
+            if (!skip_first)                                             /* plot curve */
+                zingl_detail::set_coverage(setPixel, x0, y0, pos, color, zingl_detail::distance_coverage(e, ed));
+            skip_first = false;
+            const bool y_step = 2*err+dy < 0;
+            if (y_step && std::fabs(e+gx) < ed)                  /* pixel beside in x */
+                zingl_detail::set_coverage(setPixel, x0+sx, y0, pos + sx, color,
+                                           zingl_detail::distance_coverage(e+gx, ed));
+            if (2*err+dx > 0) {                                                /* x step */
+                if (std::fabs(e+gy) < ed)                        /* pixel beside in y */
+                    zingl_detail::set_coverage(setPixel, x0, y0+sy, pos + dy_inc, color,
+                                               zingl_detail::distance_coverage(e+gy, ed));
+                x0 += sx; pos += sx; dx += xy; err += dy += yy;
+            }
+            if (y_step) { y0 += sy; pos += dy_inc; dy += xy; err += dx += xx; }  /* y step */
+        } while (dy <= xy && dx >= xy);         /* gradient negates -> algorithm fails */
+    }
+    /* remaining needle as line - from the end, when the end pixel is left out */
+    if (!skip_last)
+        lineAASegment(setPixel, signedRow(y0), x0, y0, x2, y2, color, !skip_first);
+    else if (!skip_first)
+        lineAASegment(setPixel, signedRow(y2), x2, y2, x0, y0, color, false);
+    else if (x0 != x2 || y0 != y2) {                  /* straight, both ends left out */
+        PixelExcept<Setter> except(setPixel, x0, y0);
+        lineAASegment(except, signedRow(y2), x2, y2, x0, y0, color, false);
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotCubicBezierAA(
+    int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, const pixel_t color)
+{
+    const int xa = std::min(std::min(x0, x1), std::min(x2, x3)) - 1, xb = std::max(std::max(x0, x1), std::max(x2, x3)) + 1;
+    const int ya = std::min(std::min(y0, y1), std::min(y2, y3)) - 1, yb = std::max(std::max(y0, y1), std::max(y2, y3)) + 1;
+    if (outsideImage(xa, ya, xb, yb))
+        return;
+    if (fullyVisible<Setter>(xa, ya, xb, yb))
+        return plotCubicBezierAA<NoClipOf<Setter> >(x0, y0, x1, y1, x2, y2, x3, y3, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    cubicBezierCuts(setPixel, x0, y0, x1, y1, x2, y2, x3, y3, BezierAASegmentOp{ color });
+}
+
+}
@@ -0,0 +1,114 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+
+namespace OffScreenBitmapDraw
+{
+
+/* thick Bezier curves - not Zingl's plotQuadRationalBezierWidthSeg(), which steps
+   along the curve: the curve is sampled into stroke_path_ within 0.1 pixel, up to
+   1024 pieces, and stroked by strokePolyline(). the coverage of a pixel is (wd + 1) / 2
+   minus its distance to the nearest piece, as for plotPolylineWidth(): each pixel is
+   set once, also where the pieces overlap at bends, and the ends are round */
+
+template <class BitmapImageType>
+void zingl_image_drawer<BitmapImageType>::flattenQuadRationalBezier(
+    const int x0, const int y0, const int x1, const int y1, const int x2, const int y2, const double w)
+{
+    /* a chord of a quadratic over dt differs by |P0 - 2 P1 + P2| dt^2 / 4 */
+    const double ax = x0-2.0*x1+x2, ay = y0-2.0*y1+y2;
+    const double a = std::sqrt(ax*ax+ay*ay) * std::max(w, 1.0);
+    const int n = std::max(1, std::min(1024, int(std::ceil(std::sqrt(a * 2.5)))));
+    stroke_path_.resize(size_t(n) + 1);
+    for (int i = 0; i <= n; ++i)
+    {
+        const double t = double(i) / n, u = 1.0 - t;
+        const double b0 = u*u, b1 = 2.0*u*t*w, b2 = t*t, s = 1.0 / (b0 + b1 + b2);
+        stroke_path_[i] = PointF(float((b0*x0 + b1*x1 + b2*x2) * s), float((b0*y0 + b1*y1 + b2*y2) * s));
+    }
+}
+
+template <class BitmapImageType>
+void zingl_image_drawer<BitmapImageType>::flattenCubicBezier(
+    const int x0, const int y0, const int x1, const int y1,
+    const int x2, const int y2, const int x3, const int y3)
+{
+    /* |B''| <= 6 max(|P0 - 2 P1 + P2|, |P1 - 2 P2 + P3|) and a chord differs by |B''| dt^2 / 8 */
+    const double ax = x0-2.0*x1+x2, ay = y0-2.0*y1+y2, bx = x1-2.0*x2+x3, by = y1-2.0*y2+y3;
+    const double a = std::sqrt(std::max(ax*ax+ay*ay, bx*bx+by*by));
+    const int n = std::max(1, std::min(1024, int(std::ceil(std::sqrt(a * 7.5)))));
+    stroke_path_.resize(size_t(n) + 1);
+    for (int i = 0; i <= n; ++i)
+    {
+        const double t = double(i) / n, u = 1.0 - t;
+        const double b0 = u*u*u, b1 = 3.0*u*u*t, b2 = 3.0*u*t*t, b3 = t*t*t;
+        stroke_path_[i] = PointF(float(b0*x0 + b1*x1 + b2*x2 + b3*x3), float(b0*y0 + b1*y1 + b2*y2 + b3*y3));
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::strokePath(const float wd, const pixel_t color)
+{
+    strokePolyline<Setter>(stroke_path_.data(), stroke_path_.size(), wd, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadBezierWidth(
+    int x0, int y0, int x1, int y1, int x2, int y2, float wd, const pixel_t color)
+{
+    plotQuadRationalBezierWidth<Setter>(x0, y0, x1, y1, x2, y2, 1.0F, wd, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotQuadRationalBezierWidth(
+    int x0, int y0, int x1, int y1, int x2, int y2, float w, float wd, const pixel_t color)
+{
+    const int m = int(wd) + 1;
+    if (!(w >= 0.0F) || !(wd > 0.0F)
+        || outsideImage(std::min(x0, std::min(x1, x2)) - m, std::min(y0, std::min(y1, y2)) - m,
+                        std::max(x0, std::max(x1, x2)) + m, std::max(y0, std::max(y1, y2)) + m))
+        return;
+    flattenQuadRationalBezier(x0, y0, x1, y1, x2, y2, w);
+    strokePath<Setter>(wd, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotCubicBezierWidth(
+    int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, float wd, const pixel_t color)
+{
+    const int m = int(wd) + 1;
+    if (!(wd > 0.0F)
+        || outsideImage(std::min(std::min(x0, x1), std::min(x2, x3)) - m, std::min(std::min(y0, y1), std::min(y2, y3)) - m,
+                        std::max(std::max(x0, x1), std::max(x2, x3)) + m, std::max(std::max(y0, y1), std::max(y2, y3)) + m))
+        return;
+    flattenCubicBezier(x0, y0, x1, y1, x2, y2, x3, y3);
+    strokePath<Setter>(wd, color);
+}
+
+}
@@ -30,6 +30,17 @@ template <class Setter>
 void zingl_image_drawer<BitmapImageType>::plotCircle(
     const int xm, const int ym, const int radius, const pixel_t color)
 {
+    if (!insideImage(xm - std::abs(radius), ym - std::abs(radius), xm + std::abs(radius), ym + std::abs(radius)))
+    {
+        if (radius > 0 && radius <= 1000000000)
+        {
+            const zingl_detail::circle_quadrant_path path{ radius };
+            return plotQuadrantsClipped<NoClipOf<Setter> >(xm, ym, path, radius, true, color);
+        }
+    }
+    else if (!std::is_same<Setter, NoClipOf<Setter> >::value)
+        return plotCircle<NoClipOf<Setter> >(xm, ym, radius, color);
+
     int r = radius;
     int x = -r, y = 0, err = 2-2*r;                /* bottom left to top right */
     const int row_inc = int(image_.row_increment());
@@ -37,7 +48,7 @@ void zingl_image_drawer<BitmapImageType>::plotCircle(
     pixel_t * row_lower = image_.row(ym - y);
     pixel_t * row_left  = image_.row(ym - x);
     pixel_t * row_right = image_.row(ym + x);
-    Setter setPixel{image_};
+    SetterOf<Setter> setPixel{image_, setter_context_};
 
     do {
         setPixel(xm-x, ym+y, &row_upper[xm-x], color);   /*   I. Quadrant +x +y */
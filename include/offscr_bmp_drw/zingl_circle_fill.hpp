@@ -30,6 +30,9 @@ template <class Setter>
 void zingl_image_drawer<BitmapImageType>::fillCircle(
     const int xm, const int ym, const int rx, const pixel_t color)
 {
+    if (fullyVisible<Setter>(xm - std::abs(rx), ym - std::abs(rx), xm + std::abs(rx), ym + std::abs(rx)))
+        return fillCircle<NoClipOf<Setter> >(xm, ym, rx, color);
+
     // code is copy of zingl_image_drawer<BitmapImageType>::fillOptimizedEllipse()
     //   - using ry == rx in hope, that less registers/vars might optimize better
     int  x = -rx, y = 0;          /* II. quadrant from bottom left to top right */
@@ -38,7 +41,7 @@ void zingl_image_drawer<BitmapImageType>::fillCircle(
     const int row_inc = int(image_.row_increment());
     pixel_t * row_upper = image_.row(ym + y);   // ym + y
     pixel_t * row_lower = image_.row(ym - y);   // ym - y
-    Setter setPixel{image_};
+    SetterOf<Setter> setPixel{image_, setter_context_};
     int xL = xm +1, xR = xm;
 
     do {
@@ -30,12 +30,23 @@ template <class Setter>
 void zingl_image_drawer<BitmapImageType>::plotEllipse(
     const int xm, const int ym, const int rx, const int ry, const pixel_t color)
 {
+    if (!insideImage(xm - std::abs(rx), ym - std::abs(ry), xm + std::abs(rx), ym + std::abs(ry)))
+    {
+        if (rx > 0 && ry > 0 && (long long)rx * ry <= 1000000000LL)
+        {
+            const zingl_detail::ellipse_quadrant_path path{ rx, ry };
+            return plotQuadrantsClipped<NoClipOf<Setter> >(xm, ym, path, rx, false, color);
+        }
+    }
+    else if (!std::is_same<Setter, NoClipOf<Setter> >::value)
+        return plotEllipse<NoClipOf<Setter> >(xm, ym, rx, ry, color);
+
     int x = -rx, y = 0;           /* II. quadrant from bottom left to top right */
     long e2 = (long)ry*ry, err = (long)x*(2*e2+x)+e2;         /* error of 1.step */
     const int row_inc = int(image_.row_increment());
     pixel_t * row_upper = image_.row(ym + y);
     pixel_t * row_lower = image_.row(ym - y);
-    Setter setPixel{image_};
+    SetterOf<Setter> setPixel{image_, setter_context_};
 
     do {
         setPixel(xm-x, ym+y, &row_upper[xm-x], color);       /*   I. Quadrant */
@@ -0,0 +1,250 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+
+namespace OffScreenBitmapDraw
+{
+
+/* elliptic arcs and pie wedges: a part of up to 90 degrees of the unit circle is exactly
+   the rational quadratic Bezier curve with the crossing of the tangents at its ends as
+   control point and the weight cos(sweep / 2). scaled by the radii and rotated, the same
+   holds for the ellipse - with the control points rounded to pixels */
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::ellipseArc(
+    Setter& setPixel, const int xm, const int ym, const int a, const int b, const double angle,
+    const double start, const double sweep, const pixel_t color, const bool from_end)
+{
+    const int n = std::max(1, std::min(4, int(std::ceil(std::fabs(sweep) / (zingl_detail::pi / 2.0) - 1E-9))));
+    const double dt = sweep / n, w = std::cos(dt / 2.0);
+    int x[9], y[9];                               /* end points and control points in turn */
+    for (int i = 0; i < 2*n; ++i)
+        arcPoint(xm, ym, a, b, angle, start + i * dt / 2.0, (i & 1) ? 1.0 / w : 1.0, x[i], y[i]);
+    arcPoint(xm, ym, a, b, angle, start + sweep, 1.0, x[2*n], y[2*n]);
+    const BezierSegmentOp segment{ color };
+    for (int k = 0; k < n; ++k)
+    {
+        if (from_end)              /* towards the start point, which is left out */
+        {
+            const int j = 2*(n-k);
+            quadRationalBezierCuts(setPixel, x[j], y[j], x[j-1], y[j-1], x[j-2], y[j-2], w, segment, false);
+        }
+        else
+        {
+            const int j = 2*k;
+            quadRationalBezierCuts(setPixel, x[j], y[j], x[j+1], y[j+1], x[j+2], y[j+2], w, segment, k == n-1);
+        }
+    }
+}
+
+template <class BitmapImageType>
+void zingl_image_drawer<BitmapImageType>::arcPoint(
+    const int xm, const int ym, const int a, const int b, const double angle, const double t, const double r,
+    int& x, int& y)
+{
+    const double u = a * std::cos(t) * r, v = b * std::sin(t) * r;
+    const double ca = std::cos(angle), sa = std::sin(angle);
+    x = xm + int(std::floor(u*ca - v*sa + 0.5));
+    y = ym + int(std::floor(u*sa + v*ca + 0.5));
+}
+
+template <class BitmapImageType>
+bool zingl_image_drawer<BitmapImageType>::arcSweep(const float start, const float end, double& sweep)
+{
+    sweep = double(end) - double(start);
+    if (!(sweep < 2.0 * zingl_detail::pi))
+        return false;                                         /* the whole ellipse, or NaN */
+    sweep = std::fmod(sweep, 2.0 * zingl_detail::pi);
+    if (sweep < 0.0)
+        sweep += 2.0 * zingl_detail::pi;
+    return true;
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotEllipseArc(
+    const int xm, const int ym, int a, int b, const float angle, const float start, const float end,
+    const pixel_t color)
+{
+    a = std::abs(a); b = std::abs(b);
+    double sweep;
+    if (!arcSweep(start, end, sweep))
+    {
+        if (sweep == sweep)
+            plotRotatedEllipse<Setter>(xm, ym, a, b, angle, color);
+        return;
+    }
+    const int r = std::max(a, b) + 2;                 /* rounded control points included */
+    if (outsideImage(xm-r, ym-r, xm+r, ym+r))
+        return;
+    if (fullyVisible<Setter>(xm-r, ym-r, xm+r, ym+r))
+        return plotEllipseArc<NoClipOf<Setter> >(xm, ym, a, b, angle, start, end, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    ellipseArc(setPixel, xm, ym, a, b, angle, start, sweep, color, false);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotEllipseArc(
+    const Point ptCenter, const Point radius, const float angle, const float start, const float end,
+    const pixel_t color)
+{
+    plotEllipseArc<Setter>(ptCenter.first, ptCenter.second, radius.first, radius.second, angle, start, end, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotEllipsePie(
+    const int xm, const int ym, int a, int b, const float angle, const float start, const float end,
+    const pixel_t color)
+{
+    a = std::abs(a); b = std::abs(b);
+    double sweep;
+    if (!arcSweep(start, end, sweep))
+    {
+        if (sweep == sweep)
+            plotRotatedEllipse<Setter>(xm, ym, a, b, angle, color);
+        return;
+    }
+    const int r = std::max(a, b) + 2;
+    if (outsideImage(xm-r, ym-r, xm+r, ym+r))
+        return;
+    if (fullyVisible<Setter>(xm-r, ym-r, xm+r, ym+r))
+        return plotEllipsePie<NoClipOf<Setter> >(xm, ym, a, b, angle, start, end, color);
+
+    int xs, ys, xe, ye;
+    arcPoint(xm, ym, a, b, angle, start, 1.0, xs, ys);
+    arcPoint(xm, ym, a, b, angle, start + sweep, 1.0, xe, ye);
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    /* closed loop, each pixel once: the arc from its end, the radius to the start point
+       from the center, the radius to the center from the end point */
+    ellipseArc(setPixel, xm, ym, a, b, angle, start, sweep, color, true);
+    lineSegment(setPixel, signedRow(ym), xm, ym, xs, ys, color, false);
+    lineSegment(setPixel, signedRow(ye), xe, ye, xm, ym, color, false);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotEllipsePie(
+    const Point ptCenter, const Point radius, const float angle, const float start, const float end,
+    const pixel_t color)
+{
+    plotEllipsePie<Setter>(ptCenter.first, ptCenter.second, radius.first, radius.second, angle, start, end, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillEllipsePie(
+    const int xm, const int ym, int a, int b, const float angle, const float start, const float end,
+    const pixel_t color)
+{
+    a = std::abs(a); b = std::abs(b);
+    double sweep;
+    if (!arcSweep(start, end, sweep))
+    {
+        if (sweep == sweep)
+            fillRotatedEllipse<Setter>(xm, ym, a, b, angle, color);
+        return;
+    }
+    int ra = a, rb = b;
+    const long zd = rotatedEllipseRect(ra, rb, angle);
+    if (outsideImage(xm-ra, ym-rb, xm+ra, ym+rb))
+        return;
+    if (fullyVisible<Setter>(xm-ra, ym-rb, xm+ra, ym+rb))
+        return fillEllipsePie<NoClipOf<Setter> >(xm, ym, a, b, angle, start, end, color);
+
+    int xs, ys, xe, ye;
+    arcPoint(xm, ym, a, b, angle, start, 1.0, xs, ys);
+    arcPoint(xm, ym, a, b, angle, start + sweep, 1.0, xe, ye);
+    const long long sx = xs-xm, sy = ys-ym, ex = xe-xm, ey = ye-ym;
+    const bool convex = sweep <= zingl_detail::pi;
+
+    /* spans of the ellipse, limited by the half planes left of the start ray and right of
+       the end ray: both for up to 180 degrees, else either */
+    const int ya = std::max(ym-rb, 0), yb = std::min(ym+rb, int(image_.height()) - 1);
+    rotatedEllipseSpans(xm-ra, ym-rb, xm+ra, ym+rb, zd, ya, yb);
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    const long long none = std::numeric_limits<int>::max();
+    for (int y = ya; y <= yb; ++y)
+    {
+        const long long xl = span_x0_[size_t(y - ya)], xr = span_x1_[size_t(y - ya)];
+        if (xl > xr)
+            continue;
+        const long long dy = y - ym;
+        /* dx of the half planes [s0 .. s1] and [e0 .. e1] - empty as [none .. -none] */
+        long long s0 = -none, s1 = none, e0 = -none, e1 = none;
+        if (sy > 0)                                               /* sx*dy - sy*dx >= 0 */
+            s1 = zingl_detail::floor_div(sx*dy, sy);
+        else if (sy < 0)
+            s0 = zingl_detail::ceil_div(-sx*dy, -sy);
+        else if (sx*dy < 0)
+            s0 = none, s1 = -none;
+        if (ey > 0)                                               /* dx*ey - dy*ex >= 0 */
+            e0 = zingl_detail::ceil_div(dy*ex, ey);
+        else if (ey < 0)
+            e1 = zingl_detail::floor_div(-dy*ex, -ey);
+        else if (dy*ex > 0)
+            e0 = none, e1 = -none;
+        long long span[4];
+        int n = 0;
+        if (convex)
+        {
+            span[0] = std::max(xl, xm + std::max(s0, e0));
+            span[1] = std::min(xr, xm + std::min(s1, e1));
+            n = 2;
+        }
+        else
+        {
+            if (e0 < s0)                             /* the left one first, empty last */
+                std::swap(s0, e0), std::swap(s1, e1);
+            if (e0 <= e1 && e0 <= s1 + 1)                         /* overlapping: merge */
+                s1 = std::max(s1, e1), e0 = none, e1 = -none;
+            span[n++] = std::max(xl, xm + s0);
+            span[n++] = std::min(xr, xm + s1);
+            span[n++] = std::max(xl, xm + e0);
+            span[n++] = std::min(xr, xm + e1);
+        }
+        pixel_t * row = image_.row(y);
+        for (int i = 0; i < n; i += 2)
+            if (span[i] <= span[i+1])
+            {
+                const int x0 = int(span[i]), x1 = int(span[i+1]);
+                setPixel.hLine(x0, x1, y, &row[x0], &row[x1], color);
+            }
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillEllipsePie(
+    const Point ptCenter, const Point radius, const float angle, const float start, const float end,
+    const pixel_t color)
+{
+    fillEllipsePie<Setter>(ptCenter.first, ptCenter.second, radius.first, radius.second, angle, start, end, color);
+}
+
+}
@@ -30,13 +30,16 @@ template <class Setter>
 void zingl_image_drawer<BitmapImageType>::fillOptimizedEllipse(
     const int xm, const int ym, const int rx, const int ry, const pixel_t color)
 {
+    if (fullyVisible<Setter>(xm - std::abs(rx), ym - std::abs(ry), xm + std::abs(rx), ym + std::abs(ry)))
+        return fillOptimizedEllipse<NoClipOf<Setter> >(xm, ym, rx, ry, color);
+
     int  x = -rx, y = 0;          /* II. quadrant from bottom left to top right */
     long e2 = ry, dx = (1+2*x)*e2*e2;                       /* error increment  */
     long dy = x*long(x), err = dx+dy;                       /* error of 1.step */
     const int row_inc = int(image_.row_increment());
     pixel_t * row_upper = image_.row(ym + y);   // ym + y
     pixel_t * row_lower = image_.row(ym - y);   // ym - y
-    Setter setPixel{image_};
+    SetterOf<Setter> setPixel{image_, setter_context_};
     int xL = xm +1, xR = xm;
 
     do {
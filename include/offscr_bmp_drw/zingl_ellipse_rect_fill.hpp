@@ -31,6 +31,9 @@ template <class Setter>
 void zingl_image_drawer<BitmapImageType>::fillEllipseRect(
     int x0, int y0, int x1, int y1, const pixel_t color)
 {                              /* rectangular parameter enclosing the ellipse */
+    if (fullyVisible<Setter>(std::min(x0, x1) - 1, std::min(y0, y1) - 1, std::max(x0, x1) + 1, std::max(y0, y1) + 1))
+        return fillEllipseRect<NoClipOf<Setter> >(x0, y0, x1, y1, color);
+
     long a = std::abs(x1-x0), b = std::abs(y1-y0), b1 = b&1;       /* diameter */
     double dx = 4*(1.0-a)*b*b, dy = 4*(b1+1)*a*a;           /* error increment */
     double err = dx+dy+b1*a*a, e2;                          /* error of 1.step */
@@ -44,7 +47,7 @@ void zingl_image_drawer<BitmapImageType>::fillEllipseRect(
     const int row_inc = int(image_.row_increment());
     pixel_t * row0 = image_.row(y0);
     pixel_t * row1 = image_.row(y1);
-    Setter setPixel{image_};
+    SetterOf<Setter> setPixel{image_, setter_context_};
     int xL = xm +1, xR = xm;
     int yL = -1;
 
@@ -0,0 +1,158 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+
+namespace OffScreenBitmapDraw
+{
+
+/* rotated ellipses after Zingl: the rectangle enclosing the ellipse is cut at the 4 points,
+   where the ellipse touches it. the 4 arcs between are rational quadratic Bezier segments
+   with the corners as control points - each with the gradient of constant sign.
+   unlike Zingl, zd == 0 isn't passed to plotEllipseRect(): the filled ellipses use the
+   rows of the same outline, which sets each pixel once */
+
+template <class BitmapImageType>
+long zingl_image_drawer<BitmapImageType>::rotatedEllipseRect(int& a, int& b, const double angle)
+{
+    double xd = double(a)*a, yd = double(b)*b;
+    const double s = std::sin(angle);
+    double zd = (xd-yd)*s;                                        /* ellipse rotation */
+    xd = std::sqrt(xd-zd*s); yd = std::sqrt(yd+zd*s);       /* surrounding rectangle */
+    a = int(xd+0.5); b = int(yd+0.5);
+    if (xd*yd == 0.0)
+        return 0;
+    zd = zd*a*b/(xd*yd);                                          /* scale to integer */
+    return long(4*zd*std::cos(angle));
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::rotatedEllipseSegments(
+    Setter& setPixel, const int x0, const int y0, const int x1, const int y1, const long zd, const pixel_t color)
+{
+    const double xy = double(x1-x0)*(y1-y0);
+    const double w = xy != 0.0 ? (xy-zd)/(xy+xy) : 0.5;                 /* squared weight of P1 */
+    const int xd = int(std::floor((x1-x0)*w+0.5)), yd = int(std::floor((y1-y0)*w+0.5));  /* snap to int */
+    /* closed loop: each segment leaves out its end pixel */
+    quadRationalBezierSegment(setPixel, x0, y0+yd, x0, y0, x0+xd, y0, 1.0-w, color, true, false);
+    quadRationalBezierSegment(setPixel, x0+xd, y0, x1, y0, x1, y1-yd, w, color, true, false);
+    quadRationalBezierSegment(setPixel, x1, y1-yd, x1, y1, x1-xd, y1, 1.0-w, color, true, false);
+    quadRationalBezierSegment(setPixel, x1-xd, y1, x0, y1, x0, y0+yd, w, color, true, false);
+}
+
+template <class BitmapImageType>
+void zingl_image_drawer<BitmapImageType>::rotatedEllipseSpans(
+    const int x0, const int y0, const int x1, const int y1, const long zd, const int ya, const int yb)
+{
+    span_x0_.assign(size_t(yb - ya + 1), std::numeric_limits<int>::max());
+    span_x1_.assign(size_t(yb - ya + 1), std::numeric_limits<int>::min());
+    SpanExtents extents(span_x0_, span_x1_, ya);
+    rotatedEllipseSegments(extents, x0, y0, x1, y1, zd, pixel_t());
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotRotatedEllipse(
+    const int xm, const int ym, int a, int b, const float angle, const pixel_t color)
+{
+    a = std::abs(a); b = std::abs(b);
+    const long zd = rotatedEllipseRect(a, b, angle);
+    plotRotatedEllipseRect<Setter>(xm-a, ym-b, xm+a, ym+b, zd, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotRotatedEllipse(
+    const Point ptCenter, const Point radius, const float angle, const pixel_t color)
+{
+    plotRotatedEllipse<Setter>(ptCenter.first, ptCenter.second, radius.first, radius.second, angle, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotRotatedEllipseRect(
+    int x0, int y0, int x1, int y1, long zd, const pixel_t color)
+{
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+    const double xy = double(x1-x0)*(y1-y0);
+    zd = long(std::max(-xy, std::min(xy, double(zd))));       /* limit angle to |zd| <= xd*yd */
+    if (outsideImage(x0, y0, x1, y1))
+        return;
+    if (fullyVisible<Setter>(x0, y0, x1, y1))
+        return plotRotatedEllipseRect<NoClipOf<Setter> >(x0, y0, x1, y1, zd, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    rotatedEllipseSegments(setPixel, x0, y0, x1, y1, zd, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillRotatedEllipse(
+    const int xm, const int ym, int a, int b, const float angle, const pixel_t color)
+{
+    a = std::abs(a); b = std::abs(b);
+    const long zd = rotatedEllipseRect(a, b, angle);
+    fillRotatedEllipseRect<Setter>(xm-a, ym-b, xm+a, ym+b, zd, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillRotatedEllipse(
+    const Point ptCenter, const Point radius, const float angle, const pixel_t color)
+{
+    fillRotatedEllipse<Setter>(ptCenter.first, ptCenter.second, radius.first, radius.second, angle, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillRotatedEllipseRect(
+    int x0, int y0, int x1, int y1, long zd, const pixel_t color)
+{
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+    const double xy = double(x1-x0)*(y1-y0);
+    zd = long(std::max(-xy, std::min(xy, double(zd))));
+    if (outsideImage(x0, y0, x1, y1))
+        return;
+    if (fullyVisible<Setter>(x0, y0, x1, y1))
+        return fillRotatedEllipseRect<NoClipOf<Setter> >(x0, y0, x1, y1, zd, color);
+
+    /* the outline pixels of each visible row - the ellipse is convex: one span per row */
+    const int ya = std::max(y0, 0), yb = std::min(y1, int(image_.height()) - 1);
+    rotatedEllipseSpans(x0, y0, x1, y1, zd, ya, yb);
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    for (int y = ya; y <= yb; ++y)
+    {
+        const int xl = span_x0_[size_t(y - ya)], xr = span_x1_[size_t(y - ya)];
+        if (xl <= xr)
+        {
+            pixel_t * row = image_.row(y);
+            setPixel.hLine(xl, xr, y, &row[xl], &row[xr], color);
+        }
+    }
+}
+
+}
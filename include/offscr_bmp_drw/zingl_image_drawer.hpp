@@ -24,7 +24,11 @@
 
 #include <utility>
 #include <algorithm>
+#include <cstddef>
 #include <cmath>
+#include <type_traits>
+#include <vector>
+#include <limits>
 
 
 namespace OffScreenBitmapDraw
@@ -41,6 +45,152 @@ namespace OffScreenBitmapDraw
  * above is the origin. the code got adapted/refactored ..
 */
 
+// which points are inside a polygon, whose edges cross each other or which has holes
+enum polygon_fill_rule {
+    fill_even_odd = 0,      // odd number of edge crossings to the left
+    fill_nonzero  = 1       // non-zero sum of the edge directions (winding number)
+};
+
+// symbols of marker_stamp - see zingl_marker.hpp
+enum marker_shape {
+    marker_disc   = 0,
+    marker_circle = 1,
+    marker_square = 2,
+    marker_cross  = 3
+};
+
+struct marker_stamp;
+
+namespace zingl_detail
+{
+
+template <class T>
+struct void_type { typedef void type; };
+
+// Setter::NoClip, if the setter declares an unchecked variant - else the Setter itself.
+// only for the class declaring it, together with Setter::Clipped as itself: a setter
+// derived from e.g. PixelSetterClippedUsingXY inherits both, and keeps its own operator()
+template <class Setter, class = void>
+struct no_clip_setter { typedef Setter type; };
+
+template <class Setter>
+struct no_clip_setter<Setter, typename std::enable_if<std::is_same<typename Setter::Clipped, Setter>::value,
+                                                      typename void_type<typename Setter::NoClip>::type>::type>
+{
+    typedef typename Setter::NoClip type;
+};
+
+// address identifying the type T - without RTTI
+template <class T>
+struct type_id { static const char id; };
+
+template <class T>
+const char type_id<T>::id = 0;
+
+// optional context of the drawer for its setters: a pointer with the type_id of its type
+struct setter_context
+{
+    const void* ptr;
+    const char* id;
+};
+
+// the Setter of the drawing functions, constructed from the image. a Setter declaring
+// Setter::context_type is constructed as Setter(image, context) instead - with the
+// context of the drawer, or nullptr when the drawer has none of that type
+template <class Setter, class BitmapImageType, class = void>
+struct context_setter : Setter
+{
+    context_setter(BitmapImageType& image, const setter_context& context) : Setter(image) { (void)context; }
+};
+
+template <class Setter, class BitmapImageType>
+struct context_setter<Setter, BitmapImageType, typename void_type<typename Setter::context_type>::type> : Setter
+{
+    typedef typename Setter::context_type context_type;
+
+    context_setter(BitmapImageType& image, const setter_context& context)
+        : Setter(image, context.id == &type_id<context_type>::id ? static_cast<const context_type*>(context.ptr) : nullptr)
+    { }
+};
+
+// integer division rounding towards -infinity / +infinity: b > 0
+inline long long floor_div(const long long a, const long long b) { return a >= 0 ? a / b : -((b - 1 - a) / b); }
+inline long long ceil_div(const long long a, const long long b) { return -floor_div(-a, b); }
+
+const double pi = 3.14159265358979323846;
+
+// coverage of anti-aliased pixels is fixed point in [0 .. 255]: 255 == fully covered
+
+// color weighted by coverage
+template <class PixelType>
+inline PixelType scale_coverage(PixelType c, const unsigned cov)
+{
+    *red(c)   = typename PixelType::component((*red(c)   * cov + 127U) / 255U);
+    *green(c) = typename PixelType::component((*green(c) * cov + 127U) / 255U);
+    *blue(c)  = typename PixelType::component((*blue(c)  * cov + 127U) / 255U);
+    return c;
+}
+
+inline float scale_coverage(const float c, const unsigned cov) { return c * (float(cov) * (1.0F / 255.0F)); }
+inline double scale_coverage(const double c, const unsigned cov) { return c * (double(cov) * (1.0 / 255.0)); }
+
+// blend color over dst by coverage
+inline int blend_component(const int dst, const int c, const int cov)
+{
+    const int d = (c - dst) * cov;
+    return dst + (d + (d < 0 ? -127 : 127)) / 255;     // rounded symmetric: cov 255 gives c
+}
+
+template <class PixelType>
+inline void blend_coverage(PixelType& dst, const PixelType c, const unsigned cov)
+{
+    typedef typename PixelType::component component;
+    *red(dst)   = component(blend_component(*red(dst),   *red(c),   int(cov)));
+    *green(dst) = component(blend_component(*green(dst), *green(c), int(cov)));
+    *blue(dst)  = component(blend_component(*blue(dst),  *blue(c),  int(cov)));
+}
+
+inline void blend_coverage(float& dst, const float c, const unsigned cov) { dst += (c - dst) * (float(cov) * (1.0F / 255.0F)); }
+inline void blend_coverage(double& dst, const double c, const unsigned cov) { dst += (c - dst) * (double(cov) * (1.0 / 255.0)); }
+
+// coverage of the pixel with the error e of an implicit equation, whose gradient has
+// the length ed: 1 minus the distance - none from 1 pixel on
+inline unsigned distance_coverage(const double e, const double ed)
+{
+    const double d = 255.0 * std::fabs(e) / ed;
+    return d < 255.0 ? unsigned(255.5 - d) : 0U;
+}
+
+// true, when the Setter has coverage() for anti-aliased pixels
+template <class Setter, class PixelType, class = void>
+struct has_coverage : std::false_type { };
+
+template <class Setter, class PixelType>
+struct has_coverage<Setter, PixelType, typename void_type<decltype(std::declval<Setter&>().coverage(
+    0, 0, static_cast<PixelType*>(nullptr), std::declval<PixelType>(), 0U))>::type> : std::true_type { };
+
+template <class Setter, class PixelType>
+inline void set_coverage(Setter& setPixel, int x, int y, PixelType* pos, PixelType value, unsigned cov, std::true_type)
+{
+    setPixel.coverage(x, y, pos, value, cov);
+}
+
+template <class Setter, class PixelType>
+inline void set_coverage(Setter& setPixel, int x, int y, PixelType* pos, PixelType value, unsigned cov, std::false_type)
+{
+    setPixel(x, y, pos, scale_coverage(value, cov));
+}
+
+// anti-aliased pixel: Setter::coverage() - or Setter::operator() with the color
+// scaled by coverage, for setters without coverage()
+template <class Setter, class PixelType>
+inline void set_coverage(Setter& setPixel, int x, int y, PixelType* pos, PixelType value, unsigned cov)
+{
+    set_coverage(setPixel, x, y, pos, value, cov, has_coverage<Setter, PixelType>());
+}
+
+}
+
 template <class BitmapImageType = bitmap_image_rgb<> >
 class zingl_image_drawer
 {
@@ -48,6 +198,7 @@ public:
     typedef typename BitmapImageType::pixel_t pixel_t;
     //typedef typename BitmapImageType::Point Point;  // x, y
     typedef std::pair<int, int> Point;  // x, y
+    typedef std::pair<float, float> PointF;  // x, y - sub-pixel position for anti-aliasing
 
     struct PixelSetterNoClipUsingPtr
     {
@@ -79,6 +230,13 @@ public:
                 *pos1 = value;
         }
 
+        // anti-aliased pixel: the color scaled by coverage
+        inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+        {
+            (void)x; (void)y;
+            *pos = zingl_detail::scale_coverage(value, cov);
+        }
+
     };
 
     struct PixelAdderNoClipUsingPtr
@@ -99,8 +257,7 @@ public:
         inline void hLine(int x0, int x1, int y, pixel_t* pos0, pixel_t* pos1, pixel_t value)
         {
             (void)x0; (void)x1; (void)y;
-            for (pixel_t *p = pos0; p <= pos1; ++p)
-                *p += value;
+            add_to_values(pos0, pos1 + 1, value);
         }
 
         inline void hLineCorners(int x0, int x1, int y, pixel_t* pos0, pixel_t* pos1, pixel_t value)
@@ -111,10 +268,21 @@ public:
                 *pos1 += value;
         }
 
+        // anti-aliased pixel: adds the color weighted by coverage
+        inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+        {
+            (void)x; (void)y;
+            *pos += zingl_detail::scale_coverage(value, cov);
+        }
+
     };
 
     struct PixelSetterClippedUsingXY
     {
+        // used by the drawing functions, when the whole primitive is inside the image
+        typedef PixelSetterNoClipUsingPtr NoClip;
+        typedef PixelSetterClippedUsingXY Clipped;
+
         PixelSetterClippedUsingXY(BitmapImageType &image)
             : w(image.width()), h(image.height()), image_(image) { }
         // prevent copying
@@ -133,7 +301,7 @@ public:
         inline void hLine(int x0, int x1, int y, pixel_t* pos0, pixel_t* pos1, pixel_t value)
         {
             (void)pos0; (void)pos1;
-            if ( y >= 0 && y < h && ( x0 >= 0 || x1 < w ) )
+            if ( y >= 0 && y < h && x1 >= 0 && x0 < w )
             {
                 if ( x0 < 0 ) x0 = 0;
                 if ( x1 >= w ) x1 = w - 1;
@@ -156,13 +324,24 @@ public:
             }
         }
 
-    private:
+        inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+        {
+            (void)pos;
+            if ( x >= 0 && x < w && y >= 0 && y < h )
+                image_.pixel(x, y) = zingl_detail::scale_coverage(value, cov);
+        }
+
+    protected:
         const int w, h;
         BitmapImageType &image_;
     };
 
     struct PixelAdderClippedUsingXY
     {
+        // used by the drawing functions, when the whole primitive is inside the image
+        typedef PixelAdderNoClipUsingPtr NoClip;
+        typedef PixelAdderClippedUsingXY Clipped;
+
         PixelAdderClippedUsingXY(BitmapImageType &image)
             : w(image.width()), h(image.height()), image_(image) { }
         // prevent copying
@@ -181,13 +360,12 @@ public:
         inline void hLine(int x0, int x1, int y, pixel_t* pos0, pixel_t* pos1, pixel_t value)
         {
             (void)pos0; (void)pos1;
-            if ( y >= 0 && y < h && ( x0 >= 0 || x1 < w ) )
+            if ( y >= 0 && y < h && x1 >= 0 && x0 < w )
             {
                 if ( x0 < 0 ) x0 = 0;
                 if ( x1 >= w ) x1 = w - 1;
                 pixel_t *row = image_.row(y);
-                for (int x = x0; x <= x1; ++x)
-                    row[x] += value;
+                add_to_values(row + x0, row + x1 + 1, value);
             }
         }
 
@@ -204,27 +382,115 @@ public:
             }
         }
 
+        inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+        {
+            (void)pos;
+            if ( x >= 0 && x < w && y >= 0 && y < h )
+                image_.pixel(x, y) += zingl_detail::scale_coverage(value, cov);
+        }
+
     private:
         const int w, h;
         BitmapImageType &image_;
     };
 
+    // sets pixels like PixelSetter, but blends anti-aliased pixels over the image
+    struct PixelBlenderNoClipUsingPtr : PixelSetterNoClipUsingPtr
+    {
+        PixelBlenderNoClipUsingPtr(BitmapImageType &image) : PixelSetterNoClipUsingPtr(image) { }
+
+        inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+        {
+            (void)x; (void)y;
+            zingl_detail::blend_coverage(*pos, value, cov);
+        }
+    };
+
+    struct PixelBlenderClippedUsingXY : PixelSetterClippedUsingXY
+    {
+        typedef PixelBlenderNoClipUsingPtr NoClip;
+        typedef PixelBlenderClippedUsingXY Clipped;
+
+        PixelBlenderClippedUsingXY(BitmapImageType &image) : PixelSetterClippedUsingXY(image) { }
+
+        inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+        {
+            (void)pos;
+            if ( x >= 0 && x < this->w && y >= 0 && y < this->h )
+                zingl_detail::blend_coverage(this->image_.pixel(x, y), value, cov);
+        }
+    };
+
 
     // using PixelSetter = PixelSetterNoClipUsingPtr;
     // using PixelAdder = PixelAdderNoClipUsingPtr;
     using PixelSetter = PixelSetterClippedUsingXY;
     using PixelAdder = PixelAdderClippedUsingXY;
+    using PixelBlender = PixelBlenderClippedUsingXY;
 
 
+    // unchecked variant of Setter - see no_clip_setter
+    template <class Setter>
+    using NoClipOf = typename zingl_detail::no_clip_setter<Setter>::type;
+
+    // Setter as constructed by the drawing functions - see setSetterContext()
+    template <class Setter>
+    using SetterOf = zingl_detail::context_setter<Setter, BitmapImageType>;
+
     zingl_image_drawer(BitmapImageType& image)
-        : image_(image)
+        : image_(image), setter_context_{nullptr, nullptr}
+    {}
+
+    template <class Context>
+    zingl_image_drawer(BitmapImageType& image, const Context* context)
+        : image_(image), setter_context_{context, &zingl_detail::type_id<Context>::id}
     {}
 
+    // context for the setters declaring Setter::context_type: the drawing functions construct
+    // them as Setter(image, context) - e.g. pattern_setter with its pixel_pattern.
+    // the setters get nullptr for no context or one of another type
+    template <class Context>
+    void setSetterContext(const Context* context)
+    {
+        setter_context_.ptr = context;
+        setter_context_.id = &zingl_detail::type_id<Context>::id;
+    }
+
+    void setSetterContext(std::nullptr_t)
+    {
+        setter_context_.ptr = nullptr;
+        setter_context_.id = nullptr;
+    }
+
+    // true, when Setter has an unchecked NoClip variant and the bounding box
+    // [x0 .. x1] x [y0 .. y1] is completely inside the image.
+    // the drawing functions check their bounding box once and then dispatch to
+    // their NoClip instantiation - no bounds check per pixel for fully visible primitives
+    template <class Setter>
+    inline bool fullyVisible(int x0, int y0, int x1, int y1) const
+    {
+        return !std::is_same<Setter, NoClipOf<Setter> >::value && insideImage(x0, y0, x1, y1);
+    }
+
+    inline bool insideImage(int x0, int y0, int x1, int y1) const
+    {
+        return x0 >= 0 && y0 >= 0 && x1 < int(image_.width()) && y1 < int(image_.height());
+    }
+
+    // [x0 .. x1] x [y0 .. y1] has no pixel in the image
+    inline bool outsideImage(int x0, int y0, int x1, int y1) const
+    {
+        return x1 < 0 || y1 < 0 || x0 >= int(image_.width()) || y0 >= int(image_.height());
+    }
+
     template <class Setter = PixelSetter>
     void plotPoint(int x0, int y0, const pixel_t color)
     {
+        if (fullyVisible<Setter>(x0, y0, x0, y0))
+            return plotPoint<NoClipOf<Setter> >(x0, y0, color);
+
         pixel_t * pos = image_.row(y0) + x0;
-        Setter setPixel{image_};
+        SetterOf<Setter> setPixel{image_, setter_context_};
         setPixel(x0, y0, pos, color);
     }
 
@@ -237,8 +503,11 @@ public:
     template <class Setter = PixelSetter>
     void plotCross(int x0, int y0, const pixel_t color)
     {
+        if (fullyVisible<Setter>(x0 - 1, y0 - 1, x0 + 1, y0 + 1))
+            return plotCross<NoClipOf<Setter> >(x0, y0, color);
+
         pixel_t * pos = image_.row(y0) + x0;
-        Setter setPixel{image_};
+        SetterOf<Setter> setPixel{image_, setter_context_};
         setPixel(x0, y0-1, pos - image_.row_increment(), color);
         setPixel(x0-1, y0, pos - 1, color);
         setPixel(x0,   y0, pos, color);
@@ -255,7 +524,10 @@ public:
     template <class Setter = PixelSetter>
     inline void plotHLine(int x0, int x1, int y, const pixel_t color)
     {
-        Setter setPixel{image_};
+        if (fullyVisible<Setter>(std::min(x0, x1), y, std::max(x0, x1), y))
+            return plotHLine<NoClipOf<Setter> >(x0, x1, y, color);
+
+        SetterOf<Setter> setPixel{image_, setter_context_};
         pixel_t * row = image_.row(y);
         setPixel.hLine(x0, x1, y, &row[x0], &row[x1], color);
     }
@@ -263,7 +535,17 @@ public:
     template <class Setter = PixelSetter>
     inline void plotVLine(int x, int y0, int y1, const pixel_t color)
     {
-        Setter setPixel{image_};
+        if (fullyVisible<Setter>(x, std::min(y0, y1), x, std::max(y0, y1)))
+            return plotVLine<NoClipOf<Setter> >(x, y0, y1, color);
+        if (!insideImage(x, std::min(y0, y1), x, std::max(y0, y1)))
+        {
+            /* clip the rows: the line might be far longer than the image */
+            if (x < 0 || x >= int(image_.width()) || y1 < 0 || y0 >= int(image_.height()))
+                return;
+            return plotVLine<NoClipOf<Setter> >(x, std::max(y0, 0), std::min(y1, int(image_.height()) - 1), color);
+        }
+
+        SetterOf<Setter> setPixel{image_, setter_context_};
         pixel_t * row = image_.row(y0);
         const int row_inc = int(image_.row_increment());
         for ( int y = y0; y <= y1; ++y, row += row_inc )
@@ -273,7 +555,10 @@ public:
     template <class Setter = PixelSetter>
     inline void plotRect(int x0, int y0, int x1, int y1, const pixel_t color)
     {
-        Setter setPixel{image_};
+        if (fullyVisible<Setter>(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1)))
+            return plotRect<NoClipOf<Setter> >(x0, y0, x1, y1, color);
+
+        SetterOf<Setter> setPixel{image_, setter_context_};
         pixel_t * row = image_.row(y0);
         const int row_inc = int(image_.row_increment());
         setPixel.hLine(x0, x1, y0, &row[x0], &row[x1], color);
@@ -299,7 +584,10 @@ public:
     template <class Setter = PixelSetter>
     inline void fillRect(int x0, int y0, int x1, int y1, const pixel_t color)
     {
-        Setter setPixel{image_};
+        if (fullyVisible<Setter>(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1)))
+            return fillRect<NoClipOf<Setter> >(x0, y0, x1, y1, color);
+
+        SetterOf<Setter> setPixel{image_, setter_context_};
         pixel_t * row = image_.row(y0);
         const int row_inc = int(image_.row_increment());
         for (int y = y0; y <= y1; ++y, row += row_inc)
@@ -325,6 +613,104 @@ public:
     template <class Setter = PixelSetter>
     inline void plotLineWidth(const Point ptA, const Point ptB, float wd, const pixel_t color);
 
+    /* plot an anti-aliased line of width 1: Setter::coverage() gets the coverage
+       in [0 .. 255] of the 2 pixels next to the line - e.g. PixelBlender or PixelAdder */
+    template <class Setter = PixelBlender>
+    inline void plotLineAA(int x0, int y0, const int x1, const int y1, const pixel_t color);
+
+    template <class Setter = PixelBlender>
+    inline void plotLineAA(const Point ptA, const Point ptB, const pixel_t color);
+
+    /* connected lines through the n points pts[]: the points shared by 2 segments
+       are set once - also with PixelAdder. partially visible polylines clip per segment;
+       segments outside the image are skipped */
+    template <class Setter = PixelSetter>
+    inline void plotPolyline(const Point* pts, const size_t n, const pixel_t color);
+
+    template <class Setter = PixelBlender>
+    inline void plotPolylineAA(const Point* pts, const size_t n, const pixel_t color);
+
+    /* anti-aliased stroke of width wd through the points - unlike plotLineWidth() with
+       round joins and caps: a pixel gets the coverage of its distance to the nearest
+       segment and is set once, also where the segments overlap or cross */
+    template <class Setter = PixelSetter>
+    inline void plotPolylineWidth(const Point* pts, const size_t n, float wd, const pixel_t color);
+
+    /* filled polygon with the n corners pts[] - concave or self-intersecting.
+       the pixel centers inside are set, those on the left and top edges included:
+       polygons sharing an edge don't overlap and leave no gap (e.g. maps).
+       the spans go to Setter::hLine(), clipped exactly to the image.
+       coordinates are limited to +-2^30 */
+    template <class Setter = PixelSetter>
+    inline void fillPolygon(const Point* pts, const size_t n, const pixel_t color,
+                            const polygon_fill_rule rule = fill_even_odd);
+
+    /* polygon of several rings - e.g. the outline and its holes: ring i has the
+       next ring_sizes[i] points of pts[] */
+    template <class Setter = PixelSetter>
+    inline void fillPolygonRings(const Point* pts, const size_t* ring_sizes, const size_t n_rings,
+                                 const pixel_t color, const polygon_fill_rule rule = fill_even_odd);
+
+    /* anti-aliased filled polygon: the exact area of each pixel - the square of +-0.5
+       around its center - inside the polygon goes to Setter::coverage(), fully covered
+       spans go to Setter::hLine(). the fill rule is nonzero, with overlapping parts
+       counted once: holes of fillPolygonRingsAA() need the opposite orientation */
+    template <class Setter = PixelBlender>
+    inline void fillPolygonAA(const PointF* pts, const size_t n, const pixel_t color);
+
+    template <class Setter = PixelBlender>
+    inline void fillPolygonRingsAA(const PointF* pts, const size_t* ring_sizes, const size_t n_rings,
+                                   const pixel_t color);
+
+    /* quadratic Bezier curve from (x0, y0) to (x2, y2) with the control point (x1, y1):
+       each pixel is set once - also with PixelAdder. the curve is split where its
+       gradient changes sign; the pieces are clipped per pixel when partially visible */
+    template <class Setter = PixelSetter>
+    inline void plotQuadBezier(int x0, int y0, int x1, int y1, int x2, int y2, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotQuadBezier(const Point pt0, const Point pt1, const Point pt2, const pixel_t color);
+
+    /* rational quadratic Bezier curve: the weight w >= 0 of the control point makes
+       w < 1 an ellipse arc, w == 1 a parabola, w > 1 a hyperbola */
+    template <class Setter = PixelSetter>
+    inline void plotQuadRationalBezier(int x0, int y0, int x1, int y1, int x2, int y2, float w, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotQuadRationalBezier(const Point pt0, const Point pt1, const Point pt2, float w, const pixel_t color);
+
+    /* cubic Bezier curve: split like the quadratic one, the parts drawn as
+       quadratic pieces within about 1/2 pixel */
+    template <class Setter = PixelSetter>
+    inline void plotCubicBezier(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotCubicBezier(const Point pt0, const Point pt1, const Point pt2, const Point pt3, const pixel_t color);
+
+    /* anti-aliased curves of width 1: cut like the curves above, Setter::coverage() gets
+       1 minus the distance of the pixel on the curve and the one beside it - see zingl_bezier_aa.hpp */
+    template <class Setter = PixelBlender>
+    inline void plotQuadBezierAA(int x0, int y0, int x1, int y1, int x2, int y2, const pixel_t color);
+
+    template <class Setter = PixelBlender>
+    inline void plotQuadRationalBezierAA(int x0, int y0, int x1, int y1, int x2, int y2, float w, const pixel_t color);
+
+    template <class Setter = PixelBlender>
+    inline void plotCubicBezierAA(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, const pixel_t color);
+
+    /* thick curves of width wd: the sampled curve goes to strokePolyline() - see
+       zingl_bezier_stroke.hpp */
+    template <class Setter = PixelSetter>
+    inline void plotQuadBezierWidth(int x0, int y0, int x1, int y1, int x2, int y2, float wd, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotQuadRationalBezierWidth(int x0, int y0, int x1, int y1, int x2, int y2, float w, float wd,
+                                            const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotCubicBezierWidth(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, float wd,
+                                     const pixel_t color);
+
     template <class Setter = PixelSetter>
     inline void plotEllipse(const int xm, const int ym, const int rx, const int ry, const pixel_t color);
 
@@ -362,6 +748,57 @@ public:
     template <class Setter = PixelSetter>
     inline void fillEllipseRect(const Point pt0, const Point pt1, const pixel_t color);
 
+    /* ellipse with the radii a, b rotated by angle (radian), from the x axis towards the y axis */
+    template <class Setter = PixelSetter>
+    inline void plotRotatedEllipse(const int xm, const int ym, int a, int b, const float angle, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotRotatedEllipse(const Point ptCenter, const Point radius, const float angle, const pixel_t color);
+
+    /* rotated ellipse touching the 4 sides of the rectangle: zd = 4 (a^2 - b^2) sin cos of the
+       rotation, scaled to the rectangle - limited to |zd| <= (x1 - x0) (y1 - y0) */
+    template <class Setter = PixelSetter>
+    inline void plotRotatedEllipseRect(int x0, int y0, int x1, int y1, long zd, const pixel_t color);
+
+    /* the rows of the outline pixels filled */
+    template <class Setter = PixelSetter>
+    inline void fillRotatedEllipse(const int xm, const int ym, int a, int b, const float angle, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void fillRotatedEllipse(const Point ptCenter, const Point radius, const float angle, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void fillRotatedEllipseRect(int x0, int y0, int x1, int y1, long zd, const pixel_t color);
+
+    /* arc of the rotated ellipse from the parameter angle start to end, towards increasing
+       angles: the point at t is (a cos t, b sin t) rotated. end - start >= 2 pi draws the
+       whole ellipse. a == b gives circular arcs */
+    template <class Setter = PixelSetter>
+    inline void plotEllipseArc(const int xm, const int ym, int a, int b, const float angle,
+                               const float start, const float end, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotEllipseArc(const Point ptCenter, const Point radius, const float angle,
+                               const float start, const float end, const pixel_t color);
+
+    /* the arc closed by the radii to its end points - each pixel once */
+    template <class Setter = PixelSetter>
+    inline void plotEllipsePie(const int xm, const int ym, int a, int b, const float angle,
+                               const float start, const float end, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotEllipsePie(const Point ptCenter, const Point radius, const float angle,
+                               const float start, const float end, const pixel_t color);
+
+    /* filled wedge: the spans of fillRotatedEllipse() between the rays through the end points */
+    template <class Setter = PixelSetter>
+    inline void fillEllipsePie(const int xm, const int ym, int a, int b, const float angle,
+                               const float start, const float end, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void fillEllipsePie(const Point ptCenter, const Point radius, const float angle,
+                               const float start, const float end, const pixel_t color);
+
     template <class Setter = PixelSetter>
     inline void plotCircle(const int xm, const int ym, const int radius, const pixel_t color);
 
@@ -374,22 +811,273 @@ public:
     template <class Setter = PixelSetter>
     inline void fillCircle(const Point ptCenter, const int radius, const pixel_t color);
 
+    /* the pre-rasterized marker at (x, y): full spans go to Setter::hLine(), anti-aliased
+       edge pixels to Setter::coverage(). clipped once by the bounding box of the stamp */
+    template <class Setter = PixelSetter>
+    inline void plotStamp(const marker_stamp& stamp, const int x, const int y, const pixel_t color);
+
+    template <class Setter = PixelSetter>
+    inline void plotStamp(const marker_stamp& stamp, const Point pt, const pixel_t color);
+
 private:
+    /* one line segment each, with a Setter of the caller: row0 is the row of y0.
+       first == false skips the pixel at (x0, y0), which the previous segment did set.
+       returns the row of y1 - for the next segment */
+    template <class Setter>
+    inline pixel_t* lineSegment(Setter& setPixel, pixel_t* row0, int x0, int y0, const int x1, const int y1,
+                                const pixel_t color, const bool first);
+
+    /* visible part of the line only, exactly the pixels of lineSegment() */
+    template <class Setter>
+    inline void lineClipped(Setter& setPixel, const int x0, const int y0, const int x1, const int y1,
+                            const pixel_t color, const bool first);
+
+    template <class Setter>
+    inline pixel_t* lineAASegment(Setter& setPixel, pixel_t* row0, int x0, int y0, const int x1, const int y1,
+                                  const pixel_t color, const bool first);
+
+    template <class Setter>
+    inline pixel_t* lineWidthSegment(Setter& setPixel, pixel_t* row0, int x0, int y0, const int x1, const int y1,
+                                     float wd, const pixel_t color, const bool first);
+
+    struct LineSegmentOp;
+    struct LineAASegmentOp;
+
+    /* stroke of width wd along the polyline pts[0 .. n): coverage (wd + 1) / 2 minus the
+       distance to the nearest segment - in bands of rows, with their minimum distances */
+    template <class Setter>
+    inline void strokePolyline(const PointF* pts, const size_t n, const float wd, const pixel_t color);
+
+    /* segment of strokePolyline() from a to b, reaching the rows [y0 .. y1] */
+    struct StrokeSegment
+    {
+        float ax, ay;
+        float dx, dy, inv_l2;       // b - a, 1 / |b - a|^2 - 0 for a point
+        float slope, half_band;     // band along the segment: ax + slope (y - ay) +- half_band
+        float x_lo, x_hi;           // bounding box + r, within the image
+        int y0, y1;
+        int y_in0, y_in1;           // the rows at least r from both ends
+    };
+
+    /* draws the segments of a polyline with Segment, which extends margin pixels around them */
+    template <class Setter, class Segment>
+    inline void plotPolylineSegments(const Point* pts, const size_t n, const int margin, const Segment& segment);
+
+    /* outline of partially visible ellipses/circles: only the visible rows of the
+       4 quadrants are walked, with Setter not checking bounds - see zingl_outline_clip.hpp */
+    template <class Setter, class Path>
+    inline void plotQuadrantsClipped(const int xm, const int ym, const Path& path, const long long a, const bool rotated, const pixel_t color);
+
+    /* edge of a polygon, for the scanlines [y .. y_end): the crossing at the
+       current row is x + r / dy, with 0 <= r < dy */
+    struct PolygonEdge
+    {
+        int y, y_end;
+        int x, r;
+        int x_step, r_step, dy;
+        int winding;        // +1 downwards, -1 upwards
+    };
+
+    /* appends the non-horizontal edges of the closed ring, which reach a visible row,
+       to polygon_edges_ - starting at row >= 0 */
+    inline void addPolygonRing(const Point* pts, const size_t n);
+
+    template <class Setter>
+    inline void fillPolygonEdges(const pixel_t color, const polygon_fill_rule rule);
+
+    /* edge of fillPolygonRingsAA() in coordinates of its bounding box, reaching the rows [ya .. yb) */
+    struct CoverageEdge
+    {
+        float x0, y0, x1, y1;
+        int ya, yb;
+    };
+
+    /* signed area of the line from (x0, y0) to (x1, y1) into coverage_acc_ - coordinates
+       relative to the bounding box of bw x bh pixels, in pixel edges. the parts left and
+       right of the box go along its border */
+    inline void accumulateCoverage(float x0, float y0, float x1, float y1, const int bw, const int bh);
+
+    inline void accumulateCoverageInside(float x0, float y0, float x1, float y1, const int bw, const int bh);
+
+    /* row y of the image - also outside, only for pointer arithmetic */
+    inline pixel_t* signedRow(const int y)
+    {
+        return image_.row(0) + std::ptrdiff_t(y) * std::ptrdiff_t(image_.row_increment());
+    }
+
+    /* Bezier segments without sign change of the gradient - see zingl_bezier.hpp.
+       plot_end == false skips the pixel at the end point, which the next segment sets -
+       plot_first == false the one at the start point.
+       the control points x1 .. y2 of cubicBezierSegment() are relative to (x0, y0) */
+    template <class Setter>
+    inline void quadBezierSegment(Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                                  const pixel_t color, const bool plot_end);
+
+    template <class Setter>
+    inline void quadRationalBezierSegment(Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                                          double w, const pixel_t color, const bool plot_first, const bool plot_end);
+
+    /* the same anti-aliased - see zingl_bezier_aa.hpp */
+    template <class Setter>
+    inline void quadBezierSegmentAA(Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                                    const pixel_t color, const bool plot_end);
+
+    template <class Setter>
+    inline void quadRationalBezierSegmentAA(Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                                            double w, const pixel_t color, const bool plot_first, const bool plot_end);
+
+    /* the segments of the cuts: quad() and quadRational() draw the segments above */
+    struct BezierSegmentOp;
+    struct BezierAASegmentOp;
+
+    /* curves cut where their gradient changes sign, the parts drawn by Segment */
+    template <class Setter, class Segment>
+    inline void quadBezierCuts(Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                               const Segment& segment);
+
+    /* the weight w isn't squared */
+    template <class Setter, class Segment>
+    inline void quadRationalBezierCuts(Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2,
+                                       const double w, const Segment& segment, const bool plot_end);
+
+    template <class Setter, class Segment>
+    inline void cubicBezierCuts(Setter& setPixel, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3,
+                                const Segment& segment);
+
+    /* forwards all pixels but (x, y) - for lines leaving out both end points */
+    template <class Setter>
+    struct PixelExcept
+    {
+        PixelExcept(Setter& setPixel, const int x, const int y) : setPixel_(setPixel), x_(x), y_(y) { }
+
+        inline void operator()(int x, int y, pixel_t* pos, pixel_t value)
+        {
+            if (x != x_ || y != y_)
+                setPixel_(x, y, pos, value);
+        }
+        inline void coverage(int x, int y, pixel_t* pos, pixel_t value, unsigned cov)
+        {
+            if (x != x_ || y != y_)
+                zingl_detail::set_coverage(setPixel_, x, y, pos, value, cov);
+        }
+
+    private:
+        Setter& setPixel_;
+        const int x_, y_;
+    };
+
+    template <class Setter, class Segment>
+    inline void cubicBezierSegment(Setter& setPixel, const int x0, const int y0, const double x1, const double y1,
+                                   const double x2, const double y2, const int x3, const int y3,
+                                   const Segment& segment, const bool plot_end);
+
+    /* extents of the pixels set in rows [y_first .. y_first + x0.size()) - other rows
+       are ignored. for the spans of convex shapes */
+    struct SpanExtents
+    {
+        SpanExtents(std::vector<int>& x0, std::vector<int>& x1, const int y_first)
+            : x0_(x0), x1_(x1), y_first_(y_first) { }
+
+        inline void operator()(int x, int y, pixel_t* pos, pixel_t value)
+        {
+            (void)pos; (void)value;
+            const size_t i = size_t(y - y_first_);
+            if (i < x0_.size())
+            {
+                x0_[i] = std::min(x0_[i], x);
+                x1_[i] = std::max(x1_[i], x);
+            }
+        }
+
+    private:
+        std::vector<int>& x0_;
+        std::vector<int>& x1_;
+        const int y_first_;
+    };
+
+    /* half sizes a, b of the rectangle enclosing the rotated ellipse and its zd */
+    static inline long rotatedEllipseRect(int& a, int& b, const double angle);
+
+    /* outline of plotRotatedEllipseRect() - 4 rational segments as closed loop */
+    template <class Setter>
+    inline void rotatedEllipseSegments(Setter& setPixel, const int x0, const int y0, const int x1, const int y1,
+                                       const long zd, const pixel_t color);
+
+    /* spans of the rows [ya .. yb] of the rotated ellipse into span_x0_, span_x1_ */
+    inline void rotatedEllipseSpans(const int x0, const int y0, const int x1, const int y1, const long zd,
+                                    const int ya, const int yb);
+
+    /* point at t of the rotated ellipse, scaled by r - rounded to the pixel */
+    static inline void arcPoint(const int xm, const int ym, const int a, const int b, const double angle,
+                                const double t, const double r, int& x, int& y);
+
+    /* sweep of the arc in [0 .. 2 pi) - false for the whole ellipse */
+    static inline bool arcSweep(const float start, const float end, double& sweep);
+
+    /* the arc as rational quadratic pieces of up to 90 degrees. from_end draws from
+       the end point and leaves out the start point */
+    template <class Setter>
+    inline void ellipseArc(Setter& setPixel, const int xm, const int ym, const int a, const int b, const double angle,
+                           const double start, const double sweep, const pixel_t color, const bool from_end);
+
+    /* samples of the curve into stroke_path_ - for the thick curves */
+    inline void flattenQuadRationalBezier(const int x0, const int y0, const int x1, const int y1,
+                                          const int x2, const int y2, const double w);
+
+    inline void flattenCubicBezier(const int x0, const int y0, const int x1, const int y1,
+                                   const int x2, const int y2, const int x3, const int y3);
+
+    /* stroke of width wd along stroke_path_ */
+    template <class Setter>
+    inline void strokePath(const float wd, const pixel_t color);
+
     zingl_image_drawer(const zingl_image_drawer& id);
     zingl_image_drawer& operator =(const zingl_image_drawer& id);
 
     BitmapImageType& image_;
+    zingl_detail::setter_context setter_context_;
+
+    // edge tables of fillPolygon(): kept for the next polygon, no allocation once grown
+    std::vector<PolygonEdge> polygon_edges_;
+    std::vector<PolygonEdge> active_edges_;
+    // accumulated signed area of the current row of fillPolygonAA(): (bw + 2) values, zero between the rows
+    std::vector<float> coverage_acc_;
+    // edges and active edges of fillPolygonAA()
+    std::vector<CoverageEdge> coverage_edges_;
+    std::vector<CoverageEdge> coverage_active_;
+    // sampled curve of the thick Bezier curves, points of plotPolylineWidth()
+    std::vector<PointF> stroke_path_;
+    // segments, their start per band of rows, active segments and squared distances
+    // of the rows of the current band of strokePolyline()
+    std::vector<StrokeSegment> stroke_segments_;
+    std::vector<size_t> stroke_band_start_;
+    std::vector<StrokeSegment> stroke_active_;
+    std::vector<float> stroke_row_;
+    // row extents of the rotated ellipses and pie wedges
+    std::vector<int> span_x0_;
+    std::vector<int> span_x1_;
 };
 
 }
 
+#include "zingl_outline_clip.hpp"
 #include "zingl_ellipse.hpp"
 #include "zingl_ellipse_fill.hpp"
 #include "zingl_ellipse_optimized.hpp"
 #include "zingl_ellipse_optimized_fill.hpp"
 #include "zingl_ellipse_rect.hpp"
 #include "zingl_ellipse_rect_fill.hpp"
+#include "zingl_ellipse_rotated.hpp"
+#include "zingl_ellipse_arc.hpp"
 #include "zingl_circle.hpp"
 #include "zingl_circle_fill.hpp"
 #include "zingl_line.hpp"
 #include "zingl_line_width.hpp"
+#include "zingl_line_aa.hpp"
+#include "zingl_polyline.hpp"
+#include "zingl_polygon_fill.hpp"
+#include "zingl_polygon_aa.hpp"
+#include "zingl_bezier.hpp"
+#include "zingl_bezier_aa.hpp"
+#include "zingl_bezier_stroke.hpp"
+#include "zingl_marker.hpp"
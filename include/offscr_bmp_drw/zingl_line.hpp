@@ -30,16 +30,101 @@ template <class BitmapImageType>
 template <class Setter>
 void zingl_image_drawer<BitmapImageType>::plotLine(
     int x0, int y0, int x1, int y1, const pixel_t color)
+{
+    if (!insideImage(std::min(x0, x1), std::min(y0, y1), std::max(x0, x1), std::max(y0, y1)))
+    {
+        if (std::abs((long long)x1 - x0) < (1LL << 30) && std::abs((long long)y1 - y0) < (1LL << 30))
+        {
+            SetterOf<NoClipOf<Setter> > setPixel{image_, setter_context_};
+            return lineClipped(setPixel, x0, y0, x1, y1, color, true);
+        }
+    }
+    else if (!std::is_same<Setter, NoClipOf<Setter> >::value)
+        return plotLine<NoClipOf<Setter> >(x0, y0, x1, y1, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    lineSegment(setPixel, image_.row(y0), x0, y0, x1, y1, color, true);
+}
+
+/* the loop of lineSegment() sets exactly 1 pixel per step of the major axis:
+   for |dx| >= |dy| the k-th column gets row k*|dy|/|dx| rounded, half up - or the
+   column of the k-th row. with err == dx*(1+ky) - dy*(1+kx) at the k-th pixel,
+   the loop is resumed at the first visible pixel and stops after the last one */
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::lineClipped(
+    Setter& setPixel, const int x0, const int y0, const int x1, const int y1,
+    const pixel_t color, const bool first)
+{
+    using zingl_detail::floor_div;
+    using zingl_detail::ceil_div;
+    const long long dx = std::abs((long long)x1 - x0), sx = x0 < x1 ? 1 : -1;
+    const long long dy = std::abs((long long)y1 - y0), sy = y0 < y1 ? 1 : -1;
+    const long long w = image_.width(), h = image_.height();
+
+    /* visible steps in x and in y */
+    const long long kxa = std::max(0LL, sx > 0 ? -x0 : x0 - (w-1));
+    const long long kxb = std::min(dx, sx > 0 ? (w-1) - x0 : (long long)x0);
+    const long long kya = std::max(0LL, sy > 0 ? -y0 : y0 - (h-1));
+    const long long kyb = std::min(dy, sy > 0 ? (h-1) - y0 : (long long)y0);
+    if (kxa > kxb || kya > kyb)
+        return;
+
+    long long ka, kb, kx, ky;           /* visible steps of the major axis */
+    if (dx >= dy)
+    {
+        ka = kxa; kb = kxb;
+        if (dy)
+        {
+            ka = std::max(ka, ceil_div(2*dx*kya - dx, 2*dy));
+            kb = std::min(kb, floor_div(2*dx*(kyb+1) - dx - 1, 2*dy));
+        }
+        if (!first && ka == 0) ka = 1;
+        if (ka > kb) return;
+        kx = ka; ky = dx ? (2*dy*kx + dx) / (2*dx) : 0;
+    }
+    else
+    {
+        ka = kya; kb = kyb;
+        if (dx)
+        {
+            ka = std::max(ka, ceil_div(2*dy*kxa - dy, 2*dx));
+            kb = std::min(kb, floor_div(2*dy*(kxb+1) - dy - 1, 2*dx));
+        }
+        if (!first && ka == 0) ka = 1;
+        if (ka > kb) return;
+        ky = ka; kx = (2*dx*ky + dy) / (2*dy);
+    }
+
+    int x = int(x0 + sx*kx), y = int(y0 + sy*ky);
+    long long err = dx*(1+ky) - dy*(1+kx);
+    const int dy_inc = int(sy) * int(image_.row_increment());
+    pixel_t * pos = image_.row(y) + x;
+    for (long long n = kb - ka; ; --n) {
+        setPixel(x, y, pos, color);
+        if (!n) break;
+        const long long e2 = 2*err;
+        if (e2 >= -dy) { err -= dy; x += int(sx); pos += sx; }
+        if (e2 <= dx)  { err += dx; y += int(sy); pos += dy_inc; }
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+typename zingl_image_drawer<BitmapImageType>::pixel_t *
+zingl_image_drawer<BitmapImageType>::lineSegment(
+    Setter& setPixel, pixel_t* row0, int x0, int y0, const int x1, const int y1,
+    const pixel_t color, const bool first)
 {
     const int dx =  std::abs(x1-x0), sx = x0<x1 ? 1 : -1;
     const int dy = -std::abs(y1-y0), sy = y0<y1 ? 1 : -1;
     const int dy_inc = sy * int(image_.row_increment());
     int err = dx+dy, e2;                                  /* error value e_xy */
-    pixel_t * pos = image_.row(y0) + x0;
-    Setter setPixel{image_};
+    pixel_t * pos = row0 + x0;
 
-    for (;;) {                                                        /* loop */
+    if (first)
         setPixel(x0, y0, pos, color);
+    for (;;) {                                                        /* loop */
         e2 = 2*err;
         if (e2 >= dy) {                                       /* e_xy+e_x > 0 */
             if (x0 == x1) break;
@@ -53,7 +138,9 @@ void zingl_image_drawer<BitmapImageType>::plotLine(
             y0 += sy;
             pos += dy_inc;
         }
+        setPixel(x0, y0, pos, color);
     }
+    return pos - x1;
 }
 
 template <class BitmapImageType>
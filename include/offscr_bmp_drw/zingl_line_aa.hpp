@@ -0,0 +1,91 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+
+namespace OffScreenBitmapDraw
+{
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotLineAA(
+    int x0, int y0, const int x1, const int y1, const pixel_t color)
+{
+    if (fullyVisible<Setter>(std::min(x0, x1) - 1, std::min(y0, y1) - 1,
+                             std::max(x0, x1) + 1, std::max(y0, y1) + 1))
+        return plotLineAA<NoClipOf<Setter> >(x0, y0, x1, y1, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    lineAASegment(setPixel, image_.row(y0), x0, y0, x1, y1, color, true);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+typename zingl_image_drawer<BitmapImageType>::pixel_t *
+zingl_image_drawer<BitmapImageType>::lineAASegment(
+    Setter& setPixel, pixel_t* row0, int x0, int y0, const int x1, const int y1,
+    const pixel_t color, const bool first)
+{
+    const int dx = std::abs(x1-x0), sx = x0 < x1 ? 1 : -1;
+    const int dy = std::abs(y1-y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx-dy, e2, x2;                               /* error value e_xy */
+    const long long ed = dx+dy == 0 ? 1 : std::llround(std::sqrt((double)dx*dx+(double)dy*dy));
+    /* coverage 255 - 255*|e|/ed with the division as 16.16 fixed point multiplication */
+    const long long cov_scale = (255LL * 65536 + ed / 2) / ed;
+    auto coverage = [cov_scale](const long long e) -> unsigned {
+        const long long d = (e * cov_scale + 32768) >> 16;
+        return d >= 255 ? 0U : unsigned(255 - d);
+    };
+    const int dy_inc = sy * int(image_.row_increment());
+
+    if (first)
+        zingl_detail::set_coverage(setPixel, x0, y0, &row0[x0], color, coverage(std::abs(err-dx+dy)));
+    for ( ; ; ) {                                                /* pixel loop */
+        e2 = err; x2 = x0;
+        if (2*e2 >= -dx) {                                            /* x step */
+            if (x0 == x1) break;
+            if (e2+dy < ed)
+                zingl_detail::set_coverage(setPixel, x0, y0+sy, &row0[x0 + dy_inc], color, coverage(e2+dy));
+            err -= dy; x0 += sx;
+        }
+        if (2*e2 <= dy) {                                             /* y step */
+            if (y0 == y1) break;
+            if (dx-e2 < ed)
+                zingl_detail::set_coverage(setPixel, x2+sx, y0, &row0[x2+sx], color, coverage(dx-e2));
+            err += dx; y0 += sy; row0 += dy_inc;
+        }
+        zingl_detail::set_coverage(setPixel, x0, y0, &row0[x0], color, coverage(std::abs(err-dx+dy)));
+    }
+    return row0;
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotLineAA(
+    const Point ptA, const Point ptB, const pixel_t color)
+{
+    plotLineAA<Setter>(ptA.first, ptA.second, ptB.first, ptB.second, color);
+}
+
+}
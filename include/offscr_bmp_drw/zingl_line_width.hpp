@@ -30,43 +30,67 @@ template <class BitmapImageType>
 template <class Setter>
 void zingl_image_drawer<BitmapImageType>::plotLineWidth(
     int x0, int y0, const int x1, const int y1, float wd, const pixel_t color)
+{
+    const int margin = int(wd) + 2;     /* line extends up to (wd+1)/2 perpendicular */
+    if (fullyVisible<Setter>(std::min(x0, x1) - margin, std::min(y0, y1) - margin,
+                             std::max(x0, x1) + margin, std::max(y0, y1) + margin))
+        return plotLineWidth<NoClipOf<Setter> >(x0, y0, x1, y1, wd, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    lineWidthSegment(setPixel, image_.row(y0), x0, y0, x1, y1, wd, color, true);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+typename zingl_image_drawer<BitmapImageType>::pixel_t *
+zingl_image_drawer<BitmapImageType>::lineWidthSegment(
+    Setter& setPixel, pixel_t* row0, int x0, int y0, const int x1, const int y1,
+    float wd, const pixel_t color, const bool first)
 {
     int dx = std::abs(x1-x0);
     int dy = std::abs(y1-y0);
     const int sx = x0 < x1 ? 1 : -1;
     const int sy = y0 < y1 ? 1 : -1;
     int err = dx-dy, e2, x2, y2;                           /* error value e_xy */
-    float ed = dx+dy == 0 ? 1 : std::sqrt((float)dx*dx+(float)dy*dy);
+    const float ed = dx+dy == 0 ? 1 : std::sqrt((float)dx*dx+(float)dy*dy);
+    wd = (wd+1)/2;
+    /* coverage 255 * (1 - max(0, |e|/ed - wd + 1)) in 16.16 fixed point:
+       the only float math is this setup per line */
+    const long long cov_scale = std::llround(255.0F * 65536.0F / ed);
+    const long long cov_ofs = std::llround((wd - 1.0F) * 255.0F * 65536.0F);
+    const int e_max = int(std::ceil(ed*wd));              /* e2 < ed*wd */
+    auto coverage = [cov_scale, cov_ofs](const int e) -> unsigned {
+        const long long d = (std::abs((long long)e) * cov_scale - cov_ofs) >> 16;
+        return d <= 0 ? 255U : (d >= 255 ? 0U : unsigned(255 - d));
+    };
     const int dy_inc = sy * int(image_.row_increment());
-    pixel_t * row0 = image_.row(y0);
-    Setter setPixel{image_};
 
-    for (wd = (wd+1)/2; ; ) {                                    /* pixel loop */
-        float col_mulA = (std::abs(err-dx+dy)/ed-wd+1);  // * 255
-        setPixel(x0, y0, &row0[x0], color * (1.0F -std::max(0.0F, col_mulA)));
+    if (first)
+        zingl_detail::set_coverage(setPixel, x0, y0, &row0[x0], color, coverage(err-dx+dy));
+    for ( ; ; ) {                                                /* pixel loop */
         e2 = err; x2 = x0;
         if (2*e2 >= -dx) {                                            /* x step */
             pixel_t * row2 = row0;
-            for (e2 += dy, y2 = y0; e2 < ed*wd && (y1 != y2 || dx > dy); e2 += dx)
+            for (e2 += dy, y2 = y0; e2 < e_max && (y1 != y2 || dx > dy); e2 += dx)
             {
                 y2 += sy; row2 += dy_inc;
-                float col_mulB = (std::abs(e2)/ed-wd+1);  // * 255
-                setPixel(x0, y2, &row2[x0], color * (1.0F -std::max(0.0F, col_mulB)));
+                zingl_detail::set_coverage(setPixel, x0, y2, &row2[x0], color, coverage(e2));
             }
             if (x0 == x1) break;
             e2 = err; err -= dy; x0 += sx;
         }
         if (2*e2 <= dy) {                                             /* y step */
-            for (e2 = dx-e2; e2 < ed*wd && (x1 != x2 || dx < dy); e2 += dy)
+            for (e2 = dx-e2; e2 < e_max && (x1 != x2 || dx < dy); e2 += dy)
             {
                 x2 += sx;
-                float col_mulB = (std::abs(e2)/ed-wd+1);  // * 255
-                setPixel(x2, y0, &row0[x2], color * (1.0F -std::max(0.0F, col_mulB)));
+                zingl_detail::set_coverage(setPixel, x2, y0, &row0[x2], color, coverage(e2));
             }
             if (y0 == y1) break;
             err += dx; y0 += sy; row0 += dy_inc;
         }
+        zingl_detail::set_coverage(setPixel, x0, y0, &row0[x0], color, coverage(err-dx+dy));
     }
+    return row0;
 }
 
 template <class BitmapImageType>
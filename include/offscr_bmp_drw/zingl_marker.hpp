@@ -0,0 +1,234 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+#include <map>
+
+namespace OffScreenBitmapDraw
+{
+
+/* marker rasterized once, relative to its position: scatter plots draw the same
+   symbol at many points - plotStamp() then only copies the rows, instead of
+   running the Bresenham iteration of fillCircle() etc. for each point */
+struct marker_stamp
+{
+    // fully covered pixels [x0 .. x1] of the row dy
+    struct span
+    {
+        int dy, x0, x1;
+    };
+
+    // anti-aliased edge pixel with its coverage 1 .. 254
+    struct partial
+    {
+        int dy, dx;
+        unsigned cov;
+    };
+
+    marker_stamp() : x0(0), y0(0), x1(-1), y1(-1) { }
+
+    inline bool empty() const { return spans.empty() && partials.empty(); }
+
+    // both sorted by row
+    std::vector<span> spans;
+    std::vector<partial> partials;
+    // bounding box [x0 .. x1] x [y0 .. y1] relative to the position
+    int x0, y0, x1, y1;
+};
+
+/* size is the radius of marker_disc and marker_circle, half the side of marker_square
+   and the arm length of marker_cross - marker_cross of size 1 is plotCross().
+   without anti-aliasing the pixels are those of fillCircle(), plotCircle(), fillRect()
+   and plotHLine() + plotVLine(). with anti-aliasing the disc has the radius size + 0.5
+   and the circle is a ring of width 1 - both from fillPolygonRingsAA().
+   a negative size gives an empty stamp */
+inline marker_stamp make_marker_stamp(const marker_shape shape, const int size, const bool aa = false)
+{
+    typedef bitmap_image_rgb<float> scratch_image_t;
+    typedef zingl_image_drawer<scratch_image_t> scratch_drawer_t;
+    typedef scratch_drawer_t::PixelSetter Setter;
+
+    if (size < 0)
+        return marker_stamp();
+    const int c = size + 2;
+    scratch_image_t scratch(unsigned(2 * c + 1), unsigned(2 * c + 1));
+    scratch.clear(0.0F);
+    scratch_drawer_t drawer(scratch);
+
+    const bool round = (shape == marker_disc || shape == marker_circle);
+    if (aa && round)
+    {
+        /* the polygons need to follow the curve within a small fraction of a pixel */
+        const int n = std::max(16, 8 * (size + 1));
+        std::vector<scratch_drawer_t::PointF> pts;
+        size_t ring_sizes[2] = { size_t(n), 0 };
+        const float radius[2] = { float(size) + 0.5F, float(size) - 0.5F };
+        const bool ring = (shape == marker_circle && size > 0);
+        for (int r = 0; r < (ring ? 2 : 1); ++r)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                /* the inner ring in the opposite direction - a hole */
+                const double t = 2.0 * zingl_detail::pi * double(r ? n - i : i) / double(n);
+                pts.push_back(scratch_drawer_t::PointF(float(c) + radius[r] * float(std::cos(t)),
+                                                       float(c) + radius[r] * float(std::sin(t))));
+            }
+            ring_sizes[r] = size_t(n);
+        }
+        drawer.fillPolygonRingsAA<Setter>(pts.data(), ring_sizes, ring ? 2 : 1, 1.0F);
+    }
+    else if (shape == marker_disc)
+        drawer.fillCircle<Setter>(c, c, size, 1.0F);
+    else if (shape == marker_circle)
+        drawer.plotCircle<Setter>(c, c, size, 1.0F);
+    else if (shape == marker_square)
+        drawer.fillRect<Setter>(c - size, c - size, c + size, c + size, 1.0F);
+    else
+    {
+        drawer.plotHLine<Setter>(c - size, c + size, c, 1.0F);
+        drawer.plotVLine<Setter>(c, c - size, c + size, 1.0F);
+    }
+
+    marker_stamp stamp;
+    stamp.x0 = stamp.y0 = c;
+    stamp.x1 = stamp.y1 = -c;
+    for (int y = 0; y < int(scratch.height()); ++y)
+    {
+        const float * row = scratch.row(y);
+        int run = -1;           /* start of fully covered pixels */
+        for (int x = 0; x <= int(scratch.width()); ++x)
+        {
+            const unsigned cov = (x < int(scratch.width())) ? unsigned(row[x] * 255.0F + 0.5F) : 0U;
+            if (cov >= 255)
+            {
+                if (run < 0)
+                    run = x;
+                continue;
+            }
+            if (run >= 0)
+            {
+                const marker_stamp::span s = { y - c, run - c, x - 1 - c };
+                stamp.spans.push_back(s);
+                run = -1;
+            }
+            if (cov)
+            {
+                const marker_stamp::partial p = { y - c, x - c, cov };
+                stamp.partials.push_back(p);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < stamp.spans.size(); ++i)
+    {
+        const marker_stamp::span& s = stamp.spans[i];
+        stamp.x0 = std::min(stamp.x0, s.x0);
+        stamp.x1 = std::max(stamp.x1, s.x1);
+        stamp.y0 = std::min(stamp.y0, s.dy);
+        stamp.y1 = std::max(stamp.y1, s.dy);
+    }
+    for (size_t i = 0; i < stamp.partials.size(); ++i)
+    {
+        const marker_stamp::partial& p = stamp.partials[i];
+        stamp.x0 = std::min(stamp.x0, p.dx);
+        stamp.x1 = std::max(stamp.x1, p.dx);
+        stamp.y0 = std::min(stamp.y0, p.dy);
+        stamp.y1 = std::max(stamp.y1, p.dy);
+    }
+    if (stamp.empty())
+        stamp = marker_stamp();
+    return stamp;
+}
+
+/* stamps by shape, size and anti-aliasing - rasterized on first use. the references
+   stay valid until clear() */
+class marker_cache
+{
+public:
+    const marker_stamp& stamp(const marker_shape shape, const int size, const bool aa = false)
+    {
+        const key k = { shape, size, aa };
+        std::map<key, marker_stamp>::iterator it = stamps_.find(k);
+        if (it == stamps_.end())
+            it = stamps_.insert(std::make_pair(k, make_marker_stamp(shape, size, aa))).first;
+        return it->second;
+    }
+
+    inline size_t size() const { return stamps_.size(); }
+    inline void clear() { stamps_.clear(); }
+
+private:
+    struct key
+    {
+        marker_shape shape;
+        int size;
+        bool aa;
+
+        inline bool operator <(const key& k) const
+        {
+            if (shape != k.shape)
+                return shape < k.shape;
+            if (size != k.size)
+                return size < k.size;
+            return aa < k.aa;
+        }
+    };
+
+    std::map<key, marker_stamp> stamps_;
+};
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotStamp(
+    const marker_stamp& stamp, const int x, const int y, const pixel_t color)
+{
+    if (stamp.empty() || outsideImage(x + stamp.x0, y + stamp.y0, x + stamp.x1, y + stamp.y1))
+        return;
+    if (fullyVisible<Setter>(x + stamp.x0, y + stamp.y0, x + stamp.x1, y + stamp.y1))
+        return plotStamp<NoClipOf<Setter> >(stamp, x, y, color);
+
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    pixel_t * const origin = signedRow(y) + x;
+    const std::ptrdiff_t row_inc = std::ptrdiff_t(image_.row_increment());
+    for (const marker_stamp::span* s = stamp.spans.data(), * s_end = s + stamp.spans.size(); s != s_end; ++s)
+    {
+        pixel_t * row = origin + s->dy * row_inc;
+        setPixel.hLine(x + s->x0, x + s->x1, y + s->dy, row + s->x0, row + s->x1, color);
+    }
+    for (const marker_stamp::partial* p = stamp.partials.data(), * p_end = p + stamp.partials.size(); p != p_end; ++p)
+    {
+        pixel_t * row = origin + p->dy * row_inc;
+        zingl_detail::set_coverage(setPixel, x + p->dx, y + p->dy, row + p->dx, color, p->cov);
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotStamp(
+    const marker_stamp& stamp, const Point pt, const pixel_t color)
+{
+    plotStamp<Setter>(stamp, pt.first, pt.second, color);
+}
+
+}
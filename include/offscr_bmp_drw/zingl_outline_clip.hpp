@@ -0,0 +1,332 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace OffScreenBitmapDraw
+{
+
+namespace zingl_detail
+{
+
+typedef long long coord_t;
+
+// the outline rasterizers walk one quadrant from (-a, 0) with x and y only increasing.
+// their error variable is err == error(x, y) at every step - so the step decisions
+// are functions of (x, y) and the walk can be resumed at any point of the path.
+
+// plotEllipse() / plotOptimizedEllipse(): loop while (x <= 0), then the tip at x == 0
+struct ellipse_quadrant_path
+{
+    coord_t a, b;
+
+    static constexpr bool has_tip = true;
+    coord_t x_last() const { return 0; }
+    coord_t y_max() const { return b + 1; }
+
+    // b²(x+1)² + a²(y+1)² - a²b², grouped so that a*b <= 1e9 doesn't overflow
+    coord_t error(const coord_t x, const coord_t y) const
+    {
+        return b*b*((x+1)*(x+1) - a*a) + a*a*(y+1)*(y+1);
+    }
+    bool x_step(const coord_t x, const coord_t y) const { return 2*error(x, y) >= (2*x+1)*b*b; }
+    bool y_step(const coord_t x, const coord_t y) const { return 2*error(x, y) <= (2*y+1)*a*a; }
+
+    // approximate first x with y_step() / last x with x_step() on row y
+    double y_step_guess(const coord_t y) const
+    {
+        const double yy = double(y);
+        return -1.0 - double(a) / double(b) * std::sqrt(std::max(0.0, double(b)*b - yy*yy - yy - 0.5));
+    }
+    double x_step_guess(const coord_t y) const
+    {
+        const double q = double(a) * double(y+1) / double(b);
+        return -0.5 - std::sqrt(std::max(0.0, double(a)*a - q*q - 0.25));
+    }
+};
+
+// plotCircle(): loop while (x < 0), the other quadrants are rotated copies
+struct circle_quadrant_path
+{
+    coord_t r;
+
+    static constexpr bool has_tip = false;
+    coord_t x_last() const { return -1; }
+    coord_t y_max() const { return r + 1; }
+
+    coord_t error(const coord_t x, const coord_t y) const
+    {
+        return (x+1)*(x+1) + (y+1)*(y+1) - r*r;
+    }
+    bool y_step(const coord_t x, const coord_t y) const { return error(x, y) <= y; }
+    bool x_step(const coord_t x, const coord_t y) const
+    {
+        const coord_t e = error(x, y);
+        if (e > y)      // no y step
+            return true;
+        return e > x || e + 2*y + 3 > y + 1;
+    }
+
+    double y_step_guess(const coord_t y) const
+    {
+        const double yy = double(y);
+        return -1.0 - std::sqrt(std::max(0.0, double(r)*r - (yy+1)*(yy+1) + yy));
+    }
+    double x_step_guess(const coord_t y) const
+    {
+        return y_step_guess(y) - 1.0;
+    }
+};
+
+// state of the walk at the start of a row: x of the first pixel or x_last()+1,
+// when the loop has ended - then y_final is the y at the end of the loop
+struct quadrant_state
+{
+    coord_t x;
+    coord_t y_final;
+};
+
+template <class Path>
+class quadrant_walker
+{
+public:
+    quadrant_walker(const Path& path, const coord_t a)
+        : p(path), a_(a), x_end(path.x_last())
+    { }
+
+    // first x in [-a .. x_last] with y_step() on row y - or x_last+1
+    coord_t row_exit(const coord_t y) const
+    {
+        const coord_t hi = std::min<coord_t>(x_end, -1);
+        coord_t x = clamp_guess(std::ceil(p.y_step_guess(y)), -a_, hi + 1);
+        // y_step() is monotone false -> true on [-a .. -1]
+        while (x > -a_ && p.y_step(x - 1, y))
+            --x;
+        while (x <= hi && !p.y_step(x, y))
+            ++x;
+        if (x > hi && x_end >= 0 && p.y_step(0, y))
+            return 0;
+        return (x <= hi) ? x : x_end + 1;
+    }
+
+    // last x in [-a .. x_last] with x_step() on row y - or -a-1
+    coord_t last_x_step(const coord_t y) const
+    {
+        const coord_t hi = std::min<coord_t>(x_end, -1);
+        coord_t x = clamp_guess(std::floor(p.x_step_guess(y)), -a_ - 1, hi);
+        // x_step() is monotone true -> false on [-a .. -1]
+        while (x < hi && p.x_step(x + 1, y))
+            ++x;
+        while (x >= -a_ && !p.x_step(x, y))
+            --x;
+        if (x == hi && x_end >= 0 && p.x_step(0, y))
+            return 0;
+        return x;
+    }
+
+    // walks row y from its first pixel s.x: last pixel of the row in *last, the state of row y+1 returned
+    quadrant_state next_row(const quadrant_state s, const coord_t y, coord_t* last = nullptr) const
+    {
+        if (s.x > x_end)
+            return s;
+        const coord_t t = row_exit(y);
+        if (t > x_end)
+        {
+            // no y step anymore: x steps out of the loop on this row
+            if (last)
+                *last = x_end;
+            return quadrant_state{ x_end + 1, y };
+        }
+        const coord_t l = std::max(s.x, t);
+        if (!p.y_step(l, y))
+        {
+            // x == 0 of the ellipse is not covered by the monotony of y_step()
+            if (last)
+                *last = x_end;
+            return quadrant_state{ x_end + 1, y };
+        }
+        if (last)
+            *last = l;
+        const coord_t next = l + (p.x_step(l, y) ? 1 : 0);
+        return (next > x_end) ? quadrant_state{ next, y + 1 } : quadrant_state{ next, 0 };
+    }
+
+    // state at the start of row y
+    quadrant_state row_start(const coord_t y) const
+    {
+        const coord_t x = row_start_x(y);
+        if (x <= x_end || y <= 0)
+            return quadrant_state{ x, 0 };
+        // the loop ended before row y: bisect for the last row it still ran on
+        coord_t lo = 0, hi = y;     // row_start_x(lo) <= x_end < row_start_x(hi)
+        if (row_start_x(lo) > x_end)
+            return quadrant_state{ x, 0 };
+        while (hi - lo > 1)
+        {
+            const coord_t mid = lo + (hi - lo) / 2;
+            if (row_start_x(mid) <= x_end)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        return next_row(quadrant_state{ row_start_x(lo), 0 }, lo);
+    }
+
+private:
+    static coord_t clamp_guess(const double g, const coord_t lo, const coord_t hi)
+    {
+        if (!(g >= double(lo)))     // also NaN
+            return lo;
+        if (g >= double(hi))
+            return hi;
+        return coord_t(g);
+    }
+
+    // x of the first pixel of row y - or x_last+1 beyond the loop.
+    // it lies between max(-a, row_exit(y-1)) and last_x_step(y-1)+1 and the mapping
+    // of first pixels from row to row is monotone: both bounds are walked from
+    // a few rows above; once they meet, the result is exact.
+    coord_t row_start_x(const coord_t y) const
+    {
+        if (y <= 0)
+            return -a_;
+        for (coord_t back = 1; back <= 8 && back <= y; ++back)
+        {
+            const coord_t y0 = y - back + 1;
+            coord_t lo = std::max(-a_, row_exit(y0 - 1));
+            coord_t hi = std::max(-a_, std::min(x_end + 1, last_x_step(y0 - 1) + 1));
+            for (coord_t yy = y0; yy < y; ++yy)
+            {
+                const bool same = (lo == hi);
+                lo = next_row(quadrant_state{ lo, 0 }, yy).x;
+                hi = same ? lo : next_row(quadrant_state{ hi, 0 }, yy).x;
+            }
+            if (lo == hi)
+                return lo;
+        }
+        coord_t x = -a_;
+        for (coord_t yy = 0; yy < y && x <= x_end; ++yy)
+            x = next_row(quadrant_state{ x, 0 }, yy).x;
+        return x;
+    }
+
+    const Path& p;
+    const coord_t a_;
+    const coord_t x_end;
+};
+
+// calls run(y, x0, x1) for the visible part [qx0 .. qx1] x [qy0 .. qy1] of the quadrant path,
+// row by row - rows and pixels outside are skipped without walking them.
+template <class Path, class RunFunc>
+inline void walk_quadrant_clipped(
+    const Path& path, const coord_t a,
+    coord_t qx0, coord_t qx1, coord_t qy0, coord_t qy1,
+    const bool with_tip, RunFunc run
+    )
+{
+    const coord_t x_end = path.x_last();
+    qx0 = std::max(qx0, -a);
+    qx1 = std::min(qx1, x_end);
+    qy0 = std::max<coord_t>(qy0, 0);
+    qy1 = std::min(qy1, path.y_max());
+    if (qx0 > qx1 || qy0 > qy1)
+        return;
+
+    const quadrant_walker<Path> walker(path, a);
+    quadrant_state s = walker.row_start(qy0);
+    coord_t y = qy0;
+    for ( ; y <= qy1 && s.x <= qx1; ++y)
+    {
+        coord_t last = 0;
+        const coord_t x0 = s.x;
+        s = walker.next_row(s, y, &last);
+        if (x0 <= x_end && std::max(x0, qx0) <= std::min(last, qx1))
+            run(y, std::max(x0, qx0), std::min(last, qx1));
+        if (s.x > x_end)
+            break;
+    }
+
+    // tip of flat ellipses: x == 0 for the rows after the loop
+    if (Path::has_tip && with_tip && s.x > x_end && qx0 <= 0 && 0 <= qx1)
+    {
+        const coord_t b = path.y_max() - 1;
+        for (coord_t yt = std::max(s.y_final + 1, qy0); yt <= std::min(b, qy1); ++yt)
+            run(yt, 0, 0);
+    }
+}
+
+}
+
+template <class BitmapImageType>
+template <class Setter, class Path>
+void zingl_image_drawer<BitmapImageType>::plotQuadrantsClipped(
+    const int xm, const int ym, const Path& path, const long long a, const bool rotated, const pixel_t color)
+{
+    using zingl_detail::coord_t;
+    // image offset of quadrant path point (x, y): (m[0]*x + m[1]*y, m[2]*x + m[3]*y)
+    static const int mirrored[4][4] = { {-1, 0, 0, 1}, {1, 0, 0, 1}, {1, 0, 0, -1}, {-1, 0, 0, -1} };
+    static const int rotations[4][4] = { {-1, 0, 0, 1}, {0, -1, -1, 0}, {1, 0, 0, -1}, {0, 1, 1, 0} };
+    const coord_t dx0 = -coord_t(xm), dx1 = coord_t(image_.width())  - 1 - xm;
+    const coord_t dy0 = -coord_t(ym), dy1 = coord_t(image_.height()) - 1 - ym;
+    SetterOf<Setter> setPixel{image_, setter_context_};
+
+    for (unsigned q = 0; q < 4; ++q)
+    {
+        const int* m = rotated ? rotations[q] : mirrored[q];
+        const bool rows = (m[1] == 0);      // path rows are image rows
+        // visible offsets -> visible rectangle in path coordinates
+        const int sx = rows ? m[0] : m[2], sy = rows ? m[3] : m[1];
+        const coord_t ox0 = rows ? dx0 : dy0, ox1 = rows ? dx1 : dy1;
+        const coord_t oy0 = rows ? dy0 : dx0, oy1 = rows ? dy1 : dx1;
+        const coord_t qx0 = std::min(sx * ox0, sx * ox1), qx1 = std::max(sx * ox0, sx * ox1);
+        const coord_t qy0 = std::min(sy * oy0, sy * oy1), qy1 = std::max(sy * oy0, sy * oy1);
+
+        zingl_detail::walk_quadrant_clipped(path, a, qx0, qx1, qy0, qy1, (q % 2) == 0,
+            [&](const coord_t y, const coord_t x0, const coord_t x1) {
+                if (rows)
+                {
+                    const int yi = ym + int(m[3] * y);
+                    int xa = xm + int(m[0] * x0), xb = xm + int(m[0] * x1);
+                    if (xa > xb)
+                        std::swap(xa, xb);
+                    pixel_t* row = image_.row(yi);
+                    setPixel.hLine(xa, xb, yi, &row[xa], &row[xb], color);
+                }
+                else
+                {
+                    const int xi = xm + int(m[1] * y);
+                    for (coord_t x = x0; x <= x1; ++x)
+                    {
+                        const int yi = ym + int(m[2] * x);
+                        setPixel(xi, yi, &image_.row(yi)[xi], color);
+                    }
+                }
+            });
+    }
+}
+
+}
@@ -0,0 +1,251 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+namespace OffScreenBitmapDraw
+{
+
+/* anti-aliased polygon fill by signed area accumulation - as in the font rasterizers:
+   each line adds, per row it crosses, the area right of it (signed by its direction)
+   to the cells of coverage_acc_ as differences. the prefix sum along a row then gives
+   the covered area of each pixel, from which the spans are set. the edges are sorted
+   by their first row and the rows resolved one after the other: a single row of
+   coverage_acc_, whatever the size of the polygon.
+   coordinates here are pixel edges: pixel x covers [x .. x+1) */
+
+template <class BitmapImageType>
+void zingl_image_drawer<BitmapImageType>::accumulateCoverageInside(
+    float x0, float y0, float x1, float y1, const int bw, const int bh)
+{
+    const float dir = (y0 < y1) ? 1.0F : -1.0F;
+    if (y0 > y1)
+    {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+    const float dxdy = (x1 - x0) / (y1 - y0);
+    const int stride = bw + 2;
+    float x = x0;
+    if (y0 < 0.0F)
+        x -= y0 * dxdy;         /* continue at row 0 */
+    const int ya = int(std::floor(std::max(y0, 0.0F)));
+    const int yb = int(std::ceil(std::min(y1, float(bh))));
+    const float fw = float(bw);
+
+    for (int y = ya; y < yb; ++y)
+    {
+        float * acc = &coverage_acc_[size_t(y) * size_t(stride)];
+        const float dy = std::min(float(y + 1), y1) - std::max(float(y), y0);
+        const float xnext = std::min(std::max(x + dxdy * dy, 0.0F), fw);    /* no rounding out of the box */
+        const float d = dy * dir;
+        const float xl = std::min(x, xnext), xr = std::max(x, xnext);
+        const float xl_floor = std::floor(xl);
+        const int xli = int(xl_floor);
+        const float xr_ceil = std::ceil(xr);
+        const int xri = int(xr_ceil);
+
+        if (xri <= xli + 1)
+        {
+            /* within one pixel: split by the mean x */
+            const float xm = 0.5F * (x + xnext) - xl_floor;
+            acc[xli]     += d - d * xm;
+            acc[xli + 1] += d * xm;
+        }
+        else
+        {
+            /* triangle in the first and the last pixel, linear in between */
+            const float s = 1.0F / (xr - xl);
+            const float xl_frac = xl - xl_floor;
+            const float a0 = 0.5F * s * (1.0F - xl_frac) * (1.0F - xl_frac);
+            const float xr_frac = xr - xr_ceil + 1.0F;
+            const float am = 0.5F * s * xr_frac * xr_frac;
+            acc[xli] += d * a0;
+            if (xri == xli + 2)
+                acc[xli + 1] += d * (1.0F - a0 - am);
+            else
+            {
+                const float a1 = s * (1.5F - xl_frac);
+                acc[xli + 1] += d * (a1 - a0);
+                for (int xi = xli + 2; xi < xri - 1; ++xi)
+                    acc[xi] += d * s;
+                const float a2 = a1 + float(xri - xli - 3) * s;
+                acc[xri - 1] += d * (1.0F - a2 - am);
+            }
+            acc[xri] += d * am;
+        }
+        x = xnext;
+    }
+}
+
+template <class BitmapImageType>
+void zingl_image_drawer<BitmapImageType>::accumulateCoverage(
+    float x0, float y0, float x1, float y1, const int bw, const int bh)
+{
+    if (y0 == y1 || (y0 >= float(bh) && y1 >= float(bh)) || (y0 <= 0.0F && y1 <= 0.0F))
+        return;
+
+    /* split where the line crosses the left and right border: the outer parts
+       move onto the border - left of the box they cover the whole row */
+    const float fw = float(bw);
+    float t[4] = { 0.0F, 1.0F, 1.0F, 1.0F };
+    int nt = 1;
+    if ((x0 < 0.0F) != (x1 < 0.0F))
+        t[nt++] = (0.0F - x0) / (x1 - x0);
+    if ((x0 > fw) != (x1 > fw))
+        t[nt++] = (fw - x0) / (x1 - x0);
+    if (nt == 3 && t[1] > t[2])
+        std::swap(t[1], t[2]);
+    t[nt] = 1.0F;
+
+    float xa = x0, ya = y0;
+    for (int i = 1; i <= nt; ++i)
+    {
+        const float xb = (i == nt) ? x1 : x0 + t[i] * (x1 - x0);
+        const float yb = (i == nt) ? y1 : y0 + t[i] * (y1 - y0);
+        if (ya != yb)
+            accumulateCoverageInside(std::min(std::max(xa, 0.0F), fw), ya,
+                                     std::min(std::max(xb, 0.0F), fw), yb, bw, bh);
+        xa = xb;
+        ya = yb;
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillPolygonAA(
+    const PointF* pts, const size_t n, const pixel_t color)
+{
+    fillPolygonRingsAA<Setter>(pts, &n, 1, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillPolygonRingsAA(
+    const PointF* pts, const size_t* ring_sizes, const size_t n_rings, const pixel_t color)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < n_rings; ++i)
+        n += ring_sizes[i];
+    if (!n)
+        return;
+
+    /* the accumulation covers the visible part of the bounding box only */
+    float xa = pts[0].first, xb = xa;
+    float ya = pts[0].second, yb = ya;
+    for (size_t i = 1; i < n; ++i)
+    {
+        xa = std::min(xa, pts[i].first);
+        xb = std::max(xb, pts[i].first);
+        ya = std::min(ya, pts[i].second);
+        yb = std::max(yb, pts[i].second);
+    }
+    const float w = float(image_.width()), h = float(image_.height());
+    /* pixel centers are at integer positions: +0.5 to the pixel edges */
+    const int ox = int(std::floor(std::min(std::max(xa + 0.5F, 0.0F), w)));
+    const int oy = int(std::floor(std::min(std::max(ya + 0.5F, 0.0F), h)));
+    const int ex = int(std::ceil(std::min(std::max(xb + 0.5F, 0.0F), w)));
+    const int ey = int(std::ceil(std::min(std::max(yb + 0.5F, 0.0F), h)));
+    const int bw = ex - ox, bh = ey - oy;
+    if (bw <= 0 || bh <= 0)
+        return;
+    coverage_acc_.assign(size_t(bw + 2), 0.0F);
+
+    /* the edges in box coordinates, by their first row */
+    const float dx = 0.5F - float(ox), dy = 0.5F - float(oy);
+    coverage_edges_.clear();
+    for (size_t r = 0; r < n_rings; pts += ring_sizes[r], ++r)
+        for (size_t i = 0; i < ring_sizes[r]; ++i)
+        {
+            const PointF& p0 = pts[i];
+            const PointF& p1 = pts[i + 1 < ring_sizes[r] ? i + 1 : 0];
+            const CoverageEdge e = { p0.first + dx, p0.second + dy, p1.first + dx, p1.second + dy, 0, 0 };
+            if (e.y0 == e.y1)
+                continue;
+            const CoverageEdge clipped = { e.x0, e.y0, e.x1, e.y1,
+                                           int(std::floor(std::max(std::min(e.y0, e.y1), 0.0F))),
+                                           int(std::ceil(std::min(std::max(e.y0, e.y1), float(bh)))) };
+            if (clipped.ya < clipped.yb)
+                coverage_edges_.push_back(clipped);
+        }
+    std::sort(coverage_edges_.begin(), coverage_edges_.end(),
+              [](const CoverageEdge& a, const CoverageEdge& b) { return a.ya < b.ya; });
+
+    /* per row: the active edges into the row, then prefix sums to coverage - which
+       clears the row for the next one */
+    SetterOf<NoClipOf<Setter> > setPixel{image_, setter_context_};
+    float * const acc = coverage_acc_.data();
+    coverage_active_.clear();
+    size_t next = 0;
+    for (int y = 0; y < bh && (next < coverage_edges_.size() || !coverage_active_.empty()); ++y)
+    {
+        for ( ; next < coverage_edges_.size() && coverage_edges_[next].ya <= y; ++next)
+            coverage_active_.push_back(coverage_edges_[next]);
+        if (coverage_active_.empty())
+        {
+            y = coverage_edges_[next].ya - 1;
+            continue;
+        }
+        const float fy = float(y);
+        for (size_t k = 0; k < coverage_active_.size(); )
+        {
+            const CoverageEdge& e = coverage_active_[k];
+            accumulateCoverage(e.x0, e.y0 - fy, e.x1, e.y1 - fy, bw, 1);
+            if (e.yb <= y + 1)
+            {
+                coverage_active_[k] = coverage_active_.back();
+                coverage_active_.pop_back();
+            }
+            else
+                ++k;
+        }
+
+        pixel_t * row = image_.row(oy + y) + ox;
+        float area = 0.0F;
+        int run = -1;           /* start of fully covered pixels */
+        for (int x = 0; x < bw; ++x)
+        {
+            area += acc[x];
+            acc[x] = 0.0F;
+            const unsigned cov = unsigned(std::min(std::fabs(area), 1.0F) * 255.0F + 0.5F);
+            if (cov == 255)
+            {
+                if (run < 0)
+                    run = x;
+                continue;
+            }
+            if (run >= 0)
+            {
+                setPixel.hLine(ox + run, ox + x - 1, oy + y, &row[run], &row[x - 1], color);
+                run = -1;
+            }
+            if (cov)
+                zingl_detail::set_coverage(setPixel, ox + x, oy + y, &row[x], color, cov);
+        }
+        if (run >= 0)
+            setPixel.hLine(ox + run, ox + bw - 1, oy + y, &row[run], &row[bw - 1], color);
+        acc[bw] = acc[bw + 1] = 0.0F;
+    }
+}
+
+}
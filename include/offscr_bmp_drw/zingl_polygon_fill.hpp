@@ -0,0 +1,186 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+namespace OffScreenBitmapDraw
+{
+
+/* scanline polygon fill with an active edge table:
+   row y samples the pixel centers (x, y). an edge covers the rows [min(y0, y1) .. max(y0, y1)),
+   its crossing with the row is stepped in integers - x + r / dy - like the Bresenham lines.
+   the pixels from the (rounded up) left crossing up to before the right crossing are inside */
+
+template <class BitmapImageType>
+void zingl_image_drawer<BitmapImageType>::addPolygonRing(const Point* pts, const size_t n)
+{
+    using zingl_detail::floor_div;
+    const int h = int(image_.height());
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Point& p0 = pts[i];
+        const Point& p1 = pts[i + 1 < n ? i + 1 : 0];
+        if (p0.second == p1.second)
+            continue;           /* horizontal: no crossing */
+
+        const bool down = p0.second < p1.second;
+        const Point& pa = down ? p0 : p1;
+        const Point& pb = down ? p1 : p0;
+        if (pb.second <= 0 || pa.second >= h)
+            continue;
+
+        PolygonEdge e;
+        e.dy = pb.second - pa.second;
+        const long long dx = (long long)pb.first - pa.first;
+        e.x_step  = int(floor_div(dx, e.dy));
+        e.r_step  = int(dx - (long long)e.x_step * e.dy);
+        e.y       = std::max(pa.second, 0);     /* starts above the image: continue at row 0 */
+        e.y_end   = pb.second;
+        const long long num = (long long)(e.y - pa.second) * dx;
+        const long long q = floor_div(num, e.dy);
+        e.x       = int(pa.first + q);
+        e.r       = int(num - q * e.dy);
+        e.winding = down ? 1 : -1;
+        polygon_edges_.push_back(e);
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillPolygonEdges(const pixel_t color, const polygon_fill_rule rule)
+{
+    std::vector<PolygonEdge>& edges = polygon_edges_;
+    std::vector<PolygonEdge>& active = active_edges_;
+    if (edges.empty())
+        return;
+    std::sort(edges.begin(), edges.end(),
+              [](const PolygonEdge& a, const PolygonEdge& b) { return a.y < b.y; });
+
+    /* the spans are clipped here already */
+    SetterOf<NoClipOf<Setter> > setPixel{image_, setter_context_};
+    const int w = int(image_.width());
+    const int h = int(image_.height());
+    const size_t n = edges.size();
+    size_t next = 0;
+    active.clear();
+
+    for (int y = edges[0].y; y < h; ++y)
+    {
+        /* drop the finished edges - keeps the order */
+        size_t k = 0;
+        for (size_t i = 0; i < active.size(); ++i)
+            if (active[i].y_end > y)
+                active[k++] = active[i];
+        active.resize(k);
+
+        if (active.empty())
+        {
+            if (next == n)
+                break;
+            y = std::max(y, edges[next].y);     /* skip the empty rows */
+        }
+
+        /* new edges - insertion sort by their crossing, as the order changes only
+           where edges cross */
+        for (; next < n && edges[next].y == y; ++next)
+            active.push_back(edges[next]);
+        for (size_t i = 1; i < active.size(); ++i)
+        {
+            const PolygonEdge e = active[i];
+            const int xe = e.x + (e.r > 0);
+            size_t j = i;
+            for (; j > 0 && active[j-1].x + (active[j-1].r > 0) > xe; --j)
+                active[j] = active[j-1];
+            active[j] = e;
+        }
+
+        /* spans from a rounded up crossing to before the next one */
+        pixel_t * row = image_.row(y);
+        int winding = 0;
+        for (size_t i = 0; i + 1 < active.size(); ++i)
+        {
+            winding += (rule == fill_even_odd) ? 1 : active[i].winding;
+            const bool inside = (rule == fill_even_odd) ? (winding & 1) != 0 : winding != 0;
+            if (!inside)
+                continue;
+            const int x0 = std::max(active[i].x + (active[i].r > 0), 0);
+            const int x1 = std::min(active[i+1].x + (active[i+1].r > 0) - 1, w - 1);
+            if (x0 <= x1)
+                setPixel.hLine(x0, x1, y, &row[x0], &row[x1], color);
+        }
+
+        /* step to the next row */
+        for (PolygonEdge& e : active)
+        {
+            e.x += e.x_step;
+            e.r += e.r_step;
+            if (e.r >= e.dy)
+            {
+                ++e.x;
+                e.r -= e.dy;
+            }
+        }
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillPolygon(
+    const Point* pts, const size_t n, const pixel_t color, const polygon_fill_rule rule)
+{
+    fillPolygonRings<Setter>(pts, &n, 1, color, rule);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::fillPolygonRings(
+    const Point* pts, const size_t* ring_sizes, const size_t n_rings,
+    const pixel_t color, const polygon_fill_rule rule)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < n_rings; ++i)
+        n += ring_sizes[i];
+    if (!n)
+        return;
+
+    /* bounding box first: most polygons of a map are completely in- or outside */
+    int xa = pts[0].first, xb = xa;
+    int ya = pts[0].second, yb = ya;
+    for (size_t i = 1; i < n; ++i)
+    {
+        xa = std::min(xa, pts[i].first);
+        xb = std::max(xb, pts[i].first);
+        ya = std::min(ya, pts[i].second);
+        yb = std::max(yb, pts[i].second);
+    }
+    if (xb <= 0 || yb <= 0 || xa >= int(image_.width()) || ya >= int(image_.height()))
+        return;         /* the right and bottom edges are not filled */
+
+    polygon_edges_.clear();
+    for (size_t i = 0; i < n_rings; pts += ring_sizes[i], ++i)
+        addPolygonRing(pts, ring_sizes[i]);
+    fillPolygonEdges<Setter>(color, rule);
+}
+
+}
@@ -0,0 +1,291 @@
+/*
+ *****************************************************************************
+ *                                                                           *
+ *                          Platform Independent                             *
+ *                    Bitmap Image Reader Writer Library                     *
+ *                                                                           *
+ * Author: Arash Partow - 2002                                               *
+ * URL: http://partow.net/programming/bitmap/index.html                      *
+ *                                                                           *
+ * Note: This library only supports 24-bits per pixel bitmap format files.   *
+ *                                                                           *
+ * Copyright notice:                                                         *
+ * Free use of the Platform Independent Bitmap Image Reader Writer Library   *
+ * is permitted under the guidelines and in accordance with the most current *
+ * version of the MIT License.                                               *
+ * http://www.opensource.org/licenses/MIT                                    *
+ *                                                                           *
+ *****************************************************************************
+*/
+
+
+#pragma once
+
+#include "zingl_image_drawer.hpp"
+
+
+namespace OffScreenBitmapDraw
+{
+
+template <class BitmapImageType>
+struct zingl_image_drawer<BitmapImageType>::LineSegmentOp
+{
+    template <class Setter>
+    pixel_t* operator()(zingl_image_drawer& drawer, Setter& setPixel, pixel_t* row0,
+                        int x0, int y0, int x1, int y1, bool first) const
+    {
+        return drawer.lineSegment(setPixel, row0, x0, y0, x1, y1, color, first);
+    }
+    /* partially visible: only the visible pixels - the next segment starts with a new row */
+    template <class Setter, class SetterNoClip>
+    pixel_t* clipped(zingl_image_drawer& drawer, Setter& setPixel, SetterNoClip& setPixelNoClip, pixel_t* row0,
+                     int x0, int y0, int x1, int y1, bool first) const
+    {
+        if (std::abs((long long)x1 - x0) >= (1LL << 30) || std::abs((long long)y1 - y0) >= (1LL << 30))
+            return drawer.lineSegment(setPixel, row0, x0, y0, x1, y1, color, first);
+        drawer.lineClipped(setPixelNoClip, x0, y0, x1, y1, color, first);
+        return nullptr;
+    }
+    const pixel_t color;
+};
+
+template <class BitmapImageType>
+struct zingl_image_drawer<BitmapImageType>::LineAASegmentOp
+{
+    template <class Setter>
+    pixel_t* operator()(zingl_image_drawer& drawer, Setter& setPixel, pixel_t* row0,
+                        int x0, int y0, int x1, int y1, bool first) const
+    {
+        return drawer.lineAASegment(setPixel, row0, x0, y0, x1, y1, color, first);
+    }
+    template <class Setter, class SetterNoClip>
+    pixel_t* clipped(zingl_image_drawer& drawer, Setter& setPixel, SetterNoClip&, pixel_t* row0,
+                     int x0, int y0, int x1, int y1, bool first) const
+    {
+        return (*this)(drawer, setPixel, row0, x0, y0, x1, y1, first);
+    }
+    const pixel_t color;
+};
+
+template <class BitmapImageType>
+template <class Setter, class Segment>
+void zingl_image_drawer<BitmapImageType>::plotPolylineSegments(
+    const Point* pts, const size_t n, const int margin, const Segment& segment)
+{
+    if (!n)
+        return;
+    SetterOf<Setter> setPixel{image_, setter_context_};
+    SetterOf<NoClipOf<Setter> > setPixelNoClip{image_, setter_context_};
+    const int w = int(image_.width()), h = int(image_.height());
+    pixel_t * row = nullptr;        /* row of the current point - if carried from the last segment */
+
+    for (size_t i = 0; i == 0 || i + 1 < n; ++i)
+    {
+        const int x0 = pts[i].first, y0 = pts[i].second;
+        const int x1 = (n > 1) ? pts[i+1].first  : x0;
+        const int y1 = (n > 1) ? pts[i+1].second : y0;
+        const int xa = std::min(x0, x1) - margin, xb = std::max(x0, x1) + margin;
+        const int ya = std::min(y0, y1) - margin, yb = std::max(y0, y1) + margin;
+        if (xb < 0 || yb < 0 || xa >= w || ya >= h)
+        {
+            row = nullptr;          /* invisible: its end point isn't visible either */
+            continue;
+        }
+        if (!row)       /* signed: y0 may be outside, the row is carried into the image */
+            row = image_.row(0) + std::ptrdiff_t(y0) * std::ptrdiff_t(image_.row_increment());
+        if (xa >= 0 && ya >= 0 && xb < w && yb < h)
+            row = segment(*this, setPixelNoClip, row, x0, y0, x1, y1, i == 0);
+        else
+            row = segment.clipped(*this, setPixel, setPixelNoClip, row, x0, y0, x1, y1, i == 0);
+    }
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotPolyline(
+    const Point* pts, const size_t n, const pixel_t color)
+{
+    plotPolylineSegments<Setter>(pts, n, 0, LineSegmentOp{ color });
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotPolylineAA(
+    const Point* pts, const size_t n, const pixel_t color)
+{
+    plotPolylineSegments<Setter>(pts, n, 1, LineAASegmentOp{ color });
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::plotPolylineWidth(
+    const Point* pts, const size_t n, float wd, const pixel_t color)
+{
+    stroke_path_.resize(n);
+    for (size_t i = 0; i < n; ++i)
+        stroke_path_[i] = PointF(float(pts[i].first), float(pts[i].second));
+    strokePolyline<Setter>(stroke_path_.data(), n, wd, color);
+}
+
+template <class BitmapImageType>
+template <class Setter>
+void zingl_image_drawer<BitmapImageType>::strokePolyline(
+    const PointF* pts, const size_t n, const float wd, const pixel_t color)
+{
+    if (!n || !(wd > 0.0F))
+        return;
+    const float r = 0.5F * (wd + 1.0F);     /* coverage > 0 below this distance */
+    const float r2 = r * r;
+    const float r_full2 = r >= 1.0F ? (r - 1.0F) * (r - 1.0F) : -1.0F;    /* fully covered below */
+    const int w = int(image_.width()), h = int(image_.height());
+    constexpr int band = 32;                /* rows resolved together */
+    const int n_bands = (h + band - 1) / band;
+
+    /* the visible segments - a single point is a segment of length 0. the pixels within
+       distance r of a segment are inside its bounding box + r and inside the band of
+       half width r along its line: per row [c - half_band .. c + half_band] */
+    stroke_segments_.clear();
+    stroke_band_start_.assign(size_t(n_bands) + 1, 0);
+    float xa = pts[0].first, xb = xa;
+    for (size_t i = 0; i == 0 || i + 1 < n; ++i)
+    {
+        const PointF& p = pts[i];
+        const PointF& q = pts[n > 1 ? i + 1 : i];
+        const float ya = std::min(p.second, q.second) - r, yb = std::max(p.second, q.second) + r;
+        if (yb < 0.0F || ya > float(h - 1)
+            || std::max(p.first, q.first) + r < 0.0F || std::min(p.first, q.first) - r > float(w - 1))
+            continue;
+        StrokeSegment s;
+        s.ax = p.first; s.ay = p.second;
+        s.dx = q.first - p.first; s.dy = q.second - p.second;
+        const float l2 = s.dx*s.dx + s.dy*s.dy;
+        s.inv_l2 = l2 > 0.0F ? 1.0F / l2 : 0.0F;
+        s.slope = s.dy != 0.0F ? s.dx / s.dy : 0.0F;
+        s.half_band = s.dy != 0.0F ? r * std::sqrt(l2) / std::fabs(s.dy) : std::numeric_limits<float>::max();
+        s.x_lo = std::max(0.0F, std::min(p.first, q.first) - r);
+        s.x_hi = std::min(float(w - 1), std::max(p.first, q.first) + r);
+        s.y0 = int(std::ceil(std::max(ya, 0.0F)));
+        s.y1 = int(std::floor(std::min(yb, float(h - 1))));
+        s.y_in0 = int(std::ceil(std::max(-1.0F, std::min(ya + 2.0F * r, float(h)))));
+        s.y_in1 = int(std::floor(std::max(-1.0F, std::min(yb - 2.0F * r, float(h)))));
+        stroke_segments_.push_back(s);
+        ++stroke_band_start_[size_t(s.y0 / band) + 1];
+        xa = std::min(xa, std::min(p.first, q.first));
+        xb = std::max(xb, std::max(p.first, q.first));
+    }
+    if (stroke_segments_.empty())
+        return;
+
+    /* squared distances of the rows of a band [x0 .. x1], r2 where no segment is near */
+    const int x0 = int(std::ceil(std::max(xa - r, 0.0F))), x1 = int(std::floor(std::min(xb + r, float(w - 1))));
+    if (x0 > x1)
+        return;
+    const std::ptrdiff_t row_len = x1 - x0 + 1;
+    stroke_row_.assign(size_t(band) * size_t(row_len), r2);
+
+    /* the segments in the order of the band of their first row: counting sort */
+    for (int b = 0; b < n_bands; ++b)
+        stroke_band_start_[size_t(b) + 1] += stroke_band_start_[size_t(b)];
+    stroke_active_.resize(stroke_segments_.size());
+    for (size_t k = 0; k < stroke_segments_.size(); ++k)
+        stroke_active_[stroke_band_start_[size_t(stroke_segments_[k].y0 / band)]++] = stroke_segments_[k];
+    stroke_segments_.swap(stroke_active_);
+    stroke_active_.clear();
+
+    SetterOf<NoClipOf<Setter> > setPixel{image_, setter_context_};
+    size_t next = 0;
+    for (int b = stroke_segments_[0].y0 / band; b < n_bands; ++b)
+    {
+        for ( ; next < stroke_band_start_[size_t(b)]; ++next)
+            stroke_active_.push_back(stroke_segments_[next]);
+        if (stroke_active_.empty())
+        {
+            if (next == stroke_segments_.size())
+                break;
+            continue;
+        }
+
+        const int ya = b * band, yb = std::min(h, ya + band) - 1;
+        int xl[band], xr[band];             /* touched pixels of the rows */
+        std::fill(xl, xl + band, x1 + 1);
+        std::fill(xr, xr + band, x0 - 1);
+        for (size_t k = 0; k < stroke_active_.size(); )
+        {
+            const StrokeSegment s = stroke_active_[k];
+            for (int y = std::max(s.y0, ya), y_end = std::min(s.y1, yb); y <= y_end; ++y)
+            {
+                const float py = float(y) - s.ay;
+                const float c = s.ax + s.slope * py;
+                const float lo = std::min(std::max(s.x_lo, c - s.half_band), float(x1 + 1));
+                const float hi = std::max(std::min(s.x_hi, c + s.half_band), float(x0 - 1));
+                int xi0 = int(lo), xi1 = int(hi);       /* ceil and floor */
+                xi0 += float(xi0) < lo;
+                xi1 -= float(xi1) > hi;
+                float * const dist = stroke_row_.data() + (y - ya) * row_len - x0;
+                if (s.y_in0 <= y && y <= s.y_in1)
+                {
+                    /* at least r from the ends: the distance to the line */
+                    float e = (float(xi0) - s.ax) * s.dy - py * s.dx;
+                    for (int x = xi0; x <= xi1; ++x, e += s.dy)
+                        dist[x] = std::min(dist[x], e*e * s.inv_l2);
+                }
+                else
+                    for (int x = xi0; x <= xi1; ++x)
+                    {
+                        const float px = float(x) - s.ax;
+                        const float t = std::min(1.0F, std::max(0.0F, (px*s.dx + py*s.dy) * s.inv_l2));
+                        const float ex = px - t*s.dx, ey = py - t*s.dy;
+                        dist[x] = std::min(dist[x], ex*ex + ey*ey);
+                    }
+                xl[y - ya] = std::min(xl[y - ya], xi0);
+                xr[y - ya] = std::max(xr[y - ya], xi1);
+            }
+            if (s.y1 <= yb)
+            {
+                stroke_active_[k] = stroke_active_.back();
+                stroke_active_.pop_back();
+            }
+            else
+                ++k;
+        }
+
+        /* resolve the rows and clear them for the next band */
+        for (int y = ya; y <= yb; ++y)
+        {
+            float * const dist = stroke_row_.data() + (y - ya) * row_len - x0;
+            pixel_t * row = image_.row(y);
+            int run = -1;           /* start of fully covered pixels */
+            for (int x = xl[y - ya]; x <= xr[y - ya] + 1; ++x)
+            {
+                unsigned cov = 0;
+                if (x <= xr[y - ya])
+                {
+                    /* a square root only for the edge pixels */
+                    const float d2 = dist[x];
+                    dist[x] = r2;
+                    if (d2 <= r_full2)
+                        cov = 255U;
+                    else if (d2 < r2)
+                    {
+                        const float c = r - std::sqrt(d2);
+                        cov = c >= 1.0F ? 255U : (c <= 0.0F ? 0U : unsigned(c * 255.0F + 0.5F));
+                    }
+                }
+                if (cov == 255)
+                {
+                    if (run < 0)
+                        run = x;
+                    continue;
+                }
+                if (run >= 0)
+                {
+                    setPixel.hLine(run, x - 1, y, &row[run], &row[x - 1], color);
+                    run = -1;
+                }
+                if (cov)
+                    zingl_detail::set_coverage(setPixel, x, y, &row[x], color, cov);
+            }
+        }
+    }
+}
+}
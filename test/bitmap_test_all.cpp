@@ -24,7 +24,7 @@
 #include <offscr_bmp_drw/response_image.hpp>
 #include <offscr_bmp_drw/sobel.hpp>
 #include <offscr_bmp_drw/convert.hpp>
-// #include <offscr_bmp_drw/misc.hpp>
+#include <offscr_bmp_drw/misc.hpp>
 
 #include <offscr_bmp_drw/colormaps.hpp>
 #include <offscr_bmp_drw/bitmap_image_generic.hpp>
@@ -33,15 +33,28 @@
 #include <offscr_bmp_drw/plasma.hpp>
 #include <offscr_bmp_drw/checkered_pattern.hpp>
 #include <offscr_bmp_drw/zingl_image_drawer.hpp>
+#include <offscr_bmp_drw/convolution.hpp>
+#include <offscr_bmp_drw/blur.hpp>
+#include <offscr_bmp_drw/integral_image.hpp>
+#include <offscr_bmp_drw/image_metrics.hpp>
+#include <offscr_bmp_drw/frame_diff.hpp>
+#include <offscr_bmp_drw/palette_index.hpp>
+#include <offscr_bmp_drw/quantize.hpp>
+#include <offscr_bmp_drw/color_conversion.hpp>
+#include <offscr_bmp_drw/pixel_shader.hpp>
+#include <offscr_bmp_drw/pattern_fill.hpp>
+#include <offscr_bmp_drw/series_plot.hpp>
 
 #include <vector>
 
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <cassert>
+#include <chrono>
 
 
 using namespace OffScreenBitmapDraw;
@@ -58,6 +71,8 @@ const std::string file_name("image.bmp");
 
 static const double pi_ = 3.14159265358979323846264338327950288419716939937510;
 
+static bool print_timings = false;  // set by the argument "timings" - see main()
+
 static rgb_t jet_like_cmap[1000];   // generate in test18(), utilized also in test23()
 static bool generated_jet_like_cmap = false;
 
@@ -349,12 +364,11 @@ void test15(bool save_as_input = false)
     Float c3 = Float(0.3);
     Float c4 = Float(0.7);
 
-    ::srand(0xA5AA5AA5);
     plasma<BitmapRGBImage, Float>(
         image,
         0, 0, image.width(), image.height(),
         c1, c2, c3, c4,
-        Float(3), jet_colormap
+        Float(3), jet_colormap, 0xA5AA5AA5
         );
     BitmapRGBImageFile::save(image, save_as_input ? file_name : "test15_plasma.bmp");
 }
@@ -942,47 +956,2276 @@ void test26()
 
         BitmapRGBImageFile::save(convert(), "test26_zingl_draw-ellipses-circle-1_float_as_rgb.bmp");
     }
+
+    // spans wider than the image on both sides are clipped, not dropped
+    {
+        BitmapFloatImage float_image(40, 30);
+        FloatDrawer draw(float_image);
+        float_image.clear(0.0F);
+        draw.fillRect<FloatDrawer::PixelSetter>(-10, 5, 49, 9, 1.0F);
+        draw.fillRect<FloatDrawer::PixelAdder>(-1, 10, 40, 14, 1.0F);
+        draw.fillRect<FloatDrawer::PixelAdder>(-5, 12, 100, 12, 1.0F);
+        unsigned num_errors = 0;
+        for (unsigned y = 0; y < float_image.height(); ++y)
+            for (unsigned x = 0; x < float_image.width(); ++x)
+            {
+                const float expected = (y >= 5 && y < 15) ? (y == 12 ? 2.0F : 1.0F) : 0.0F;
+                num_errors += float_image.pixel(x, y) != expected;
+            }
+        if (num_errors)
+            fprintf(stderr, "test26(): ERROR: fillRect() wider than the image wrong in %u pixels\n", num_errors);
+    }
 }
 
+static bool equal_images(const BitmapRGBImage& a, const BitmapRGBImage& b)
+{
+    if (a.width() != b.width() || a.height() != b.height())
+        return false;
+    for (unsigned y = 0; y < a.height(); ++y)
+        if (memcmp(a.row(y), b.row(y), a.width() * sizeof(rgb_pixel_t)))
+            return false;
+    return true;
+}
 
-const char *testDesc[] = {
-    "compile test with rgb tests",      // 0
-    "load() & save()",                  // 1
-    "vertical/horizontal_flip()",       // 2
-    "subsample_to()",                   // 3
-    "upsample_to",                      // 4
-    "set_all_ith_bits_low()",           // 5
-    "export_color_plane()",             // 6
-    "convert_to_grayscale()",           // 7
-    "copy_region_to()",                 // 8
-    "set_pixel() r/g/b jet_colormap",   // 9
-    "invert_color_planes()",            // 10
-    "add_to_color_plane()",             // 11
-    "export_ycbcr() / import_ycbcr()",  // 12
-    "export_ycbcr() / import_ycbcr()",  // 13
-    "checkered_pattern()",              // 14
-    "plasma< , double>()",              // 15
-    "alpha_blend()",                    // 16
-    "image_drawer<>::circle()/ellipse()/rectangle()",   // 17
-    "generate_colours() colormaps",     // 18
-    "cartesian_canvas<>::rectangle()/circle()", // 19
-    "mandelbrot_set_hsv()",             // 20
-    "cartesian_canvas<float>",          // 21
-    "sobel_operator()",                 // 22
-    "zingl_image_drawer<*> lines/points",       // 23
-    "zingl_image_drawer<*>::plotLineWidth()",   // 24
-    "zingl_image_drawer<*>::plotEllipses/Circle",   // 25
-    "zingl_image_drawer<*>::plot on Slices"     // 26
+void test27()
+{
+    const BitmapRGBImage image = BitmapRGBImageFile::load(file_name);
+    if (!image)
+    {
+        fprintf(stderr, "test27() - Error - Failed to open '%s'\n",file_name.c_str());
+        return;
+    }
+
+    {
+        BitmapRGBImage blurred, blurred_mt, sharpened;
+        const convolution_kernel<float> gauss = convolution_kernel<float>::gaussian(3.0F);
+        convolve(image, blurred, gauss, border_mirror);
+        convolve(image, blurred_mt, gauss, border_mirror, 0.0F, 0);
+        if (!equal_images(blurred, blurred_mt))
+            fprintf(stderr, "test27(): ERROR: multithreaded convolve() differs from single threaded\n");
+        BitmapRGBImageFile::save(blurred, "test27_convolve_gaussian.bmp");
+
+        convolve(image, sharpened, convolution_kernel<float>::sharpen(1.5F), border_clamp, 0.0F, 0);
+        BitmapRGBImageFile::save(sharpened, "test27_convolve_sharpen.bmp");
+    }
+
+    {
+        constexpr unsigned dim = 200;
+        BitmapRGBImage rgb_image(dim, dim);
+        BitmapFloatImage float_image(dim, dim), smoothed;
+        FloatDrawer draw(float_image);
+        using Setter = FloatDrawer::PixelAdder;
+        const border_mode modes[] = { border_clamp, border_mirror, border_wrap, border_constant };
+        const char * mode_names[] = { "clamp", "mirror", "wrap", "constant" };
+        const convolution_kernel<float> box = convolution_kernel<float>::box(9, 9);
+
+        for (unsigned m = 0; m < 4; ++m)
+        {
+            float_image.clear(0.1F);
+            draw.plotCircle<Setter>(5, dim / 2, dim / 3, 1.0F);
+            draw.fillCircle<Setter>(dim / 2, dim - 8, dim / 10, 1.0F);
+            convolve(float_image, smoothed, box, modes[m], 0.0F, 0);
+            const std::string fn = std::string("test27_convolve_float_border_") + mode_names[m] + ".bmp";
+            BitmapRGBImageFile::save(convert_(smoothed, rgb_image), fn);
+        }
+    }
+
+    // small image, kernel larger than the image in x: separable and dense convolution
+    // against the sum of the definition - for each border mode
+    {
+        constexpr unsigned w = 7, h = 5;
+        BitmapFloatImage src(w, h), separable, dense(w, h);
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+                src.pixel(x, y) = float((x * 7 + y * 13) % 11) - 3.0F;
+        const std::vector<float> row = { 0.5F, -1.0F, 2.0F, 0.25F, 1.5F, -0.75F, 1.0F, 0.5F, 2.0F };
+        const std::vector<float> col = { 1.0F, 0.5F, -2.0F };
+        const convolution_kernel<float> kernel = convolution_kernel<float>::outer_product(row, col);
+        std::vector<float> sep_row, sep_col;
+        if (!kernel.separate(sep_row, sep_col))
+            fprintf(stderr, "test27(): ERROR: outer product not separable\n");
+        const border_mode modes[] = { border_clamp, border_mirror, border_wrap, border_constant };
+        const char * mode_names[] = { "clamp", "mirror", "wrap", "constant" };
+        const float border_value = 0.75F;
+
+        for (unsigned m = 0; m < 4; ++m)
+        {
+            convolve(src, separable, kernel, modes[m], border_value);
+            convolution_impl<BitmapFloatImage, float>::dense_band(src, dense, kernel, modes[m], border_value, 0, h);
+            float max_sep = 0.0F, max_dense = 0.0F;
+            for (unsigned y = 0; y < h; ++y)
+                for (unsigned x = 0; x < w; ++x)
+                {
+                    float expected = 0.0F;
+                    for (unsigned j = 0; j < kernel.height(); ++j)
+                        for (unsigned i = 0; i < kernel.width(); ++i)
+                        {
+                            const int sx = border_index(int(x + i) - int(kernel.anchor_x()), int(w), modes[m]);
+                            const int sy = border_index(int(y + j) - int(kernel.anchor_y()), int(h), modes[m]);
+                            const float v = (sx < 0 || sy < 0) ? border_value : src.pixel(unsigned(sx), unsigned(sy));
+                            expected += kernel(i, j) * v;
+                        }
+                    max_sep = std::max(max_sep, std::fabs(separable.pixel(x, y) - expected));
+                    max_dense = std::max(max_dense, std::fabs(dense.pixel(x, y) - expected));
+                }
+            if (max_sep > 1E-4F || max_dense > 1E-4F)
+                fprintf(stderr, "test27(): ERROR: border %s: separable differs by %g, dense by %g\n",
+                        mode_names[m], max_sep, max_dense);
+        }
+    }
+
+    // degenerate kernels: empty is rejected, sigma <= 0 is the identity
+    {
+        BitmapFloatImage src(8, 6), dst;
+        src.clear(1.0F);
+        if (convolve(src, dst, convolution_kernel<float>()))
+            fprintf(stderr, "test27(): ERROR: convolve() accepts an empty kernel\n");
+        const std::vector<float> g0 = convolution_kernel<float>::gaussian_1d(0.0F);
+        const std::vector<float> g1 = convolution_kernel<float>::gaussian_1d(-1.0F, 2);
+        if (g0 != std::vector<float>{ 1.0F } || g1 != std::vector<float>{ 0.0F, 0.0F, 1.0F, 0.0F, 0.0F })
+            fprintf(stderr, "test27(): ERROR: gaussian_1d() with sigma <= 0 is not the identity\n");
+    }
+}
+
+void test28()
+{
+    constexpr int dim = 400;
+    BitmapRGBImage rgb_image(dim, dim);
+    BitmapFloatImage float_image(dim, dim), smoothed;
+    FloatDrawer draw(float_image);
+    using Setter = FloatDrawer::PixelAdder;
+    const float distort_scale = float(dim / 4) / float(RAND_MAX -1);
+
+    // density heatmap
+    float_image.clear(0.0F);
+    for (int k = 0; k < 20000; ++k)
+    {
+        draw.plotPoint<Setter>(randn_point(dim / 8, dim / 8, distort_scale), 1.0F);
+        draw.plotPoint<Setter>(randn_point(dim / 3, dim / 8, distort_scale / 2), 1.0F);
+    }
+    BitmapRGBImageFile::save(convert_(float_image, rgb_image), "test28_heatmap_raw.bmp");
+
+    // maximum difference to the convolution with the dense kernel - relative to its maximum
+    BitmapFloatImage reference;
+    const auto rel_diff = [&](const convolution_kernel<float>& kernel, const border_mode border) {
+        convolve(float_image, reference, kernel, border, 0.0F, 0);
+        float max_diff = 0.0F, max_value = 0.0F;
+        for (unsigned y = 0; y < unsigned(dim); ++y)
+            for (unsigned x = 0; x < unsigned(dim); ++x)
+            {
+                max_diff = std::max(max_diff, std::fabs(smoothed.pixel(x, y) - reference.pixel(x, y)));
+                max_value = std::max(max_value, std::fabs(reference.pixel(x, y)));
+            }
+        return max_diff / max_value;
+    };
+
+    box_blur(float_image, smoothed, 20, 20, border_constant, 0.0F, 0);
+    BitmapRGBImageFile::save(convert_(smoothed, rgb_image), "test28_heatmap_box_r20.bmp");
+    const float box_diff = rel_diff(convolution_kernel<float>::box(41, 41), border_constant);
+    if (box_diff > 1E-4F)
+        fprintf(stderr, "test28(): ERROR: box_blur() differs from convolve() with box kernel by %g\n", box_diff);
+
+    gaussian_blur(float_image, smoothed, 15.0F, 3, border_constant, 0.0F, 0);
+    BitmapRGBImageFile::save(convert_(smoothed, rgb_image), "test28_heatmap_gaussian_3box_s15.bmp");
+    const float box3_diff = rel_diff(convolution_kernel<float>::gaussian(15.0F, 60), border_constant);
+    if (box3_diff > 0.01F)
+        fprintf(stderr, "test28(): ERROR: gaussian_blur() differs from gaussian kernel by %g\n", box3_diff);
+
+    gaussian_blur_recursive(float_image, smoothed, 15.0F, 0);
+    BitmapRGBImageFile::save(convert_(smoothed, rgb_image), "test28_heatmap_gaussian_iir_s15.bmp");
+    const float iir_diff = rel_diff(convolution_kernel<float>::gaussian(15.0F, 60), border_clamp);
+    if (iir_diff > 0.04F)
+        fprintf(stderr, "test28(): ERROR: gaussian_blur_recursive() differs from gaussian kernel by %g\n", iir_diff);
+    printf("test28(): relative difference to dense kernel: box %g, 3 box gaussian %g, IIR gaussian %g\n",
+           box_diff, box3_diff, iir_diff);
+
+    gaussian_blur_recursive(float_image, smoothed, 50.0F, 0);
+    BitmapRGBImageFile::save(convert_(smoothed, rgb_image), "test28_heatmap_gaussian_iir_s50.bmp");
+
+    // rgb
+    gaussian_blur(rgb_image, rgb_image, 4.0F);
+    BitmapRGBImageFile::save(rgb_image, "test28_rgb_gaussian_3box_s4.bmp");
+}
+
+void test29()
+{
+    const BitmapRGBImage image = BitmapRGBImageFile::load(file_name);
+    if (!image)
+    {
+        fprintf(stderr, "test29() - Error - Failed to open '%s'\n",file_name.c_str());
+        return;
+    }
+
+    {
+        BitmapRGBImage blurred;
+        gaussian_blur(image, blurred, 2.0F);
+        const squared_difference_table<BitmapRGBImage> sqd_table(image, blurred);
+        printf("test29(): psnr(image, blurred) = %f dB\n",
+               psnr_region(sqd_table, 0, 0, image.width(), image.height()));
+        hierarchical_psnr(image, blurred, 30.0, jet_colormap);
+        BitmapRGBImageFile::save(blurred, "test29_hierarchical_psnr.bmp");
+    }
+
+    {
+        // level of detail: average of 16 x 16 tiles
+        constexpr unsigned tile = 16;
+        BitmapRGBImage lod(image);
+        const integral_image<BitmapRGBImage> ii(image);
+        for (unsigned y = 0; y + tile <= image.height(); y += tile)
+        {
+            for (unsigned x = 0; x + tile <= image.width(); x += tile)
+            {
+                rgb_pixel_t c;
+                set_rgb(c,
+                        rgb_pixel_t::component(ii.mean(x, y, tile, tile, rgb_pixel_t::offset(red_plane))),
+                        rgb_pixel_t::component(ii.mean(x, y, tile, tile, rgb_pixel_t::offset(green_plane))),
+                        rgb_pixel_t::component(ii.mean(x, y, tile, tile, rgb_pixel_t::offset(blue_plane))));
+                lod.set_region(x, y, tile, tile, c);
+            }
+        }
+        BitmapRGBImageFile::save(lod, "test29_integral_image_lod.bmp");
+    }
+}
+
+void test30()
+{
+    BitmapRGBImage image = BitmapRGBImageFile::load(file_name);
+    if (!image)
+    {
+        fprintf(stderr, "test30() - Error - Failed to open '%s'\n",file_name.c_str());
+        return;
+    }
+
+    BitmapRGBImage blurred;
+    gaussian_blur(image, blurred, 1.5F);
+
+    // per channel metrics - single and multi threaded must agree
+    const channel_values<BitmapRGBImage> mse1 = mse_per_channel(image, blurred, 1);
+    const channel_values<BitmapRGBImage> mseN = mse_per_channel(image, blurred, 0);
+    const channel_values<BitmapRGBImage> ssim1 = ssim_per_channel(image, blurred, 7, 1);
+    const channel_values<BitmapRGBImage> ssimN = ssim_per_channel(image, blurred, 7, 0);
+    const channel_values<BitmapRGBImage> psnrs = psnr_per_channel(image, blurred, 0);
+    for (unsigned c = 0; c < mse1.size(); ++c)
+    {
+        if ( mse1[c] != mseN[c] || std::fabs(ssim1[c] - ssimN[c]) > 1E-9 )
+            fprintf(stderr, "test30(): ERROR: multithreaded metrics differ from single threaded\n");
+    }
+    const unsigned r = rgb_pixel_t::offset(red_plane), g = rgb_pixel_t::offset(green_plane), b = rgb_pixel_t::offset(blue_plane);
+    printf("test30(): mse  r/g/b = %f / %f / %f\n", mse1[r], mse1[g], mse1[b]);
+    printf("test30(): psnr r/g/b = %f / %f / %f dB, psnr = %f dB\n", psnrs[r], psnrs[g], psnrs[b], psnr(image, blurred));
+    printf("test30(): ssim r/g/b = %f / %f / %f, ssim = %f, ssim(image, image) = %f\n",
+           ssim1[r], ssim1[g], ssim1[b], ssim(image, blurred), ssim(image, image));
+
+    // brute force reference
+    {
+        double sum[3] = { 0, 0, 0 };
+        for (unsigned y = 0; y < image.height(); ++y)
+            for (unsigned x = 0; x < image.width(); ++x)
+                for (unsigned c = 0; c < 3; ++c)
+                {
+                    const double d = double(cbegin(image.row(y)[x])[c]) - double(cbegin(blurred.row(y)[x])[c]);
+                    sum[c] += d * d;
+                }
+        const double n = double(image.width()) * image.height();
+        for (unsigned c = 0; c < 3; ++c)
+            if ( std::fabs(sum[c] / n - mse1[c]) > 1E-9 )
+                fprintf(stderr, "test30(): ERROR: mse_per_channel() differs from reference\n");
+    }
+
+    // slices: quadrant of image vs. quadrant of blurred
+    {
+        const unsigned d2 = image.width() / 2, h2 = image.height() / 2;
+        BitmapRGBImage sliceA(Slice{}, image, d2, h2), sliceB(Slice{}, blurred, d2, h2);
+        const double psnr_slice = psnr(sliceA, sliceB, 0);
+        const double psnr_reg = psnr_region(sliceA.width(), sliceA.height(), image, d2, h2, blurred, d2, h2);
+        const double psnr_xy = psnr(d2, h2, sliceA, blurred);
+        if ( psnr_slice != psnr_reg || psnr_slice != psnr_xy )
+            fprintf(stderr, "test30(): ERROR: psnr() on slices differs from psnr_region()\n");
+        printf("test30(): psnr of lower right quadrant = %f dB, ssim = %f\n", psnr_slice, ssim(sliceA, sliceB, 7, 0));
+    }
+
+    // float images: peak / dynamic range 1
+    {
+        BitmapFloatImage fa(image.width(), image.height()), fb(image.width(), image.height());
+        for (unsigned y = 0; y < image.height(); ++y)
+            for (unsigned x = 0; x < image.width(); ++x)
+            {
+                fa.row(y)[x] = float(image.row(y)[x].green) / 255.0F;
+                fb.row(y)[x] = float(blurred.row(y)[x].green) / 255.0F;
+            }
+        printf("test30(): float psnr = %f dB, ssim = %f\n",
+               psnr_per_channel(fa, fb, 0, 1.0)[0], ssim(fa, fb, 7, 0, 1.0));
+    }
+}
+
+void test31()
+{
+    constexpr unsigned w = 500, h = 300;
+    BitmapRGBImage prev(w, h), cur(w, h);
+    rgb_pixel_t white, red, blue;
+    set_rgb(white, 255, 255, 255);
+    set_rgb(red, 255, 0, 0);
+    set_rgb(blue, 0, 0, 255);
+
+    prev.clear(white);
+    {
+        RGBDrawer draw(prev);
+        draw.fillCircle(100, 100, 40, blue);
+        draw.plotLine(0, h - 1, w - 1, 0, blue);
+    }
+    cur = prev;
+    {
+        RGBDrawer draw(cur);
+        draw.fillCircle(100, 100, 20, red);         // inside a few tiles
+        draw.fillRect(250, 200, 480, 215, red);     // wide run
+        draw.plotPoint(w - 1, h - 1, red);          // partial corner tile
+    }
+
+    const std::vector<dirty_rect> rects = dirty_rectangles(prev, cur, 32, 32, 1);
+    const std::vector<dirty_rect> rects_mt = dirty_rectangles(prev, cur, 32, 32, 0);
+    if ( rects.size() != rects_mt.size() || !dirty_rectangles(cur, cur).empty() )
+        fprintf(stderr, "test31(): ERROR: unexpected dirty_rectangles() result\n");
+    printf("test31(): %u dirty rectangles\n", unsigned(rects.size()));
+    for (const dirty_rect& r : rects)
+        printf("test31():   x %u y %u  w %u h %u\n", r.x, r.y, r.width, r.height);
+
+    // shipping only the dirty rectangles reproduces the current frame
+    BitmapRGBImage updated;
+    updated = prev;
+    copy_rectangles(cur, updated, rects);
+    if (!equal_images(updated, cur))
+        fprintf(stderr, "test31(): ERROR: copy_rectangles() does not reproduce the current frame\n");
+
+    RGBDrawer draw(cur);
+    for (const dirty_rect& r : rects)
+        draw.plotRect(r.x, r.y, r.x + r.width - 1, r.y + r.height - 1, blue);
+    BitmapRGBImageFile::save(cur, "test31_dirty_rectangles.bmp");
+}
+
+void test32()
+{
+    const BitmapRGBImage image = BitmapRGBImageFile::load(file_name);
+    if (!image)
+    {
+        fprintf(stderr, "test32() - Error - Failed to open '%s'\n",file_name.c_str());
+        return;
+    }
+
+    BitmapRGBImage r90, r180, r270, tmp, tmp2;
+    image.rotate_to(r90, 90);
+    image.rotate_to(r180, 180);
+    image.rotate_to(r270, -90);
+    BitmapRGBImageFile::save(r90, "test32_rotate_90.bmp");
+    BitmapRGBImageFile::save(r180, "test32_rotate_180.bmp");
+    BitmapRGBImageFile::save(r270, "test32_rotate_270.bmp");
+
+    // rotation 90 == transpose + horizontal flip
+    image.transpose_to(tmp);
+    BitmapRGBImageFile::save(tmp, "test32_transpose.bmp");
+    if (!equal_images(tmp.horizontal_flip(), r90))
+        fprintf(stderr, "test32(): ERROR: rotate_to(90) differs from transpose_to() + horizontal_flip()\n");
+
+    // 180 == both flips, 2 x 90 == 180, 90 + 270 == identity
+    tmp = image;
+    if (!equal_images(tmp.horizontal_flip().vertical_flip(), r180))
+        fprintf(stderr, "test32(): ERROR: rotate_to(180) differs from horizontal_flip() + vertical_flip()\n");
+    r90.rotate_to(tmp, 90);
+    if (!equal_images(tmp, r180))
+        fprintf(stderr, "test32(): ERROR: 2 x rotate_to(90) differs from rotate_to(180)\n");
+    r90.rotate_to(tmp, 270);
+    if (!equal_images(tmp, image))
+        fprintf(stderr, "test32(): ERROR: rotate_to(90) + rotate_to(270) is not the identity\n");
+
+    // reflective_image() with and without diagonal tiles
+    tmp.reflective_image(tmp2, true);
+    BitmapRGBImageFile::save(tmp2, "test32_reflective_image.bmp");
+    tmp.reflective_image(tmp2);
+    BitmapRGBImageFile::save(tmp2, "test32_reflective_image_no_diag.bmp");
+}
+
+void test33()
+{
+    constexpr int dim = 512;
+    BitmapFloatImage float_image(dim, dim);
+    BitmapRGBImage rgb_image(dim, dim), rgb_image_mt(dim, dim);
+    FloatDrawer draw(float_image);
+    using Setter = FloatDrawer::PixelAdder;
+    const float distort_scale = float(dim / 4) / float(RAND_MAX -1);
+    generate_jet_like_colormap();
+
+    // a stream of frames: the range of the previous frame is reused - one pass per frame
+    colormap_range<float> range;
+    float_image.clear(0.0F);
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        for (int k = 0; k < 5000; ++k)
+            draw.plotPoint<Setter>(randn_point(dim / 3, dim / 4, distort_scale), 1.0F);
+        const float prev_max = range.max;
+        const bool was_valid = range.valid;
+        convert_float_to_rgb<rgb_t, BitmapFloatImage, BitmapRGBImage>(
+            float_image, rgb_image, jet_like_cmap, 1000, 1.0F, false, 0, &range);
+        printf("test33(): frame %d: range %s, next range [%f .. %f]\n",
+               frame, was_valid ? "reused" : "scanned", range.min, range.max);
+        if ( !range.valid || (was_valid && range.max < prev_max) )
+            fprintf(stderr, "test33(): ERROR: unexpected colormap_range<> update\n");
+    }
+    BitmapRGBImageFile::save(rgb_image, "test33_colormap_reused_range.bmp");
+
+    // without reuse: single and multi threaded must agree
+    convert_float_to_rgb<rgb_t, BitmapFloatImage, BitmapRGBImage>(
+        float_image, rgb_image, jet_like_cmap, 1000, 0.75F, false, 1);
+    convert_float_to_rgb<rgb_t, BitmapFloatImage, BitmapRGBImage>(
+        float_image, rgb_image_mt, jet_like_cmap, 1000, 0.75F, false, 0);
+    if (!equal_images(rgb_image, rgb_image_mt))
+        fprintf(stderr, "test33(): ERROR: multithreaded convert_float_to_rgb() differs from single threaded\n");
+    BitmapRGBImageFile::save(rgb_image, "test33_colormap.bmp");
+}
+
+void test34()
+{
+    constexpr int dim = 512;
+    BitmapFloatImage float_image(dim, dim);
+    BitmapRGBImage rgb_image(dim, dim);
+    FloatDrawer draw(float_image);
+    using Setter = FloatDrawer::PixelAdder;
+    const float distort_scale = float(dim / 4) / float(RAND_MAX -1);
+    generate_jet_like_colormap();
+
+    float_image.clear(0.0F);
+    for (int k = 0; k < 40000; ++k)
+        draw.plotPoint<Setter>(randn_point(dim / 2, dim / 2, distort_scale), 1.0F);
+    gaussian_blur(float_image, float_image, 2.0F);
+    // a few hot pixels
+    draw.plotPoint<Setter>(10, 10, 1000.0F);
+    draw.plotPoint<Setter>(dim - 10, 20, 500.0F);
+
+    const char * scale_names[] = { "linear", "sqrt", "log", "equalize" };
+    colormap_scaling<float> scaling;
+    colormap_range<float> range;
+    for (int clip = 0; clip < 2; ++clip)
+    {
+        scaling.low_percentile  = clip ? 1.0F : 0.0F;
+        scaling.high_percentile = clip ? 99.5F : 100.0F;
+        for (int m = 0; m < 4; ++m)
+        {
+            scaling.scale = colormap_scale(m);
+            convert_float_to_rgb_scaled(float_image, rgb_image, jet_like_cmap, 1000, scaling, 0, &range);
+            printf("test34(): %-8s clip %d: range [%f .. %f]\n", scale_names[m], clip, range.min, range.max);
+            const std::string fn = std::string("test34_autoscale_") + scale_names[m] + (clip ? "_clipped" : "") + ".bmp";
+            BitmapRGBImageFile::save(rgb_image, fn);
+        }
+        if ( clip && range.max >= 500.0F )
+            fprintf(stderr, "test34(): ERROR: percentile clipping did not remove the hot pixels\n");
+    }
+
+    // the pixel count per sample is a multiple of the width: all columns still get samples
+    {
+        BitmapFloatImage columns(256, 256);
+        for (unsigned y = 0; y < columns.height(); ++y)
+            for (unsigned x = 0; x < columns.width(); ++x)
+                columns.pixel(x, y) = float(x);
+        float lo = 0.0F, hi = 0.0F;
+        if (!sample_percentiles(columns, 10.0F, 90.0F, 256, lo, hi) || lo < 15.0F || lo > 40.0F || hi < 215.0F || hi > 240.0F)
+            fprintf(stderr, "test34(): ERROR: sampled percentiles [%f .. %f] of the columns 0 .. 255\n", lo, hi);
+    }
+}
+
+void test35()
+{
+    BitmapRGBImage image = BitmapRGBImageFile::load(file_name);
+    if (!image)
+    {
+        fprintf(stderr, "test35() - Error - Failed to open '%s'\n",file_name.c_str());
+        return;
+    }
+
+    const palette_index<rgb_t> palette(palette_colormap);
+    bitmap_image_generic<unsigned char> indices;
+    remap_to_palette(image, palette, indices, 0);
+
+    // compare with the linear search
+    unsigned mismatches = 0;
+    for (unsigned y = 0; y < image.height(); y += 7)
+    {
+        for (unsigned x = 0; x < image.width(); x += 3)
+        {
+            rgb_t c;
+            set_rgb(c, image.row(y)[x].red, image.row(y)[x].green, image.row(y)[x].blue);
+            const rgb_t ref = find_nearest_color(c, palette_colormap);
+            const rgb_t& p = palette.color(indices.row(y)[x]);
+            if (weighted_distance(ref, c) != weighted_distance(p, c))
+                ++mismatches;
+        }
+    }
+    if (mismatches)
+        fprintf(stderr, "test35(): ERROR: %u palette lookups differ from find_nearest_color()\n", mismatches);
+
+    remap_to_palette(image, palette, 0);
+    BitmapRGBImageFile::save(image, "test35_remap_to_palette.bmp");
+}
+
+void test36()
+{
+    const BitmapRGBImage image = BitmapRGBImageFile::load(file_name);
+    if (!image)
+    {
+        fprintf(stderr, "test36() - Error - Failed to open '%s'\n",file_name.c_str());
+        return;
+    }
+
+    BitmapRGBImage quantized;
+    bitmap_image_generic<unsigned char> indices;
+    for (unsigned kmeans_iterations = 0; kmeans_iterations <= 3; kmeans_iterations += 3)
+    {
+        const std::vector<rgb_t> colors = median_cut_palette(image, 16, kmeans_iterations, 0);
+        const palette_index<rgb_t> palette(colors.data(), colors.size());
+        remap_to_palette(image, palette, indices, 0);
+        indices_to_image(indices, colors, quantized);
+        printf("test36(): %u colors, %u k-means iterations: psnr = %f dB\n",
+               unsigned(colors.size()), kmeans_iterations, psnr(image, quantized));
+    }
+    BitmapRGBImageFile::save(quantized, "test36_quantized_16.bmp");
+
+    const std::vector<rgb_t> colors = median_cut_palette(image, 8);
+    const palette_index<rgb_t> palette(colors.data(), colors.size());
+    dither_ordered(image, palette, indices, 48, 0);
+    indices_to_image(indices, colors, quantized);
+    BitmapRGBImageFile::save(quantized, "test36_dither_bayer_8.bmp");
+
+    dither_floyd_steinberg(image, palette, indices);
+    indices_to_image(indices, colors, quantized);
+    BitmapRGBImageFile::save(quantized, "test36_dither_floyd_steinberg_8.bmp");
+}
+
+void test37()
+{
+    constexpr unsigned w = 720, h = 256;
+    BitmapRGBImage image(w, h), fixed_image(w, h), hsl_image(w, h);
+    std::vector< HSV_f<float> > hsv(w);
+    std::vector< HSL_f<float> > hsl(w);
+    std::vector<uint16_t> hue_fixed(w);
+    std::vector<uint8_t> sat_fixed(w), val_fixed(w);
+    int max_diff = 0, max_diff_fixed = 0, max_diff_roundtrip = 0;
+
+    for (unsigned y = 0; y < h; ++y)
+    {
+        // upper half: saturation 0 -> 1, lower half: value 1 -> 0
+        const float s = (y < h / 2) ? float(y) / float(h / 2) : 1.0F;
+        const float v = (y < h / 2) ? 1.0F : float(h - 1 - y) / float(h / 2 - 1);
+        for (unsigned x = 0; x < w; ++x)
+        {
+            hsv[x] = HSV_f<float>{ float(x) * 0.5F - 720.0F, s, v };   // hue outside [0 .. 360) is wrapped
+            hsl[x] = HSL_f<float>{ float(x) * 0.5F, 1.0F, float(h - 1 - y) / float(h - 1) };
+            hue_fixed[x] = uint16_t(x * 1536 / w);
+            sat_fixed[x] = uint8_t(s * 255.0F + 0.5F);
+            val_fixed[x] = uint8_t(v * 255.0F + 0.5F);
+        }
+        rgb_pixel_t* row = image.row(y);
+        hsv_to_pixels(hsv.data(), row, w);
+        hsv_to_pixels_fixed(hue_fixed.data(), sat_fixed.data(), val_fixed.data(), fixed_image.row(y), w);
+        hsl_to_pixels(hsl.data(), hsl_image.row(y), w);
+
+        std::vector< HSV_f<float> > back(w);
+        std::vector<rgb_pixel_t> back_rgb(w);
+        pixels_to_hsv(row, back.data(), w);
+        hsv_to_pixels(back.data(), back_rgb.data(), w);
+        for (unsigned x = 0; x < w; ++x)
+        {
+            rgb_pixel_t ref;
+            set_hsv(ref, hsv[x]);
+            for (int c = 0; c < 3; ++c)
+            {
+                max_diff = std::max(max_diff, std::abs(int(cbegin(ref)[c]) - int(cbegin(row[x])[c])));
+                max_diff_fixed = std::max(max_diff_fixed, std::abs(int(cbegin(fixed_image.row(y)[x])[c]) - int(cbegin(row[x])[c])));
+                max_diff_roundtrip = std::max(max_diff_roundtrip, std::abs(int(cbegin(back_rgb[x])[c]) - int(cbegin(row[x])[c])));
+            }
+        }
+    }
+    printf("test37(): max. difference to set_hsv() %d, fixed point %d, rgb -> hsv -> rgb %d\n",
+           max_diff, max_diff_fixed, max_diff_roundtrip);
+    if (max_diff > 1 || max_diff_fixed > 2 || max_diff_roundtrip > 1)
+        fprintf(stderr, "test37(): ERROR: batch conversion differs too much\n");
+    BitmapRGBImageFile::save(image, "test37_hsv_to_pixels.bmp");
+    BitmapRGBImageFile::save(fixed_image, "test37_hsv_to_pixels_fixed.bmp");
+    BitmapRGBImageFile::save(hsl_image, "test37_hsl_to_pixels.bmp");
+}
+
+void test38()
+{
+    const unsigned fractal_width  = 1200;
+    const unsigned fractal_height =  800;
+    const unsigned max_iterations = 1000;
+
+    const auto mandelbrot = [=](const unsigned x, const unsigned y) -> rgb_pixel_t {
+        const double cr = 1.5 * (2.0 * x / fractal_width  - 1.0) - 0.5;
+        const double ci =       (2.0 * y / fractal_height - 1.0);
+        double zr = 0.0, zi = 0.0;
+        for (unsigned i = 0; i < max_iterations; ++i)
+        {
+            const double t = zr * zr - zi * zi + cr;
+            zi = 2.0 * zr * zi + ci;
+            zr = t;
+            if (zr * zr + zi * zi > 4.0)
+                return rgb_pixel_t(jet_colormap[(i * 10) % 1000]);
+        }
+        return rgb_pixel_t(0, 0, 0);
+    };
+
+    BitmapRGBImage fractal(fractal_width, fractal_height);
+    BitmapRGBImage fractal_mt(fractal_width, fractal_height);
+    transform_pixels(fractal, mandelbrot);
+    transform_pixels(fractal_mt, mandelbrot, 0, pixel_tiling(128, 8));
+    if (std::memcmp(fractal.row(0), fractal_mt.row(0), sizeof(rgb_pixel_t) * fractal_width * fractal_height))
+        fprintf(stderr, "test38(): ERROR: multi-threaded transform_pixels() differs from single-threaded\n");
+
+    // darken a slice with the batch form - pixels outside the slice stay untouched
+    {
+        BitmapRGBImage slice(Slice(), fractal_mt, 300, 200, 600, 400);
+        for_each_pixel_span(slice, [](rgb_pixel_t* span, unsigned, unsigned, const unsigned n) {
+            for (unsigned i = 0; i < n; ++i)
+            {
+                *red(span[i])   /= 2;
+                *green(span[i]) /= 2;
+                *blue(span[i])  /= 2;
+            }
+        }, 0);
+    }
+    unsigned num_errors = 0;
+    for (unsigned y = 0; y < fractal_height; ++y)
+        for (unsigned x = 0; x < fractal_width; ++x)
+        {
+            const bool inside = (x >= 300 && x < 900 && y >= 200 && y < 600);
+            const rgb_pixel_t p = fractal.get_pixel(x, y);
+            const rgb_pixel_t q = fractal_mt.get_pixel(x, y);
+            if (*red(q) != (inside ? *red(p) / 2 : *red(p)) || *blue(q) != (inside ? *blue(p) / 2 : *blue(p)))
+                ++num_errors;
+        }
+    if (num_errors)
+        fprintf(stderr, "test38(): ERROR: for_each_pixel_span() on Slice: %u wrong pixels\n", num_errors);
+
+    // distance field in cartesian coordinates: rings around the origin
+    cartesian_canvas<BitmapRGBImage> canvas(800, 600);
+    transform_pixels(canvas, [](const double x, const double y) -> rgb_pixel_t {
+        const double d = std::sqrt(x * x + y * y);
+        return rgb_pixel_t(hsv_colormap[unsigned(d * 4.0) % 1000]);
+    }, 0);
+    const rgb_pixel_t center = canvas.image().get_pixel(400, 300);
+    const rgb_pixel_t expected(hsv_colormap[0]);
+    if (*red(center) != *red(expected) || *green(center) != *green(expected) || *blue(center) != *blue(expected))
+        fprintf(stderr, "test38(): ERROR: cartesian origin is not at the canvas center\n");
+
+    BitmapRGBImageFile::save(fractal_mt, "test38_transform_pixels_mandelbrot.bmp");
+    BitmapRGBImageFile::save(canvas.image(), "test38_transform_pixels_canvas.bmp");
+}
+
+void test39()
+{
+    using Float = double;
+    BitmapRGBImage plasma_st(1000, 600), plasma_mt(1000, 600);
+    plasma<BitmapRGBImage, Float>(plasma_st, 0.9, 0.5, 0.3, 0.7, 3.0, jet_colormap, 42, 1);
+    plasma<BitmapRGBImage, Float>(plasma_mt, 0.9, 0.5, 0.3, 0.7, 3.0, jet_colormap, 42, 0);
+    if (std::memcmp(plasma_st.row(0), plasma_mt.row(0), sizeof(rgb_pixel_t) * plasma_st.width() * plasma_st.height()))
+        fprintf(stderr, "test39(): ERROR: plasma() depends on the number of threads\n");
+
+    BitmapRGBImage plasma_other(1000, 600);
+    plasma<BitmapRGBImage, Float>(plasma_other, 0.9, 0.5, 0.3, 0.7, 3.0, jet_colormap, 43, 0);
+    if (!std::memcmp(plasma_st.row(0), plasma_other.row(0), sizeof(rgb_pixel_t) * plasma_st.width() * plasma_st.height()))
+        fprintf(stderr, "test39(): ERROR: plasma() ignores the seed\n");
+
+    // corners keep (approximately) their values
+    const rgb_pixel_t top_left = plasma_st.get_pixel(0, 0);
+    const rgb_pixel_t expected(jet_colormap[900]);
+    if (std::abs(int(*blue(top_left)) - int(*blue(expected))) > 16 || std::abs(int(*red(top_left)) - int(*red(expected))) > 16)
+        fprintf(stderr, "test39(): ERROR: top left corner color far off from c1\n");
+
+    BitmapRGBImageFile::save(plasma_st, "test39_plasma_seed42.bmp");
+    BitmapRGBImageFile::save(plasma_other, "test39_plasma_seed43.bmp");
+}
+
+// Setter without coverage(): anti-aliased pixels fall back to operator() with the scaled color
+struct NoCoverageSetter
+{
+    NoCoverageSetter(BitmapRGBImage& image) : setter_(image) { }
+    inline void operator()(int x, int y, rgb_pixel_t* pos, rgb_pixel_t value) { setter_(x, y, pos, value); }
+    inline void hLine(int x0, int x1, int y, rgb_pixel_t* pos0, rgb_pixel_t* pos1, rgb_pixel_t value)
+    {
+        setter_.hLine(x0, x1, y, pos0, pos1, value);
+    }
+    inline void hLineCorners(int x0, int x1, int y, rgb_pixel_t* pos0, rgb_pixel_t* pos1, rgb_pixel_t value)
+    {
+        setter_.hLineCorners(x0, x1, y, pos0, pos1, value);
+    }
+private:
+    RGBDrawer::PixelSetter setter_;
 };
 
-int main(int argc, char* argv[])
+void test40()
 {
-    const int last_testno = 26;
+    rgb_pixel_t dark, light, line;
+    set_rgb(dark, 40, 40, 60);
+    set_rgb(light, 220, 220, 200);
+    set_rgb(line, 200, 30, 30);
+
+    BitmapRGBImage image(640, 480);
+    pixel_pattern<rgb_pixel_t> checkered = pixel_pattern<rgb_pixel_t>::checkered(24, 16, dark, light);
+    pattern_fill(image, checkered, 5, 3);
+    unsigned num_errors = 0;
+    for (unsigned y = 0; y < image.height(); ++y)
+        for (unsigned x = 0; x < image.width(); ++x)
+        {
+            const bool is_light = ( ((x + 5) / 24) + ((y + 3) / 16) ) & 1;
+            const rgb_pixel_t p = image.get_pixel(x, y);
+            if (*red(p) != (is_light ? *red(light) : *red(dark)))
+                ++num_errors;
+        }
+    if (num_errors)
+        fprintf(stderr, "test40(): ERROR: pattern_fill() checkered: %u wrong pixels\n", num_errors);
+    BitmapRGBImageFile::save(image, "test40_pattern_checkered.bmp");
+
+    // patterns in four quadrants via slices
+    pixel_pattern<rgb_pixel_t> patterns[4] = {
+        pixel_pattern<rgb_pixel_t>::stripes(6, 10, line, light),
+        pixel_pattern<rgb_pixel_t>::stripes(3, 5, dark, light, false),
+        pixel_pattern<rgb_pixel_t>::grid(20, 20, 2, dark, light),
+        pixel_pattern<rgb_pixel_t>::hatch(12, 3, line, light)
+    };
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        BitmapRGBImage quadrant(Slice(), image, (i % 2) * 320, (i / 2) * 240, 320, 240);
+        pattern_fill(quadrant, patterns[i]);
+    }
+    BitmapRGBImageFile::save(image, "test40_pattern_quadrants.bmp");
+
+    // shapes filled with a pattern through the drawer's Setter policy
+    image.clear();
+    pixel_pattern<rgb_pixel_t> hatch = pixel_pattern<rgb_pixel_t>::hatch(10, 2, line, light, false);
+    hatch.reserve_span(image.width());
+    RGBDrawer drawer(image, &hatch);
+    drawer.fillCircle< pattern_setter<BitmapRGBImage> >(320, 240, 200, dark);
+    drawer.fillRect< pattern_setter<BitmapRGBImage> >(-20, -20, 100, 80, dark);
+    num_errors = 0;
+    for (unsigned y = 0; y <= 80; ++y)
+        for (unsigned x = 0; x <= 100; ++x)
+        {
+            const rgb_pixel_t p = image.get_pixel(x, y);
+            if (*red(p) != *red(hatch.at(x, y)) || *green(p) != *green(hatch.at(x, y)))
+                ++num_errors;
+        }
+    if (num_errors)
+        fprintf(stderr, "test40(): ERROR: pattern_setter: %u wrong pixels\n", num_errors);
+    BitmapRGBImageFile::save(image, "test40_pattern_setter.bmp");
+
+    // pattern reserved for a narrower image: the spans are copied in pieces.
+    // without pattern - or with a setter context of another type - the color is drawn
+    {
+        pixel_pattern<rgb_pixel_t> stripes = pixel_pattern<rgb_pixel_t>::stripes(5, 4, line, light);
+        stripes.reserve_span(16);
+        const int other_context = 0;
+        image.clear();
+        drawer.setSetterContext(&stripes);
+        drawer.fillRect< pattern_setter<BitmapRGBImage> >(-10, 10, 700, 20, dark);
+        drawer.setSetterContext(nullptr);
+        drawer.fillRect< pattern_setter<BitmapRGBImage> >(-10, 30, 700, 30, dark);
+        drawer.setSetterContext(&other_context);
+        drawer.fillRect< pattern_setter<BitmapRGBImage> >(-10, 40, 700, 40, dark);
+        drawer.setSetterContext(&hatch);
+        num_errors = 0;
+        for (unsigned x = 0; x < image.width(); ++x)
+        {
+            num_errors += *red(image.get_pixel(x, 15)) != *red(stripes.at(x, 15));
+            num_errors += *red(image.get_pixel(x, 30)) != *red(dark);
+            num_errors += *red(image.get_pixel(x, 40)) != *red(dark);
+        }
+        if (num_errors)
+            fprintf(stderr, "test40(): ERROR: pattern_setter with narrow pattern / without pattern: %u wrong pixels\n", num_errors);
+    }
+
+    // anti-aliased: covered pixels get the pattern, edge pixels blend it over the background
+    {
+        image.clear();
+        const RGBDrawer::PointF triangle[3] = { {20.3F, 10.6F}, {300.2F, 60.1F}, {80.7F, 200.4F} };
+        unsigned num_full = 0, num_partial = 0;
+        num_errors = 0;
+        drawer.fillPolygonAA< pattern_setter<BitmapRGBImage> >(triangle, 3, dark);
+        drawer.plotLineWidth< pattern_setter<BitmapRGBImage> >(350, 20, 600, 300, 5.0F, dark);
+        drawer.plotLineAA< pattern_setter<BitmapRGBImage> >(350, 300, 600, 50, dark);
+        for (unsigned y = 0; y <= 210; ++y)
+            for (unsigned x = 0; x <= 310; ++x)
+            {
+                const rgb_pixel_t p = image.get_pixel(x, y);
+                const rgb_pixel_t q = hatch.at(x, y);
+                if (*red(p) == *red(q) && *green(p) == *green(q))
+                    ++num_full;
+                else if (*red(p) || *green(p))
+                    ++num_partial;
+                if (*red(p) > *red(q) || *green(p) > *green(q))
+                    ++num_errors;
+            }
+        if (num_errors || num_full < 20000 || num_partial < 400)
+            fprintf(stderr, "test40(): ERROR: anti-aliased pattern_setter: %u full, %u partial, %u wrong pixels\n",
+                    num_full, num_partial, num_errors);
+        BitmapRGBImageFile::save(image, "test40_pattern_setter_aa.bmp");
+
+        BitmapRGBImage image2(image.width(), image.height());
+        RGBDrawer drawer2(image2);
+        image.clear();
+        image2.clear();
+        drawer.fillPolygonAA<RGBDrawer::PixelSetter>(triangle, 3, line);
+        drawer.plotLineWidth<RGBDrawer::PixelSetter>(350, 20, 600, 300, 5.0F, line);
+        drawer2.fillPolygonAA<NoCoverageSetter>(triangle, 3, line);
+        drawer2.plotLineWidth<NoCoverageSetter>(350, 20, 600, 300, 5.0F, line);
+        if (!equal_images(image, image2))
+            fprintf(stderr, "test40(): ERROR: Setter without coverage() differs from PixelSetter\n");
+    }
+}
+
+// the clipped setter without its NoClip fast path: every pixel is bounds checked.
+// derived setters don't inherit the NoClip variant of their base
+struct AlwaysClippedSetter : RGBDrawer::PixelSetterClippedUsingXY
+{
+    AlwaysClippedSetter(BitmapRGBImage& image) : RGBDrawer::PixelSetterClippedUsingXY(image) { }
+};
+
+// counts the pixels and spans it gets
+struct CountingSetter : RGBDrawer::PixelSetterClippedUsingXY
+{
+    CountingSetter(BitmapRGBImage& image) : RGBDrawer::PixelSetterClippedUsingXY(image) { }
+
+    void operator()(int x, int y, rgb_pixel_t* pos, rgb_pixel_t value)
+    {
+        ++num_pixels;
+        RGBDrawer::PixelSetterClippedUsingXY::operator()(x, y, pos, value);
+    }
+
+    void hLine(int x0, int x1, int y, rgb_pixel_t* pos0, rgb_pixel_t* pos1, rgb_pixel_t value)
+    {
+        ++num_spans;
+        RGBDrawer::PixelSetterClippedUsingXY::hLine(x0, x1, y, pos0, pos1, value);
+    }
+
+    static unsigned num_pixels, num_spans;
+};
+
+unsigned CountingSetter::num_pixels = 0, CountingSetter::num_spans = 0;
+
+template <class Setter>
+static void draw_test41_primitives(BitmapRGBImage& image)
+{
+    RGBDrawer drawer(image);
+    rgb_pixel_t color;
+    counter_rng rng(41);
+    const int w = int(image.width()), h = int(image.height());
+    for (unsigned i = 0; i < 400; ++i)
+    {
+        // about half of the primitives cross the image border
+        const int x = int(rng(4 * i) % unsigned(w + 80)) - 40;
+        const int y = int(rng(4 * i + 1) % unsigned(h + 80)) - 40;
+        const int r = 1 + int(rng(4 * i + 2) % 40U);
+        set_rgb(color, uint8_t(rng(4 * i + 3)), uint8_t(rng(4 * i + 3) >> 8), uint8_t(rng(4 * i + 3) >> 16));
+        switch (i % 12)
+        {
+        case  0: drawer.plotCross<Setter>(x, y, color); break;
+        case  1: drawer.plotRect<Setter>(x - r, y - r, x + r, y + r / 2, color); break;
+        case  2: drawer.fillRect<Setter>(x + r, y, x - r, y + r, color); break;
+        case  3: drawer.plotLine<Setter>(x, y, x + 2 * r, y - r, color); break;
+        case  4: drawer.plotLineWidth<Setter>(x, y, x - r, y + 2 * r, 3.5F, color); break;
+        case  5: drawer.plotEllipse<Setter>(x, y, r, r / 2 + 1, color); break;
+        case  6: drawer.fillEllipse<Setter>(x, y, r / 2 + 1, r, color); break;
+        case  7: drawer.plotOptimizedEllipse<Setter>(x, y, r, r / 3 + 1, color); break;
+        case  8: drawer.fillOptimizedEllipse<Setter>(x, y, r, r / 3 + 1, color); break;
+        case  9: drawer.plotEllipseRect<Setter>(x - r, y, x + r, y + r / 2, color); break;
+        case 10: drawer.fillEllipseRect<Setter>(x - r, y, x + r, y + r / 2, color); break;
+        case 11: drawer.plotCircle<Setter>(x, y, r, color); drawer.fillCircle<Setter>(x, y, r / 2, color); break;
+        }
+    }
+}
+
+void test41()
+{
+    BitmapRGBImage image(500, 400), image_clipped(500, 400);
+    image.clear();
+    image_clipped.clear();
+    draw_test41_primitives<RGBDrawer::PixelSetter>(image);
+    draw_test41_primitives<AlwaysClippedSetter>(image_clipped);
+    if (std::memcmp(image.row(0), image_clipped.row(0), sizeof(rgb_pixel_t) * image.width() * image.height()))
+        fprintf(stderr, "test41(): ERROR: NoClip fast path draws different pixels than the clipped setter\n");
+    BitmapRGBImageFile::save(image, "test41_noclip_fast_path.bmp");
+
+    // a derived setter gets all pixels - also of fully visible primitives
+    image.clear();
+    RGBDrawer drawer(image);
+    rgb_pixel_t color;
+    set_rgb(color, 255, 255, 255);
+    CountingSetter::num_pixels = CountingSetter::num_spans = 0;
+    drawer.plotCircle<CountingSetter>(250, 200, 50, color);
+    unsigned num_set = 0;
+    for (unsigned y = 0; y < image.height(); ++y)
+        for (unsigned x = 0; x < image.width(); ++x)
+            num_set += *red(image.get_pixel(x, y)) != 0;
+    drawer.fillRect<CountingSetter>(10, 10, 40, 19, color);
+    if (num_set == 0 || CountingSetter::num_pixels < num_set || CountingSetter::num_spans != 10)
+        fprintf(stderr, "test41(): ERROR: derived setter skipped: %u pixels, %u spans for %u set pixels\n",
+                CountingSetter::num_pixels, CountingSetter::num_spans, num_set);
+}
+
+
+template <class Setter>
+static void draw_test42_outlines(RGBDrawer& drawer, const int x_ofs, const int y_ofs)
+{
+    rgb_pixel_t color;
+    counter_rng rng(42);
+    for (unsigned i = 0; i < 300; ++i)
+    {
+        const int x = int(rng(4 * i) % 700U) - 50 - x_ofs;
+        const int y = int(rng(4 * i + 1) % 500U) - 50 - y_ofs;
+        const int rx = 1 + int(rng(4 * i + 2) % 300U);
+        const int ry = 1 + int((rng(4 * i + 2) >> 16) % 200U);
+        set_rgb(color, uint8_t(rng(4 * i + 3)), uint8_t(rng(4 * i + 3) >> 8), uint8_t(rng(4 * i + 3) >> 16));
+        switch (i % 3)
+        {
+        case 0: drawer.plotEllipse<Setter>(x, y, rx, ry, color); break;
+        case 1: drawer.plotOptimizedEllipse<Setter>(x, y, (i % 2) ? 1 : rx, ry, color); break;
+        case 2: drawer.plotCircle<Setter>(x, y, rx, color); break;
+        }
+    }
+}
+
+void test42()
+{
+    // tiles of Slices clip every outline, which then only walks the visible rows.
+    // the reference holds each outline fully - no clipping - around the w x h window
+    constexpr unsigned w = 600, h = 400, tile = 150, margin = 400;
+    BitmapRGBImage canvas(w + 2 * margin, h + 2 * margin), image_tiled(w, h);
+    canvas.clear();
+    image_tiled.clear();
+    {
+        RGBDrawer drawer(canvas);
+        draw_test42_outlines<RGBDrawer::PixelSetter>(drawer, -int(margin), -int(margin));
+    }
+    BitmapRGBImage image(Slice{}, canvas, margin, margin, w, h);
+    for (unsigned ty = 0; ty < h; ty += tile)
+        for (unsigned tx = 0; tx < w; tx += tile)
+        {
+            BitmapRGBImage slice(Slice{}, image_tiled, tx, ty, std::min(tile, w - tx), std::min(tile, h - ty));
+            RGBDrawer drawer(slice);
+            draw_test42_outlines<RGBDrawer::PixelSetter>(drawer, int(tx), int(ty));
+        }
+    if (!equal_images(image, image_tiled))
+        fprintf(stderr, "test42(): ERROR: span-clipped outlines differ from the unclipped ones\n");
+    BitmapRGBImageFile::save(image_tiled, "test42_clipped_outlines.bmp");
+
+    // range ring with a huge radius through a small viewport
+    BitmapRGBImage view(200, 200);
+    view.clear();
+    RGBDrawer drawer(view);
+    const int radius = 50000000;
+    drawer.plotCircle<RGBDrawer::PixelSetter>(100, 100 + radius, radius, {255, 255, 255});
+    drawer.plotEllipse<RGBDrawer::PixelSetter>(100 - radius, 50, radius, 20, {255, 255, 255});
+    unsigned num_top = 0, num_mid = 0;
+    for (unsigned x = 0; x < 200; ++x)
+    {
+        num_top += (*red(view.pixel(x, 100)) != 0);
+        num_mid += (*red(view.pixel(x, 50)) != 0);
+    }
+    if (num_top != 200 || num_mid != 101)
+        fprintf(stderr, "test42(): ERROR: huge outlines: %u pixels in row 100, %u in row 50\n", num_top, num_mid);
+}
+
+
+template <class Setter>
+static void draw_test43_lines(RGBDrawer& drawer, const int x_ofs, const int y_ofs)
+{
+    rgb_pixel_t color;
+    counter_rng rng(43);
+    for (unsigned i = 0; i < 200; ++i)
+    {
+        const int x0 = int(rng(5 * i) % 700U) - 50 - x_ofs, y0 = int(rng(5 * i + 1) % 500U) - 50 - y_ofs;
+        const int x1 = int(rng(5 * i + 2) % 700U) - 50 - x_ofs, y1 = int(rng(5 * i + 3) % 500U) - 50 - y_ofs;
+        set_rgb(color, uint8_t(rng(5 * i + 4)), uint8_t(rng(5 * i + 4) >> 8), uint8_t(rng(5 * i + 4) >> 16));
+        if (i % 4)
+            drawer.plotLineAA<Setter>(x0, y0, x1, y1, color);
+        else
+            drawer.plotLineWidth<Setter>(x0, y0, x1, y1, 1.0F + float(i % 5), color);
+    }
+}
+
+void test43()
+{
+    // intensity along the line: the coverage of the 2 pixels next to it sums up to about 1 per unit length
+    for (int dy = 0; dy <= 200; dy += 5)
+    {
+        BitmapFloatImage float_image(300, 300);
+        float_image.clear(0.0F);
+        FloatDrawer draw(float_image);
+        draw.plotLineAA<FloatDrawer::PixelAdder>(50, 50, 250, 50 + dy, 1.0F);
+        double sum = 0.0;
+        for (unsigned y = 0; y < float_image.height(); ++y)
+            for (unsigned x = 0; x < float_image.width(); ++x)
+                sum += float_image.pixel(x, y);
+        const double ratio = sum / std::sqrt(200.0 * 200.0 + double(dy) * dy);
+        if (ratio < 0.95 || ratio > 1.2)
+            fprintf(stderr, "test43(): ERROR: plotLineAA() intensity %g per pixel length for dy %d\n", ratio, dy);
+    }
+
+    // fully covered pixels of a blended line get the line color
+    {
+        BitmapRGBImage rgb_image(50, 10);
+        rgb_image.clear({255, 255, 255});
+        RGBDrawer draw(rgb_image);
+        draw.plotLineAA<RGBDrawer::PixelBlender>(5, 5, 45, 5, {0, 10, 200});
+        const rgb_pixel_t p = rgb_image.pixel(25, 5);
+        if (*red(p) != 0 || *green(p) != 10 || *blue(p) != 200)
+            fprintf(stderr, "test43(): ERROR: PixelBlender with full coverage: %d %d %d\n", *red(p), *green(p), *blue(p));
+    }
+
+    // blended lines, clipped by Slice tiles, equal the lines drawn at once
+    constexpr unsigned w = 600, h = 400, tile = 128;
+    BitmapRGBImage image(w, h), image_tiled(w, h);
+    image.clear({40, 40, 40});
+    image_tiled.clear({40, 40, 40});
+    {
+        RGBDrawer drawer(image);
+        draw_test43_lines<RGBDrawer::PixelBlender>(drawer, 0, 0);
+    }
+    for (unsigned ty = 0; ty < h; ty += tile)
+        for (unsigned tx = 0; tx < w; tx += tile)
+        {
+            BitmapRGBImage slice(Slice{}, image_tiled, tx, ty, std::min(tile, w - tx), std::min(tile, h - ty));
+            RGBDrawer drawer(slice);
+            draw_test43_lines<RGBDrawer::PixelBlender>(drawer, int(tx), int(ty));
+        }
+    if (std::memcmp(image.row(0), image_tiled.row(0), sizeof(rgb_pixel_t) * w * h))
+        fprintf(stderr, "test43(): ERROR: clipped anti-aliased lines differ\n");
+    BitmapRGBImageFile::save(image, "test43_zingl_draw-lines-aa_rgb.bmp");
+
+    // coverage of plotLineWidth(): a horizontal line of width 4 covers 2 rows plus a half
+    {
+        BitmapFloatImage float_image(40, 20);
+        float_image.clear(0.0F);
+        FloatDrawer draw(float_image);
+        draw.plotLineWidth<FloatDrawer::PixelSetter>(5, 10, 35, 10, 4.0F, 1.0F);
+        const float expected[5] = { 0.0F, 0.5F, 1.0F, 1.0F, 0.0F };     // rows 7 .. 11
+        for (unsigned y = 7; y <= 11; ++y)
+        {
+            if (std::fabs(float_image.pixel(20, y) - expected[y - 7]) > 1.0F / 255.0F)
+                fprintf(stderr, "test43(): ERROR: plotLineWidth() coverage %g at row %u\n", float_image.pixel(20, y), y);
+        }
+    }
+}
+
+
+void test44()
+{
+    using Point = RGBDrawer::Point;
+    // random walk, partially outside the image
+    constexpr unsigned w = 400, h = 300;
+    std::vector<Point> pts(2000);
+    counter_rng rng(44);
+    int x = int(w / 2), y = int(h / 2);
+    for (unsigned i = 0; i < pts.size(); ++i)
+    {
+        x += int(rng(2 * i) % 61U) - 30;
+        y += int(rng(2 * i + 1) % 41U) - 20;
+        x = std::max(-100, std::min(int(w) + 100, x));
+        y = std::max(-100, std::min(int(h) + 100, y));
+        pts[i] = Point(x, y);
+    }
+    const auto is_joint_visible = [&](size_t i) {
+        return pts[i].first >= 0 && pts[i].first < int(w) && pts[i].second >= 0 && pts[i].second < int(h);
+    };
+
+    // PixelAdder: the polyline equals the single segments minus the doubled joints
+    BitmapFloatImage lines(w, h), polyline(w, h);
+    FloatDrawer draw_lines(lines), draw_polyline(polyline);
+    for (int variant = 0; variant < 2; ++variant)
+    {
+        lines.clear(0.0F);
+        polyline.clear(0.0F);
+        for (size_t i = 0; i + 1 < pts.size(); ++i)
+        {
+            if (variant == 0)
+                draw_lines.plotLine<FloatDrawer::PixelAdder>(pts[i], pts[i+1], 1.0F);
+            else
+                draw_lines.plotLineAA<FloatDrawer::PixelAdder>(pts[i], pts[i+1], 1.0F);
+        }
+        for (size_t i = 1; i + 1 < pts.size(); ++i)
+            if (is_joint_visible(i))
+                lines.pixel(unsigned(pts[i].first), unsigned(pts[i].second)) -= 1.0F;
+        if (variant == 0)
+            draw_polyline.plotPolyline<FloatDrawer::PixelAdder>(pts.data(), pts.size(), 1.0F);
+        else
+            draw_polyline.plotPolylineAA<FloatDrawer::PixelAdder>(pts.data(), pts.size(), 1.0F);
+        float max_diff = 0.0F;
+        for (unsigned yy = 0; yy < h; ++yy)
+            for (unsigned xx = 0; xx < w; ++xx)
+                max_diff = std::max(max_diff, std::fabs(lines.pixel(xx, yy) - polyline.pixel(xx, yy)));
+        if (max_diff > 1E-3F)
+            fprintf(stderr, "test44(): ERROR: %s sets shared points more than once: difference %g\n",
+                    variant ? "plotPolylineAA()" : "plotPolyline()", max_diff);
+    }
+
+    // PixelSetter: same pixels as the single segments
+    BitmapRGBImage image_lines(w, h), image_polyline(w, h);
+    RGBDrawer draw_rgb_lines(image_lines), draw_rgb_polyline(image_polyline);
+    image_lines.clear();
+    image_polyline.clear();
+    for (size_t i = 0; i + 1 < pts.size(); ++i)
+        draw_rgb_lines.plotLine<RGBDrawer::PixelSetter>(pts[i], pts[i+1], {255, 200, 0});
+    draw_rgb_polyline.plotPolyline<RGBDrawer::PixelSetter>(pts.data(), pts.size(), {255, 200, 0});
+    if (std::memcmp(image_lines.row(0), image_polyline.row(0), sizeof(rgb_pixel_t) * w * h))
+        fprintf(stderr, "test44(): ERROR: plotPolyline() differs from its segments\n");
+
+    // thick: with PixelAdder each pixel once - coverage (wd + 1) / 2 minus the distance
+    // to the nearest segment, also where the random walk crosses itself
+    const auto check_width = [&](const Point* path, const size_t n, const float wd, const char* name) {
+        polyline.clear(0.0F);
+        draw_polyline.plotPolylineWidth<FloatDrawer::PixelAdder>(path, n, wd, 1.0F);
+        const float r = 0.5F * (wd + 1.0F);
+        float max_diff = 0.0F, max_value = 0.0F;
+        for (unsigned yy = 0; yy < h; ++yy)
+            for (unsigned xx = 0; xx < w; ++xx)
+            {
+                float d2 = std::numeric_limits<float>::max();
+                for (size_t i = 0; i == 0 || i + 1 < n; ++i)
+                {
+                    const float ax = float(path[i].first), ay = float(path[i].second);
+                    const float dx = float(path[n > 1 ? i + 1 : i].first) - ax, dy = float(path[n > 1 ? i + 1 : i].second) - ay;
+                    const float px = float(xx) - ax, py = float(yy) - ay;
+                    const float l2 = dx * dx + dy * dy;
+                    const float t = l2 > 0.0F ? std::min(1.0F, std::max(0.0F, (px * dx + py * dy) / l2)) : 0.0F;
+                    d2 = std::min(d2, (px - t * dx) * (px - t * dx) + (py - t * dy) * (py - t * dy));
+                }
+                const float expected = std::min(1.0F, std::max(0.0F, r - std::sqrt(d2)));
+                max_diff = std::max(max_diff, std::fabs(polyline.pixel(xx, yy) - expected));
+                max_value = std::max(max_value, polyline.pixel(xx, yy));
+            }
+        if (max_diff > 0.51F / 255.0F + 1E-4F || max_value > 1.0F + 1E-6F)
+            fprintf(stderr, "test44(): ERROR: plotPolylineWidth() %s width %g: maximum %g, difference %g\n",
+                    name, wd, max_value, max_diff);
+    };
+    const Point zigzag[5] = { {40, 40}, {120, 200}, {200, 60}, {230, 250}, {360, 30} };
+    check_width(zigzag, 5, 1.0F, "zigzag");
+    check_width(zigzag, 5, 6.5F, "zigzag");
+    check_width(zigzag + 1, 1, 4.0F, "point");
+    check_width(pts.data(), 60, 3.0F, "random walk");
+    for (unsigned k = 0; k < 20; ++k)
+    {
+        Point path[8];
+        const size_t n = 2 + rng(1000 + 20 * k) % 7U;
+        for (size_t i = 0; i < n; ++i)
+            path[i] = Point(int(rng(1001 + 20 * k + 2 * unsigned(i)) % (w + 100U)) - 50,
+                            int(rng(1002 + 20 * k + 2 * unsigned(i)) % (h + 100U)) - 50);
+        check_width(path, n, 0.5F + float(rng(1019 + 20 * k) % 200U) / 20.0F, "random");
+    }
+
+    image_polyline.clear();
+    draw_rgb_polyline.plotPolylineWidth<RGBDrawer::PixelBlender>(pts.data(), pts.size(), 3.0F, {255, 200, 0});
+    BitmapRGBImageFile::save(image_polyline, "test44_zingl_draw-polyline_rgb.bmp");
+}
+
+
+void test45()
+{
+    // vectorized min/max against the scalar one: accumulated, NaN values skipped
+    {
+        counter_rng rng(451);
+        std::vector<float> vf(100);
+        std::vector<double> vd(100);
+        for (unsigned i = 0; i < vf.size(); ++i)
+            vd[i] = vf[i] = rng.uniform<float>(i) * 200.0F - 100.0F;
+        for (unsigned i = 7; i < vf.size(); i += 11)
+            vd[i] = vf[i] = std::numeric_limits<float>::quiet_NaN();
+        float min_f = vf[0], max_f = vf[0];
+        for (unsigned i = 1; i < vf.size(); ++i)
+            if (!std::isnan(vf[i]))
+            {
+                min_f = std::min(min_f, vf[i]);
+                max_f = std::max(max_f, vf[i]);
+            }
+        for (unsigned n = 1; n < vf.size(); n += 3)
+        {
+            float lo_f = 0.0F, hi_f = 0.0F;
+            double lo_d = 0.0, hi_d = 0.0;
+            float lo_ref = 0.0F, hi_ref = 0.0F;
+            min_max_values(vf.data(), vf.data() + n, lo_f, hi_f);
+            min_max_values(vd.data(), vd.data() + n, lo_d, hi_d);
+            for (unsigned i = 0; i < n; ++i)
+                if (!std::isnan(vf[i]))
+                {
+                    lo_ref = std::min(lo_ref, vf[i]);
+                    hi_ref = std::max(hi_ref, vf[i]);
+                }
+            if (lo_f != lo_ref || hi_f != hi_ref || lo_d != double(lo_ref) || hi_d != double(hi_ref))
+                fprintf(stderr, "test45(): ERROR: min_max_values() wrong for %u values\n", n);
+        }
+        float lo_f = std::numeric_limits<float>::max(), hi_f = std::numeric_limits<float>::lowest();
+        min_max_values(vf.data(), vf.data() + vf.size(), lo_f, hi_f);
+        if (lo_f != min_f || hi_f != max_f)
+            fprintf(stderr, "test45(): ERROR: min_max_values() with NaN values: %g .. %g\n", double(lo_f), double(hi_f));
+    }
+
+    // lines clipped by Slice tiles equal the fully visible ones
+    {
+        constexpr unsigned w = 600, h = 400, tile = 128;
+        BitmapRGBImage image(w, h), image_tiled(w, h);
+        image.clear();
+        image_tiled.clear();
+        counter_rng rng(452);
+        std::vector<int> coords(4 * 500);
+        for (unsigned i = 0; i < coords.size(); ++i)
+            coords[i] = int(rng(i) % ((i % 2) ? h : w));
+        {
+            RGBDrawer drawer(image);
+            for (unsigned i = 0; i < coords.size(); i += 4)
+                drawer.plotLine<RGBDrawer::PixelSetter>(coords[i], coords[i+1], coords[i+2], coords[i+3], {255, 255, 255});
+        }
+        for (unsigned ty = 0; ty < h; ty += tile)
+            for (unsigned tx = 0; tx < w; tx += tile)
+            {
+                BitmapRGBImage slice(Slice{}, image_tiled, tx, ty, std::min(tile, w - tx), std::min(tile, h - ty));
+                RGBDrawer drawer(slice);
+                for (unsigned i = 0; i < coords.size(); i += 4)
+                    drawer.plotLine<RGBDrawer::PixelSetter>(coords[i] - int(tx), coords[i+1] - int(ty),
+                                                            coords[i+2] - int(tx), coords[i+3] - int(ty), {255, 255, 255});
+            }
+        if (std::memcmp(image.row(0), image_tiled.row(0), sizeof(rgb_pixel_t) * w * h))
+            fprintf(stderr, "test45(): ERROR: clipped plotLine() differs from the unclipped one\n");
+    }
+
+    // a dense series: plot_series() sets the same pixels as the full polyline
+    constexpr unsigned w = 500, h = 300;
+    const size_t n = 200000;
+    std::vector<float> xs(n), ys(n);
+    counter_rng rng(453);
+    float y = 0.0F;
+    for (size_t i = 0; i < n; ++i)
+    {
+        y += rng.uniform<float>(unsigned(i)) - 0.5F;
+        xs[i] = float(i) + 0.5F * rng.uniform<float>(unsigned(i + n));
+        ys[i] = (i % 20000 == 7) ? 1E6F : y;       // spikes far outside the image
+    }
+    BitmapRGBImage image_series(w, h), image_polyline(w, h);
+    std::vector<RGBDrawer::Point> pts(n);
+    for (int variant = 0; variant < 3; ++variant)
+    {
+        // uniform samples / over the whole width; zoomed into the middle, 4 threads
+        const series_mapping<double> m = (variant == 0)
+            ? series_mapping<double>{ 0.0, double(w) / double(n), h / 2.0, -1.0 }
+            : series_mapping<double>{ -double(w), 3.0 * double(w) / double(n), h / 2.0, -2.0 };
+        image_series.clear();
+        image_polyline.clear();
+        for (size_t i = 0; i < n; ++i)
+            pts[i] = RGBDrawer::Point(m.column((variant == 1) ? double(i) : double(xs[i])), m.row(ys[i]));
+        RGBDrawer drawer(image_polyline);
+        drawer.plotPolyline<RGBDrawer::PixelSetter>(pts.data(), n, {255, 255, 0});
+        plot_series(image_series, (variant == 1) ? nullptr : xs.data(), ys.data(), n, m, {255, 255, 0}, variant == 2 ? 4 : 1);
+        if (std::memcmp(image_series.row(0), image_polyline.row(0), sizeof(rgb_pixel_t) * w * h))
+            fprintf(stderr, "test45(): ERROR: plot_series() differs from plotPolyline() in variant %d\n", variant);
+
+        // PixelAdder: the same pixels, each once
+        BitmapFloatImage float_series(w, h);
+        float_series.clear(0.0F);
+        plot_series<FloatDrawer::PixelAdder>(float_series, (variant == 1) ? nullptr : xs.data(), ys.data(), n, m, 1.0F,
+                                             variant == 2 ? 4 : 1);
+        unsigned num_errors = 0;
+        for (unsigned yy = 0; yy < h; ++yy)
+            for (unsigned xx = 0; xx < w; ++xx)
+                num_errors += float_series.pixel(xx, yy) != (*red(image_polyline.get_pixel(xx, yy)) ? 1.0F : 0.0F);
+        if (num_errors)
+            fprintf(stderr, "test45(): ERROR: plot_series<PixelAdder>() wrong in %u pixels in variant %d\n", num_errors, variant);
+    }
+
+    // one sample per column: the joints of plotPolyline() - and the pixels, where the lines of a column overlap
+    {
+        const series_mapping<double> m{ 0.0, 1.0, 0.0, 1.0 };
+        std::vector<float> zigzag(w);
+        for (unsigned i = 0; i < w; ++i)
+            zigzag[i] = float((i % 8 < 4) ? 20 + 30 * (i % 4) : 150 - 40 * (i % 4)) + float(i % 3);
+        BitmapFloatImage float_series(w, h);
+        float_series.clear(0.0F);
+        plot_series<FloatDrawer::PixelAdder>(float_series, nullptr, zigzag.data(), w, m, 1.0F);
+        image_series.clear();
+        plot_series(image_series, nullptr, zigzag.data(), w, m, {255, 255, 0});
+        unsigned num_errors = 0;
+        for (unsigned yy = 0; yy < h; ++yy)
+            for (unsigned xx = 0; xx < w; ++xx)
+                num_errors += float_series.pixel(xx, yy) != (*red(image_series.get_pixel(xx, yy)) ? 1.0F : 0.0F);
+        if (num_errors)
+            fprintf(stderr, "test45(): ERROR: plot_series<PixelAdder>() of a zigzag wrong in %u pixels\n", num_errors);
+    }
+    BitmapRGBImageFile::save(image_series, "test45_plot_series_rgb.bmp");
+}
+
+
+// pixel centers inside the polygon - straight from the definition: the crossings
+// of the edges [ya .. yb) with row y at or left of x, compared exactly in integers
+static bool polygon_reference_inside(const std::vector<RGBDrawer::Point>& pts, const std::vector<size_t>& rings,
+                                     const int x, const int y, const polygon_fill_rule rule)
+{
+    int crossings = 0, winding = 0;
+    size_t start = 0;
+    for (size_t r = 0; r < rings.size(); start += rings[r], ++r)
+        for (size_t i = 0; i < rings[r]; ++i)
+        {
+            const RGBDrawer::Point p0 = pts[start + i], p1 = pts[start + (i + 1) % rings[r]];
+            if (p0.second == p1.second)
+                continue;
+            const bool down = p0.second < p1.second;
+            const RGBDrawer::Point pa = down ? p0 : p1, pb = down ? p1 : p0;
+            if (y < pa.second || y >= pb.second)
+                continue;
+            const long long dy = pb.second - pa.second;
+            if ((long long)x * dy >= (long long)pa.first * dy + (long long)(y - pa.second) * (pb.first - pa.first))
+            {
+                ++crossings;
+                winding += down ? 1 : -1;
+            }
+        }
+    return (rule == fill_even_odd) ? (crossings & 1) != 0 : winding != 0;
+}
+
+void test46()
+{
+    using Point = RGBDrawer::Point;
+    constexpr unsigned w = 160, h = 120;
+    BitmapFloatImage image(w, h);
+    FloatDrawer drawer(image);
+    counter_rng rng(46);
+
+    // random self-intersecting polygons, partially outside, with 1 .. 3 rings
+    unsigned k = 0;
+    for (int iter = 0; iter < 400; ++iter)
+    {
+        const polygon_fill_rule rule = (iter & 1) ? fill_nonzero : fill_even_odd;
+        std::vector<size_t> rings(1 + rng(k++) % 3U);
+        std::vector<Point> pts;
+        for (size_t& ring : rings)
+        {
+            ring = 1 + rng(k++) % 12U;
+            for (size_t i = 0; i < ring; ++i)
+            {
+                const int x = int(rng(k++) % (2 * w)) - int(w / 2);
+                const int y = int(rng(k++) % (2 * h)) - int(h / 2);
+                pts.push_back(Point(x, y));
+            }
+        }
+        image.clear(0.0F);
+        if (rings.size() == 1)
+            drawer.fillPolygon<FloatDrawer::PixelAdder>(pts.data(), pts.size(), 1.0F, rule);
+        else
+            drawer.fillPolygonRings<FloatDrawer::PixelAdder>(pts.data(), rings.data(), rings.size(), 1.0F, rule);
+        unsigned errors = 0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+                if (image.pixel(x, y) != (polygon_reference_inside(pts, rings, int(x), int(y), rule) ? 1.0F : 0.0F))
+                    ++errors;
+        if (errors)
+        {
+            fprintf(stderr, "test46(): ERROR: fillPolygon() differs at %u pixels in polygon %d\n", errors, iter);
+            break;
+        }
+    }
+
+    // a jittered grid of quadrilaterals covers its rectangle exactly once
+    {
+        constexpr int nx = 12, ny = 9, cell = 16, x0 = -20, y0 = -10;
+        std::vector<Point> grid((nx + 1) * (ny + 1));
+        for (int j = 0; j <= ny; ++j)
+            for (int i = 0; i <= nx; ++i)
+            {
+                const bool border = (i == 0 || j == 0 || i == nx || j == ny);
+                const int jx = border ? 0 : int(rng(k++) % 11U) - 5;
+                const int jy = border ? 0 : int(rng(k++) % 11U) - 5;
+                grid[j * (nx + 1) + i] = Point(x0 + i * cell + jx, y0 + j * cell + jy);
+            }
+        image.clear(0.0F);
+        for (int j = 0; j < ny; ++j)
+            for (int i = 0; i < nx; ++i)
+            {
+                const Point quad[4] = { grid[j * (nx + 1) + i], grid[j * (nx + 1) + i + 1],
+                                        grid[(j + 1) * (nx + 1) + i + 1], grid[(j + 1) * (nx + 1) + i] };
+                drawer.fillPolygon<FloatDrawer::PixelAdder>(quad, 4, 1.0F);
+            }
+        unsigned errors = 0;
+        for (int y = 0; y < int(h); ++y)
+            for (int x = 0; x < int(w); ++x)
+            {
+                const bool inside = x >= x0 && x < x0 + nx * cell && y >= y0 && y < y0 + ny * cell;
+                if (image.pixel(unsigned(x), unsigned(y)) != (inside ? 1.0F : 0.0F))
+                    ++errors;
+            }
+        if (errors)
+            fprintf(stderr, "test46(): ERROR: adjacent polygons overlap or leave gaps at %u pixels\n", errors);
+    }
+
+    // a square with a hole: the hole stays empty for even-odd and for opposite orientation
+    BitmapRGBImage image_rgb(w, h);
+    image_rgb.clear();
+    RGBDrawer drawer_rgb(image_rgb);
+    const Point rings_opposite[8] = { Point(10, 10), Point(70, 10), Point(70, 70), Point(10, 70),
+                                      Point(25, 25), Point(25, 55), Point(55, 55), Point(55, 25) };
+    const Point rings_same[8]     = { Point(90, 10), Point(150, 10), Point(150, 70), Point(90, 70),
+                                      Point(105, 25), Point(135, 25), Point(135, 55), Point(105, 55) };
+    const size_t ring_sizes[2] = { 4, 4 };
+    drawer_rgb.fillPolygonRings(rings_opposite, ring_sizes, 2, {0, 160, 255}, fill_nonzero);
+    drawer_rgb.fillPolygonRings(rings_same, ring_sizes, 2, {255, 160, 0}, fill_nonzero);
+    const Point star[5] = { Point(80, 75), Point(100, 115), Point(55, 90), Point(105, 90), Point(60, 115) };
+    drawer_rgb.fillPolygon(star, 5, {255, 255, 0}, fill_even_odd);
+    const rgb_pixel_t hole = image_rgb.get_pixel(40, 40), ring = image_rgb.get_pixel(20, 40);
+    const rgb_pixel_t filled_hole = image_rgb.get_pixel(120, 40);
+    if (*blue(hole) != 0 || *blue(ring) != 255 || *red(filled_hole) != 255)
+        fprintf(stderr, "test46(): ERROR: fillPolygonRings() fills the hole wrong\n");
+    BitmapRGBImageFile::save(image_rgb, "test46_zingl_fill-polygon_rgb.bmp");
+}
+
+
+void test47()
+{
+    using PointF = FloatDrawer::PointF;
+    constexpr unsigned w = 200, h = 150;
+    BitmapFloatImage image(w, h);
+    FloatDrawer drawer(image);
+    counter_rng rng(47);
+    unsigned k = 0;
+    const auto image_sum = [&]() {
+        double sum = 0.0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+                sum += image.pixel(x, y);
+        return sum;
+    };
+
+    // star shaped polygons inside the image: the covered area is the polygon area
+    for (int iter = 0; iter < 50; ++iter)
+    {
+        std::vector<PointF> pts(3 + rng(k++) % 20U);
+        const float cx = 100.0F, cy = 75.0F;
+        for (size_t i = 0; i < pts.size(); ++i)
+        {
+            const float a = 6.2831853F * float(i) / float(pts.size());
+            const float r = 10.0F + 60.0F * rng.uniform<float>(k++);
+            pts[i] = PointF(cx + r * std::cos(a), cy + r * std::sin(a));
+        }
+        if (iter & 1)
+            std::reverse(pts.begin(), pts.end());
+        double area = 0.0;
+        for (size_t i = 0; i < pts.size(); ++i)
+        {
+            const PointF& p0 = pts[i];
+            const PointF& p1 = pts[(i + 1) % pts.size()];
+            area += 0.5 * (double(p0.first) * p1.second - double(p1.first) * p0.second);
+        }
+        image.clear(0.0F);
+        drawer.fillPolygonAA<FloatDrawer::PixelAdder>(pts.data(), pts.size(), 1.0F);
+        const double sum = image_sum();
+        if (std::fabs(sum - std::fabs(area)) > 0.5 + 1E-3 * std::fabs(area))
+            fprintf(stderr, "test47(): ERROR: fillPolygonAA() covers %g instead of the area %g\n", sum, std::fabs(area));
+    }
+
+    // a jittered grid of quadrilaterals adds up to 1 inside its rectangle, 0 outside
+    {
+        constexpr int nx = 14, ny = 10, cell = 17;
+        constexpr float x0 = -30.5F, y0 = -12.5F;
+        std::vector<PointF> grid((nx + 1) * (ny + 1));
+        for (int j = 0; j <= ny; ++j)
+            for (int i = 0; i <= nx; ++i)
+            {
+                const bool border = (i == 0 || j == 0 || i == nx || j == ny);
+                const float jx = border ? 0.0F : 10.0F * rng.uniform<float>(k++) - 5.0F;
+                const float jy = border ? 0.0F : 10.0F * rng.uniform<float>(k++) - 5.0F;
+                grid[j * (nx + 1) + i] = PointF(x0 + float(i * cell) + jx, y0 + float(j * cell) + jy);
+            }
+        image.clear(0.0F);
+        for (int j = 0; j < ny; ++j)
+            for (int i = 0; i < nx; ++i)
+            {
+                const PointF quad[4] = { grid[j * (nx + 1) + i], grid[j * (nx + 1) + i + 1],
+                                         grid[(j + 1) * (nx + 1) + i + 1], grid[(j + 1) * (nx + 1) + i] };
+                drawer.fillPolygonAA<FloatDrawer::PixelAdder>(quad, 4, 1.0F);
+            }
+        float max_diff = 0.0F;
+        for (int y = 0; y < int(h); ++y)
+            for (int x = 0; x < int(w); ++x)
+            {
+                const bool inside = x > x0 && x < x0 + float(nx * cell) && y > y0 && y < y0 + float(ny * cell);
+                max_diff = std::max(max_diff, std::fabs(image.pixel(unsigned(x), unsigned(y)) - (inside ? 1.0F : 0.0F)));
+            }
+        if (max_diff > 4.0F / 255.0F)
+            fprintf(stderr, "test47(): ERROR: adjacent anti-aliased polygons don't add up to 1: difference %g\n", max_diff);
+    }
+
+    // clipped by Slice tiles: same coverage as the whole image
+    {
+        constexpr unsigned tile = 48;
+        std::vector<PointF> pts(40);
+        for (size_t i = 0; i < pts.size(); ++i, k += 2)
+            pts[i] = PointF(rng.uniform<float>(k) * 400.0F - 100.0F, rng.uniform<float>(k + 1) * 300.0F - 75.0F);
+        BitmapFloatImage image_tiled(w, h);
+        image.clear(0.0F);
+        image_tiled.clear(0.0F);
+        drawer.fillPolygonAA<FloatDrawer::PixelAdder>(pts.data(), pts.size(), 1.0F);
+        for (unsigned ty = 0; ty < h; ty += tile)
+            for (unsigned tx = 0; tx < w; tx += tile)
+            {
+                BitmapFloatImage slice(Slice{}, image_tiled, tx, ty, std::min(tile, w - tx), std::min(tile, h - ty));
+                FloatDrawer drawer_slice(slice);
+                std::vector<PointF> moved(pts);
+                for (PointF& p : moved)
+                    p = PointF(p.first - float(tx), p.second - float(ty));
+                drawer_slice.fillPolygonAA<FloatDrawer::PixelAdder>(moved.data(), moved.size(), 1.0F);
+            }
+        float max_diff = 0.0F;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+                max_diff = std::max(max_diff, std::fabs(image.pixel(x, y) - image_tiled.pixel(x, y)));
+        if (max_diff > 1.5F / 255.0F)
+            fprintf(stderr, "test47(): ERROR: clipped fillPolygonAA() differs by %g\n", max_diff);
+    }
+
+    // rgb: blended over the background, a ring with a hole of opposite orientation
+    BitmapRGBImage image_rgb(w, h);
+    image_rgb.clear();
+    RGBDrawer drawer_rgb(image_rgb);
+    std::vector<PointF> ring;
+    const size_t ring_sizes[2] = { 90, 90 };
+    for (int r = 0; r < 2; ++r)
+        for (size_t i = 0; i < ring_sizes[r]; ++i)
+        {
+            const float a = 6.2831853F * float(r ? ring_sizes[r] - i : i) / float(ring_sizes[r]);
+            const float rad = r ? 25.0F : 60.0F;
+            ring.push_back(PointF(70.0F + rad * std::cos(a), 75.0F + 0.8F * rad * std::sin(a)));
+        }
+    drawer_rgb.fillPolygonRingsAA(ring.data(), ring_sizes, 2, {0, 160, 255});
+    const PointF star[5] = { PointF(150.3F, 20.2F), PointF(175.1F, 110.7F), PointF(110.4F, 55.5F),
+                             PointF(190.8F, 55.1F), PointF(125.2F, 110.9F) };
+    drawer_rgb.fillPolygonAA(star, 5, {255, 255, 0});
+    const rgb_pixel_t hole = image_rgb.get_pixel(70, 75), filled = image_rgb.get_pixel(20, 75);
+    if (*blue(hole) != 0 || *blue(filled) != 255)
+        fprintf(stderr, "test47(): ERROR: fillPolygonRingsAA() fills the hole wrong\n");
+    BitmapRGBImageFile::save(image_rgb, "test47_zingl_fill-polygon-aa_rgb.bmp");
+}
+
+void test48()
+{
+    constexpr unsigned w = 200, h = 150;
+    BitmapFloatImage image(w, h);
+    FloatDrawer drawer(image);
+    counter_rng rng(48);
+    unsigned k = 0;
+
+    // kind 0: quadratic, 1: rational, 2: cubic - control points and weight
+    struct Curve { int kind; int x[4], y[4]; float w; };
+    const auto point_at = [](const Curve& c, const double t) {
+        const double u = 1.0 - t;
+        if (c.kind == 2)
+        {
+            const double b0 = u*u*u, b1 = 3.0*u*u*t, b2 = 3.0*u*t*t, b3 = t*t*t;
+            return std::make_pair(b0*c.x[0] + b1*c.x[1] + b2*c.x[2] + b3*c.x[3],
+                                  b0*c.y[0] + b1*c.y[1] + b2*c.y[2] + b3*c.y[3]);
+        }
+        const double b0 = u*u, b1 = 2.0*u*t*(c.kind ? c.w : 1.0), b2 = t*t, s = 1.0 / (b0 + b1 + b2);
+        return std::make_pair((b0*c.x[0] + b1*c.x[1] + b2*c.x[2]) * s, (b0*c.y[0] + b1*c.y[1] + b2*c.y[2]) * s);
+    };
+    const auto random_curve = [&](const int kind, const int x_off, const int y_off, const int range) {
+        Curve c;
+        c.kind = kind;
+        for (int i = 0; i < 4; ++i)
+        {
+            c.x[i] = x_off + int(rng(k++) % unsigned(range));
+            c.y[i] = y_off + int(rng(k++) % unsigned(range * 3 / 4));
+        }
+        c.w = kind == 1 ? 4.0F * rng.uniform<float>(k++) : 1.0F;
+        return c;
+    };
+    const auto draw = [](FloatDrawer& d, const Curve& c, const int dx, const int dy) {
+        if (c.kind == 0)
+            d.plotQuadBezier<FloatDrawer::PixelAdder>(c.x[0] - dx, c.y[0] - dy, c.x[1] - dx, c.y[1] - dy,
+                                                      c.x[2] - dx, c.y[2] - dy, 1.0F);
+        else if (c.kind == 1)
+            d.plotQuadRationalBezier<FloatDrawer::PixelAdder>(c.x[0] - dx, c.y[0] - dy, c.x[1] - dx, c.y[1] - dy,
+                                                              c.x[2] - dx, c.y[2] - dy, c.w, 1.0F);
+        else
+            d.plotCubicBezier<FloatDrawer::PixelAdder>(c.x[0] - dx, c.y[0] - dy, c.x[1] - dx, c.y[1] - dy,
+                                                       c.x[2] - dx, c.y[2] - dy, c.x[3] - dx, c.y[3] - dy, 1.0F);
+    };
+    const auto draw_aa = [](FloatDrawer& d, const Curve& c, const int dx, const int dy) {
+        if (c.kind == 0)
+            d.plotQuadBezierAA<FloatDrawer::PixelAdder>(c.x[0] - dx, c.y[0] - dy, c.x[1] - dx, c.y[1] - dy,
+                                                        c.x[2] - dx, c.y[2] - dy, 1.0F);
+        else if (c.kind == 1)
+            d.plotQuadRationalBezierAA<FloatDrawer::PixelAdder>(c.x[0] - dx, c.y[0] - dy, c.x[1] - dx, c.y[1] - dy,
+                                                                c.x[2] - dx, c.y[2] - dy, c.w, 1.0F);
+        else
+            d.plotCubicBezierAA<FloatDrawer::PixelAdder>(c.x[0] - dx, c.y[0] - dy, c.x[1] - dx, c.y[1] - dy,
+                                                         c.x[2] - dx, c.y[2] - dy, c.x[3] - dx, c.y[3] - dy, 1.0F);
+    };
+    const char* kind_name[3] = { "plotQuadBezier", "plotQuadRationalBezier", "plotCubicBezier" };
+    // the curve doesn't come close to itself: the control polygon turns by less than
+    // 120 degrees, always to the same side, each corner wider than 70 degrees.
+    // otherwise both parts of the curve may set the same pixels
+    const auto separated = [](const Curve& c) {
+        const int last = c.kind == 2 ? 3 : 2;
+        double turn = 0.0;
+        for (int i = 1; i < last; ++i)
+        {
+            const double ax = c.x[i-1] - c.x[i], ay = c.y[i-1] - c.y[i];
+            const double bx = c.x[i+1] - c.x[i], by = c.y[i+1] - c.y[i];
+            const double la = std::sqrt(ax*ax + ay*ay), lb = std::sqrt(bx*bx + by*by);
+            const double cross = ax*by - ay*bx;
+            if (la == 0.0 || lb == 0.0 || ax*bx + ay*by > 0.34 * la * lb || cross * turn < 0.0)
+                return false;
+            turn = cross;
+        }
+        const double ax = c.x[1] - c.x[0], ay = c.y[1] - c.y[0];
+        const double bx = c.x[last] - c.x[last-1], by = c.y[last] - c.y[last-1];
+        return ax*bx + ay*by > -0.5 * std::sqrt((ax*ax + ay*ay) * (bx*bx + by*by));
+    };
+
+    // inside the image: close to the curve, no gaps, both end points - the tips of
+    // needle like curves may end a pixel early.
+    // each pixel once - also at the cuts of the curve
+    int n_separated = 0;
+    for (int iter = 0; iter < 600; ++iter)
+    {
+        const Curve c = random_curve(iter % 3, 10, 10, 180);
+        image.clear(0.0F);
+        draw(drawer, c, 0, 0);
+        const int last = c.kind == 2 ? 3 : 2;
+        std::vector<std::pair<double, double> > samples;
+        for (int i = 0; i <= 2000; ++i)
+            samples.push_back(point_at(c, i / 2000.0));
+        const bool once = separated(c);
+        n_separated += once;
+        bool ok = image.pixel(unsigned(c.x[0]), unsigned(c.y[0])) != 0.0F
+               && image.pixel(unsigned(c.x[last]), unsigned(c.y[last])) != 0.0F;
+        double max_dist = 0.0, max_gap = 0.0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+            {
+                const float v = image.pixel(x, y);
+                if (v == 0.0F)
+                    continue;
+                ok = ok && (v == 1.0F || !once);
+                double d2 = 1E30;
+                for (const auto& s : samples)
+                    d2 = std::min(d2, (s.first - x) * (s.first - x) + (s.second - y) * (s.second - y));
+                max_dist = std::max(max_dist, std::sqrt(d2));
+            }
+        for (const auto& s : samples)
+        {
+            const int sx = int(std::floor(s.first + 0.5)), sy = int(std::floor(s.second + 0.5));
+            double d2 = 1E30;
+            for (int y = sy - 2; y <= sy + 2; ++y)
+                for (int x = sx - 2; x <= sx + 2; ++x)
+                    if (x >= 0 && y >= 0 && x < int(w) && y < int(h) && image.pixel(unsigned(x), unsigned(y)) != 0.0F)
+                        d2 = std::min(d2, (s.first - x) * (s.first - x) + (s.second - y) * (s.second - y));
+            max_gap = std::max(max_gap, std::sqrt(d2));
+        }
+        if (!ok || max_dist > 2.0 || max_gap > (once ? 1.5 : 2.0))
+            fprintf(stderr, "test48(): ERROR: %s() %d: pixel %s, distance %g, gap %g\n",
+                    kind_name[c.kind], iter, ok ? "ok" : "count/end point wrong", max_dist, max_gap);
+    }
+    if (n_separated < 100)
+        fprintf(stderr, "test48(): ERROR: only %d curves checked for single pixels\n", n_separated);
+
+    // partially visible: the same pixels as drawn into the whole image
+    {
+        BitmapFloatImage part(70, 50);
+        FloatDrawer drawer_part(part);
+        for (int iter = 0; iter < 300; ++iter)
+        {
+            const Curve c = random_curve(iter % 3, 0, 0, 200);
+            const int ox = int(rng(k++) % 130U), oy = int(rng(k++) % 100U);
+            for (int aa = 0; aa < 2; ++aa)
+            {
+                image.clear(0.0F);
+                part.clear(0.0F);
+                (aa ? draw_aa : draw)(drawer, c, 0, 0);
+                (aa ? draw_aa : draw)(drawer_part, c, ox, oy);
+                int diffs = 0;
+                for (unsigned y = 0; y < part.height(); ++y)
+                    for (unsigned x = 0; x < part.width(); ++x)
+                        diffs += part.pixel(x, y) != image.pixel(x + unsigned(ox), y + unsigned(oy));
+                if (diffs)
+                    fprintf(stderr, "test48(): ERROR: clipped %s%s() %d differs in %d pixels\n",
+                            kind_name[c.kind], aa ? "AA" : "", iter, diffs);
+            }
+        }
+    }
+
+    const auto curve_length = [&](const Curve& c) {
+        double length = 0.0;
+        std::pair<double, double> p = point_at(c, 0.0);
+        for (int i = 1; i <= 4000; ++i)
+        {
+            const std::pair<double, double> q = point_at(c, i / 4000.0);
+            length += std::sqrt((q.first - p.first) * (q.first - p.first) + (q.second - p.second) * (q.second - p.second));
+            p = q;
+        }
+        return length;
+    };
+
+    // anti-aliased: each pixel once, close to the curve, without gaps, the intensity
+    // per length as for the lines. the cuts are rounded to pixels like those of the
+    // curves above and the rest of a part may go as a line: the curve may bend there
+    // by up to a pixel
+    for (int iter = 0; iter < 300; ++iter)
+    {
+        Curve c = random_curve(iter % 3, 20, 20, 160);
+        while (!separated(c))
+            c = random_curve(iter % 3, 20, 20, 160);
+        image.clear(0.0F);
+        draw_aa(drawer, c, 0, 0);
+        std::vector<std::pair<double, double> > samples;
+        for (int i = 0; i <= 2000; ++i)
+            samples.push_back(point_at(c, i / 2000.0));
+        double sum = 0.0, max_dist = 0.0, min_near = 1E30;
+        float max_value = 0.0F;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+            {
+                const float v = image.pixel(x, y);
+                if (v == 0.0F)
+                    continue;
+                sum += v;
+                max_value = std::max(max_value, v);
+                double d2 = 1E30;
+                for (const auto& s : samples)
+                    d2 = std::min(d2, (s.first - x) * (s.first - x) + (s.second - y) * (s.second - y));
+                max_dist = std::max(max_dist, std::sqrt(d2));
+            }
+        // the most covered pixel up to 1.5 from a point of the curve
+        for (const auto& s : samples)
+        {
+            const int sx = int(std::floor(s.first)), sy = int(std::floor(s.second));
+            double near = 0.0;
+            for (int y = sy - 1; y <= sy + 2; ++y)
+                for (int x = sx - 1; x <= sx + 2; ++x)
+                    if ((s.first - x) * (s.first - x) + (s.second - y) * (s.second - y) <= 2.25)
+                        near = std::max(near, double(image.pixel(unsigned(x), unsigned(y))));
+            min_near = std::min(min_near, near);
+        }
+        const double length = curve_length(c);
+        if (max_value > 1.0F || max_dist > 2.0 || min_near < 0.4 || sum < 0.95 * length - 1.0 || sum > 1.2 * length + 1.0)
+            fprintf(stderr, "test48(): ERROR: %sAA() %d covers %g of length %g, maximum %g, distance %g, near %g\n",
+                    kind_name[c.kind], iter, sum, length, max_value, max_dist, min_near);
+    }
+
+    // thick: the covered area is the length times the width
+    for (int iter = 0; iter < 60; ++iter)
+    {
+        Curve c = random_curve(iter % 3, 20, 20, 160);
+        while (!separated(c))
+            c = random_curve(iter % 3, 20, 20, 160);
+        const float wd = (iter / 3) % 2 ? 1.0F : 1.0F + 6.0F * rng.uniform<float>(k++);
+        const double length = curve_length(c);
+        image.clear(0.0F);
+        if (c.kind == 0)
+            drawer.plotQuadBezierWidth<FloatDrawer::PixelAdder>(c.x[0], c.y[0], c.x[1], c.y[1], c.x[2], c.y[2], wd, 1.0F);
+        else if (c.kind == 1)
+            drawer.plotQuadRationalBezierWidth<FloatDrawer::PixelAdder>(c.x[0], c.y[0], c.x[1], c.y[1], c.x[2], c.y[2],
+                                                                        c.w, wd, 1.0F);
+        else
+            drawer.plotCubicBezierWidth<FloatDrawer::PixelAdder>(c.x[0], c.y[0], c.x[1], c.y[1], c.x[2], c.y[2],
+                                                                 c.x[3], c.y[3], wd, 1.0F);
+        // each pixel: (wd + 1) / 2 minus its distance to the curve - also at the bends
+        std::vector<std::pair<double, double> > samples;
+        for (int i = 0; i <= 2000; ++i)
+            samples.push_back(point_at(c, i / 2000.0));
+        const double r = 0.5 * (wd + 1.0);
+        double sx0 = 1E30, sy0 = 1E30, sx1 = -1E30, sy1 = -1E30;
+        for (const auto& s : samples)
+        {
+            sx0 = std::min(sx0, s.first - r);
+            sy0 = std::min(sy0, s.second - r);
+            sx1 = std::max(sx1, s.first + r);
+            sy1 = std::max(sy1, s.second + r);
+        }
+        double sum = 0.0, max_diff = 0.0;
+        float max_value = 0.0F;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+            {
+                double d2 = 1E30;
+                if (x >= sx0 && x <= sx1 && y >= sy0 && y <= sy1)
+                    for (const auto& s : samples)
+                        d2 = std::min(d2, (s.first - x) * (s.first - x) + (s.second - y) * (s.second - y));
+                const double expected = std::min(1.0, std::max(0.0, r - std::sqrt(d2)));
+                max_diff = std::max(max_diff, std::fabs(image.pixel(x, y) - expected));
+                sum += image.pixel(x, y);
+                max_value = std::max(max_value, image.pixel(x, y));
+            }
+        // the inner side of sharp bends is covered once only, the round ends add a disc
+        const double area = length * wd + 3.14159265 * (wd * wd / 4.0 + 1.0 / 12.0);
+        if (sum > area * 1.01 + 1.0 || sum < area * 0.9 - 1.0 || max_value > 1.0F + 1E-4F || max_diff > 0.12)
+            fprintf(stderr, "test48(): ERROR: %sWidth() %g covers %g of %g, maximum %g, difference %g\n",
+                    kind_name[c.kind], wd, sum, area, max_value, max_diff);
+    }
+
+    // rgb
+    BitmapRGBImage image_rgb(w, h);
+    image_rgb.clear();
+    RGBDrawer drawer_rgb(image_rgb);
+    drawer_rgb.plotQuadBezier(10, 140, 60, -40, 110, 140, {255, 255, 255});
+    drawer_rgb.plotQuadRationalBezierAA(10, 140, 60, -40, 110, 140, 0.4F, {0, 255, 0});
+    drawer_rgb.plotQuadRationalBezierWidth(10, 140, 60, -40, 110, 140, 3.0F, 4.0F, {255, 128, 0});
+    drawer_rgb.plotCubicBezier(100, 20, 240, 20, 60, 140, 190, 140, {255, 255, 255});
+    drawer_rgb.plotCubicBezierAA(100, 30, 240, 30, 60, 130, 190, 130, {0, 200, 255});
+    drawer_rgb.plotCubicBezierWidth(100, 45, 220, 45, 80, 115, 190, 115, 7.5F, {255, 0, 128});
+    BitmapRGBImageFile::save(image_rgb, "test48_zingl_bezier_rgb.bmp");
+}
+
+void test49()
+{
+    constexpr unsigned w = 200, h = 160;
+    constexpr double pi = 3.14159265358979323846;
+    BitmapFloatImage image(w, h), image2(w, h), image3(w, h);
+    FloatDrawer drawer(image), drawer2(image2), drawer3(image3);
+    counter_rng rng(49);
+    unsigned k = 0;
+    typedef FloatDrawer::PixelAdder Adder;
+
+    // sqrt of the implicit equation of the rotated ellipse: 1 on the curve
+    struct Ellipse { int xm, ym, a, b; float angle; };
+    const auto radius_at = [](const Ellipse& e, const double x, const double y) {
+        const double dx = x - e.xm, dy = y - e.ym;
+        const double u = dx * std::cos(e.angle) + dy * std::sin(e.angle);
+        const double v = -dx * std::sin(e.angle) + dy * std::cos(e.angle);
+        return std::sqrt(u * u / (double(e.a) * e.a) + v * v / (double(e.b) * e.b));
+    };
+    const auto random_ellipse = [&]() {
+        Ellipse e;
+        e.a = 4 + int(rng(k++) % 70U);
+        e.b = 4 + int(rng(k++) % 70U);
+        e.xm = 100 + int(rng(k++) % 9U) - 4;
+        e.ym = 80 + int(rng(k++) % 9U) - 4;
+        e.angle = float(2.0 * pi * rng.uniform<float>(k++) - pi);
+        return e;
+    };
+    const auto count = [&](const BitmapFloatImage& img, float& max_value) {
+        int n = 0;
+        max_value = 0.0F;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+            {
+                n += img.pixel(x, y) != 0.0F;
+                max_value = std::max(max_value, img.pixel(x, y));
+            }
+        return n;
+    };
+
+    // outline: each pixel once, within a pixel of the ellipse. fill: each pixel once,
+    // the outline included, pixel centers well inside set and well outside not
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        const Ellipse e = random_ellipse();
+        image.clear(0.0F);
+        image2.clear(0.0F);
+        drawer.plotRotatedEllipse<Adder>(e.xm, e.ym, e.a, e.b, e.angle, 1.0F);
+        drawer2.fillRotatedEllipse<Adder>(e.xm, e.ym, e.a, e.b, e.angle, 1.0F);
+        const double margin = 1.5 / std::min(e.a, e.b);
+        float max_outline, max_fill;
+        count(image, max_outline);
+        count(image2, max_fill);
+        int far = 0, wrong_fill = 0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+            {
+                const double r = radius_at(e, x, y);
+                far += image.pixel(x, y) != 0.0F && std::fabs(r - 1.0) > margin;
+                wrong_fill += (image.pixel(x, y) != 0.0F && image2.pixel(x, y) == 0.0F)
+                           || (r < 1.0 - margin && image2.pixel(x, y) == 0.0F)
+                           || (r > 1.0 + margin && image2.pixel(x, y) != 0.0F);
+            }
+        if (max_outline != 1.0F || max_fill != 1.0F || far || wrong_fill)
+            fprintf(stderr, "test49(): ERROR: rotated ellipse %d %d %g: maximum %g / %g, %d pixels off, fill %d pixels wrong\n",
+                    e.a, e.b, double(e.angle), max_outline, max_fill, far, wrong_fill);
+    }
+
+    // arcs and pies: the arc is part of the ellipse with both end points. the pie outline
+    // adds the radii: the corners are set once, a radius may cross the arc next to its end.
+    // the pie is filled between the rays
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        const Ellipse e = random_ellipse();
+        const float start = float(2.0 * pi * rng.uniform<float>(k++) - pi);
+        const float sweep = float(0.3 + 5.5 * rng.uniform<float>(k++));
+        const double margin = 1.5 / std::min(e.a, e.b);
+        const auto arc_point = [&](const double t, int& x, int& y) {
+            const double u = e.a * std::cos(t), v = e.b * std::sin(t);
+            const double ca = std::cos(double(e.angle)), sa = std::sin(double(e.angle));
+            x = e.xm + int(std::floor(u * ca - v * sa + 0.5));
+            y = e.ym + int(std::floor(u * sa + v * ca + 0.5));
+        };
+        int xs, ys, xe, ye;
+        arc_point(start, xs, ys);
+        arc_point(double(start) + sweep, xe, ye);
+
+        image.clear(0.0F);
+        drawer.plotEllipseArc<Adder>(e.xm, e.ym, e.a, e.b, e.angle, start, start + sweep, 1.0F);
+        float max_arc;
+        count(image, max_arc);
+        int far = 0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+                far += image.pixel(x, y) != 0.0F && std::fabs(radius_at(e, x, y) - 1.0) > margin;
+        if (max_arc != 1.0F || far || image.pixel(unsigned(xs), unsigned(ys)) == 0.0F
+            || image.pixel(unsigned(xe), unsigned(ye)) == 0.0F)
+            fprintf(stderr, "test49(): ERROR: arc of %d %d %g from %g by %g: maximum %g, %d pixels off, end points %g %g\n",
+                    e.a, e.b, double(e.angle), double(start), double(sweep), max_arc, far,
+                    image.pixel(unsigned(xs), unsigned(ys)), image.pixel(unsigned(xe), unsigned(ye)));
+
+        image2.clear(0.0F);
+        image3.clear(0.0F);
+        drawer2.plotEllipsePie<Adder>(e.xm, e.ym, e.a, e.b, e.angle, start, start + sweep, 1.0F);
+        drawer3.fillEllipsePie<Adder>(e.xm, e.ym, e.a, e.b, e.angle, start, start + sweep, 1.0F);
+        float max_pie, max_fill;
+        count(image2, max_pie);
+        count(image3, max_fill);
+        int arc_missing = 0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+                arc_missing += image.pixel(x, y) != 0.0F && image2.pixel(x, y) == 0.0F;
+        const bool corners = image2.pixel(unsigned(e.xm), unsigned(e.ym)) == 1.0F
+                          && image2.pixel(unsigned(xs), unsigned(ys)) == 1.0F
+                          && image2.pixel(unsigned(xe), unsigned(ye)) == 1.0F;
+        // inside the wedge by more than a pixel: angle from the start ray in [0 .. sweep]
+        const double sx = xs - e.xm, sy = ys - e.ym, ex = xe - e.xm, ey = ye - e.ym;
+        const double ls = std::sqrt(sx * sx + sy * sy), le = std::sqrt(ex * ex + ey * ey);
+        int wrong_fill = 0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+            {
+                const double dx = double(x) - e.xm, dy = double(y) - e.ym;
+                const double ds = (sx * dy - sy * dx) / ls, de = (dx * ey - dy * ex) / le;
+                const bool in_s = ds > 1.0, in_e = de > 1.0, out_s = ds < -1.0, out_e = de < -1.0;
+                const bool inside = sweep <= pi ? in_s && in_e : in_s || in_e;
+                const bool outside = sweep <= pi ? out_s || out_e : out_s && out_e;
+                const double r = radius_at(e, x, y);
+                const float v = image3.pixel(x, y);
+                wrong_fill += (inside && r < 1.0 - margin && v == 0.0F) || ((outside || r > 1.0 + margin) && v != 0.0F);
+            }
+        if (max_pie > 2.0F || !corners || arc_missing || max_fill != 1.0F || wrong_fill)
+            fprintf(stderr, "test49(): ERROR: pie of %d %d %g from %g by %g: maximum %g / %g, corners %s, "
+                    "%d arc pixels missing, fill %d pixels wrong\n", e.a, e.b, double(e.angle), double(start),
+                    double(sweep), max_pie, max_fill, corners ? "ok" : "wrong", arc_missing, wrong_fill);
+    }
+
+    // partially visible: the same pixels as drawn into the whole image
+    {
+        BitmapFloatImage part(70, 50);
+        FloatDrawer drawer_part(part);
+        for (int iter = 0; iter < 250; ++iter)
+        {
+            const Ellipse e = random_ellipse();
+            const float start = float(2.0 * pi * rng.uniform<float>(k++)), end = start + float(6.5 * rng.uniform<float>(k++));
+            const int ox = int(rng(k++) % 130U), oy = int(rng(k++) % 110U);
+            image.clear(0.0F);
+            part.clear(0.0F);
+            const int kind = iter % 5;
+            const char* names[5] = { "plotRotatedEllipse", "fillRotatedEllipse", "plotEllipseArc", "plotEllipsePie", "fillEllipsePie" };
+            for (int i = 0; i < 2; ++i)
+            {
+                FloatDrawer& d = i ? drawer_part : drawer;
+                const int xm = e.xm - (i ? ox : 0), ym = e.ym - (i ? oy : 0);
+                if (kind == 0)      d.plotRotatedEllipse<Adder>(xm, ym, e.a, e.b, e.angle, 1.0F);
+                else if (kind == 1) d.fillRotatedEllipse<Adder>(xm, ym, e.a, e.b, e.angle, 1.0F);
+                else if (kind == 2) d.plotEllipseArc<Adder>(xm, ym, e.a, e.b, e.angle, start, end, 1.0F);
+                else if (kind == 3) d.plotEllipsePie<Adder>(xm, ym, e.a, e.b, e.angle, start, end, 1.0F);
+                else                d.fillEllipsePie<Adder>(xm, ym, e.a, e.b, e.angle, start, end, 1.0F);
+            }
+            int diffs = 0;
+            for (unsigned y = 0; y < part.height(); ++y)
+                for (unsigned x = 0; x < part.width(); ++x)
+                {
+                    const unsigned bx = x + unsigned(ox), by = y + unsigned(oy);
+                    diffs += part.pixel(x, y) != (bx < w && by < h ? image.pixel(bx, by) : 0.0F);
+                }
+            if (diffs)
+                fprintf(stderr, "test49(): ERROR: clipped %s() %d differs in %d pixels\n", names[kind], iter, diffs);
+        }
+    }
+
+    // rgb
+    BitmapRGBImage image_rgb(w, h);
+    image_rgb.clear();
+    RGBDrawer drawer_rgb(image_rgb);
+    for (int i = 0; i < 6; ++i)
+        drawer_rgb.plotRotatedEllipse(50, 42, 36, 10, float(i * pi / 6.0), {255, 255, 255});
+    drawer_rgb.fillRotatedEllipse(150, 45, 45, 20, 0.6F, {0, 80, 200});
+    drawer_rgb.plotRotatedEllipse(150, 45, 45, 20, 0.6F, {255, 255, 255});
+    const float slices[5] = { 0.0F, 1.1F, 2.9F, 3.8F, 5.2F };
+    const rgb_pixel_t colors[5] = { {220, 60, 60}, {60, 200, 60}, {60, 90, 220}, {230, 200, 40}, {200, 60, 200} };
+    for (int i = 0; i < 5; ++i)
+    {
+        const float end = i < 4 ? slices[i + 1] : float(2.0 * pi);
+        drawer_rgb.fillEllipsePie(50, 120, 40, 30, 0.2F, slices[i], end, colors[i]);
+        drawer_rgb.plotEllipsePie(50, 120, 40, 30, 0.2F, slices[i], end, {255, 255, 255});
+    }
+    drawer_rgb.plotEllipseArc(150, 115, 40, 25, -0.5F, 0.5F, 5.5F, {255, 255, 0});
+    drawer_rgb.plotEllipseArc(150, 115, 30, 30, 0.0F, -1.0F, 1.0F, {0, 255, 255});
+    BitmapRGBImageFile::save(image_rgb, "test49_zingl_rotated-ellipse_rgb.bmp");
+}
+
+void test50()
+{
+    constexpr unsigned w = 200, h = 160;
+    constexpr double pi = 3.14159265358979323846;
+    BitmapFloatImage image(w, h), image2(w, h);
+    FloatDrawer drawer(image), drawer2(image2);
+    counter_rng rng(50);
+    unsigned k = 0;
+    typedef FloatDrawer::PixelSetter Setter;
+    typedef FloatDrawer::PixelAdder Adder;
+    marker_cache cache;
+    const char* names[4] = { "disc", "circle", "square", "cross" };
+
+    const auto diff_pixels = [&]() {
+        int diffs = 0;
+        for (unsigned y = 0; y < h; ++y)
+            for (unsigned x = 0; x < w; ++x)
+                diffs += image.pixel(x, y) != image2.pixel(x, y);
+        return diffs;
+    };
+
+    // the stamps set the pixels of the shapes drawn directly - also at the borders
+    for (int s = 0; s < 4; ++s)
+    {
+        const marker_shape shape = marker_shape(s);
+        for (int size = 0; size <= 16; ++size)
+        {
+            const marker_stamp& stamp = cache.stamp(shape, size);
+            if (&stamp != &cache.stamp(shape, size))
+                fprintf(stderr, "test50(): ERROR: %s %d cached twice\n", names[s], size);
+            image.clear(0.0F);
+            image2.clear(0.0F);
+            for (int i = 0; i < 20; ++i)
+            {
+                const int x = int(rng(k++) % (w + 40U)) - 20, y = int(rng(k++) % (h + 40U)) - 20;
+                drawer.plotStamp<Setter>(stamp, x, y, 1.0F);
+                if (shape == marker_disc)           drawer2.fillCircle<Setter>(x, y, size, 1.0F);
+                else if (shape == marker_circle)    drawer2.plotCircle<Setter>(x, y, size, 1.0F);
+                else if (shape == marker_square)    drawer2.fillRect<Setter>(x - size, y - size, x + size, y + size, 1.0F);
+                else
+                {
+                    drawer2.plotHLine<Setter>(x - size, x + size, y, 1.0F);
+                    drawer2.plotVLine<Setter>(x, y - size, y + size, 1.0F);
+                }
+            }
+            const int diffs = diff_pixels();
+            if (diffs || !stamp.partials.empty() || stamp.x0 != -size || stamp.y1 != size)
+                fprintf(stderr, "test50(): ERROR: %s %d differs in %d pixels, %u partial pixels, box %d .. %d\n",
+                        names[s], size, diffs, unsigned(stamp.partials.size()), stamp.x0, stamp.y1);
+        }
+    }
+    if (cache.size() != 4 * 17)
+        fprintf(stderr, "test50(): ERROR: %u stamps cached\n", unsigned(cache.size()));
+    image.clear(0.0F);
+    drawer.plotStamp<Setter>(cache.stamp(marker_cross, 1), 10, 10, 1.0F);
+    image2.clear(0.0F);
+    drawer2.plotCross<Setter>(10, 10, 1.0F);
+    if (diff_pixels())
+        fprintf(stderr, "test50(): ERROR: marker_cross 1 isn't plotCross()\n");
+
+    // negative sizes give empty stamps, which draw nothing
+    image.clear(0.0F);
+    for (int s = 0; s < 4; ++s)
+    {
+        const marker_stamp stamp = make_marker_stamp(marker_shape(s), -2, s % 2 == 0);
+        if (!stamp.empty())
+            fprintf(stderr, "test50(): ERROR: %s of size -2 isn't empty\n", names[s]);
+        drawer.plotStamp<Setter>(stamp, 10, 10, 1.0F);
+    }
+    image2.clear(0.0F);
+    if (diff_pixels())
+        fprintf(stderr, "test50(): ERROR: empty stamps drew pixels\n");
+
+    // anti-aliased: the coverage adds up to the area of the disc / ring of width 1,
+    // clipped stamps are the visible part of the whole one
+    for (int s = 0; s < 2; ++s)
+        for (int size = 0; size <= 24; size += 3)
+        {
+            const marker_stamp& stamp = cache.stamp(marker_shape(s), size, true);
+            image.clear(0.0F);
+            drawer.plotStamp<Adder>(stamp, 100, 80, 1.0F);
+            double area = 0.0;
+            for (unsigned y = 0; y < h; ++y)
+                for (unsigned x = 0; x < w; ++x)
+                    area += image.pixel(x, y);
+            const double r = size + 0.5;
+            const double expected = (s == 0 || size == 0) ? pi * r * r : pi * (r * r - (r - 1.0) * (r - 1.0));
+            if (std::fabs(area - expected) > 0.01 * expected + 0.05 || stamp.partials.empty())
+                fprintf(stderr, "test50(): ERROR: anti-aliased %s %d: area %g, expected %g\n",
+                        names[s], size, area, expected);
+
+            const int x = int(rng(k++) % 60U) - 30, y = int(rng(k++) % 60U) - 30;
+            image2.clear(0.0F);
+            drawer2.plotStamp<Adder>(stamp, 100 + x, 80 + y, 1.0F);
+            drawer2.plotStamp<Adder>(stamp, x, y, 1.0F);
+            drawer2.plotStamp<Adder>(stamp, int(w) + x, int(h) + y, 1.0F);
+            int diffs = 0;
+            for (int py = 0; py < int(h); ++py)
+                for (int px = 0; px < int(w); ++px)
+                {
+                    float expected_value = 0.0F;
+                    const int offsets[3][2] = { { 100 + x, 80 + y }, { x, y }, { int(w) + x, int(h) + y } };
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        const int bx = px - offsets[i][0] + 100, by = py - offsets[i][1] + 80;
+                        if (bx >= 0 && by >= 0 && bx < int(w) && by < int(h))
+                            expected_value += image.pixel(unsigned(bx), unsigned(by));
+                    }
+                    diffs += std::fabs(image2.pixel(unsigned(px), unsigned(py)) - expected_value) > 1e-5F;
+                }
+            if (diffs)
+                fprintf(stderr, "test50(): ERROR: clipped anti-aliased %s %d differs in %d pixels\n", names[s], size, diffs);
+        }
+
+    // benchmark: scatter plot into a heatmap - fillCircle() per point against the stamp
+    {
+        constexpr unsigned bw = 640, bh = 480;
+        constexpr int n_points = 200000, radius = 3;
+        BitmapFloatImage heat(bw, bh), heat2(bw, bh);
+        FloatDrawer drawer_heat(heat), drawer_heat2(heat2);
+        heat.clear(0.0F);
+        heat2.clear(0.0F);
+        std::vector<FloatDrawer::Point> points(n_points);
+        for (int i = 0; i < n_points; ++i)
+        {
+            points[size_t(i)].first = int(rng(k++) % (bw + 10U)) - 5;
+            points[size_t(i)].second = int(rng(k++) % (bh + 10U)) - 5;
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < n_points; ++i)
+            drawer_heat.fillCircle<Adder>(points[size_t(i)], radius, 1.0F);
+        const auto t1 = std::chrono::steady_clock::now();
+        const marker_stamp& stamp = cache.stamp(marker_disc, radius);
+        for (int i = 0; i < n_points; ++i)
+            drawer_heat2.plotStamp<Adder>(stamp, points[size_t(i)], 1.0F);
+        const auto t2 = std::chrono::steady_clock::now();
+
+        int diffs = 0;
+        for (unsigned y = 0; y < bh; ++y)
+            for (unsigned x = 0; x < bw; ++x)
+                diffs += heat.pixel(x, y) != heat2.pixel(x, y);
+        if (diffs)
+            fprintf(stderr, "test50(): ERROR: stamped heatmap differs in %d pixels\n", diffs);
+        if (print_timings)
+            fprintf(stderr, "test50(): %d discs of radius %d: fillCircle() %.2f ms, plotStamp() %.2f ms\n", n_points, radius,
+                    std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                    std::chrono::duration<double, std::milli>(t2 - t1).count());
+
+        // anti-aliased: the polygon of the stamp per point
+        constexpr int n_points_aa = n_points / 10, n_vertices = 8 * (radius + 1);
+        std::vector<FloatDrawer::PointF> polygon(n_vertices);
+        const auto t3 = std::chrono::steady_clock::now();
+        for (int i = 0; i < n_points_aa; ++i)
+        {
+            for (int j = 0; j < n_vertices; ++j)
+            {
+                const double t = 2.0 * pi * j / n_vertices;
+                polygon[size_t(j)] = FloatDrawer::PointF(float(points[size_t(i)].first + (radius + 0.5) * std::cos(t)),
+                                                         float(points[size_t(i)].second + (radius + 0.5) * std::sin(t)));
+            }
+            drawer_heat.fillPolygonAA<Adder>(polygon.data(), polygon.size(), 1.0F);
+        }
+        const auto t4 = std::chrono::steady_clock::now();
+        const marker_stamp& stamp_aa = cache.stamp(marker_disc, radius, true);
+        for (int i = 0; i < n_points_aa; ++i)
+            drawer_heat2.plotStamp<Adder>(stamp_aa, points[size_t(i)], 1.0F);
+        const auto t5 = std::chrono::steady_clock::now();
+        if (print_timings)
+            fprintf(stderr, "test50(): %d anti-aliased discs of radius %d: fillPolygonAA() %.2f ms, plotStamp() %.2f ms\n",
+                    n_points_aa, radius, std::chrono::duration<double, std::milli>(t4 - t3).count(),
+                    std::chrono::duration<double, std::milli>(t5 - t4).count());
+    }
+
+    // rgb
+    BitmapRGBImage image_rgb(w, h);
+    image_rgb.clear();
+    RGBDrawer drawer_rgb(image_rgb);
+    const rgb_pixel_t colors[4] = { {220, 60, 60}, {60, 200, 60}, {60, 90, 220}, {230, 200, 40} };
+    for (int i = 0; i < 400; ++i)
+    {
+        const int s = i % 4;
+        const int x = int(rng(k++) % w), y = int(rng(k++) % h);
+        const bool aa = s < 2 && (i & 4);
+        drawer_rgb.plotStamp<RGBDrawer::PixelBlender>(cache.stamp(marker_shape(s), 2 + s, aa), x, y, colors[s]);
+    }
+    BitmapRGBImageFile::save(image_rgb, "test50_zingl_markers_rgb.bmp");
+}
+
+
+const char *testDesc[] = {
+    "compile test with rgb tests",      // 0
+    "load() & save()",                  // 1
+    "vertical/horizontal_flip()",       // 2
+    "subsample_to()",                   // 3
+    "upsample_to",                      // 4
+    "set_all_ith_bits_low()",           // 5
+    "export_color_plane()",             // 6
+    "convert_to_grayscale()",           // 7
+    "copy_region_to()",                 // 8
+    "set_pixel() r/g/b jet_colormap",   // 9
+    "invert_color_planes()",            // 10
+    "add_to_color_plane()",             // 11
+    "export_ycbcr() / import_ycbcr()",  // 12
+    "export_ycbcr() / import_ycbcr()",  // 13
+    "checkered_pattern()",              // 14
+    "plasma< , double>()",              // 15
+    "alpha_blend()",                    // 16
+    "image_drawer<>::circle()/ellipse()/rectangle()",   // 17
+    "generate_colours() colormaps",     // 18
+    "cartesian_canvas<>::rectangle()/circle()", // 19
+    "mandelbrot_set_hsv()",             // 20
+    "cartesian_canvas<float>",          // 21
+    "sobel_operator()",                 // 22
+    "zingl_image_drawer<*> lines/points",       // 23
+    "zingl_image_drawer<*>::plotLineWidth()",   // 24
+    "zingl_image_drawer<*>::plotEllipses/Circle",   // 25
+    "zingl_image_drawer<*>::plot on Slices",    // 26
+    "convolve() / convolution_kernel<>",        // 27
+    "box_blur() / gaussian_blur*()",            // 28
+    "integral_image<> / hierarchical_psnr()",   // 29
+    "mse/psnr/ssim_per_channel()",              // 30
+    "dirty_rectangles() / copy_rectangles()",   // 31
+    "rotate_to() / transpose_to() / reflective_image()", // 32
+    "convert_float_to_rgb() threaded / colormap_range<>", // 33
+    "convert_float_to_rgb_scaled() autoscaling", // 34
+    "palette_index<> / remap_to_palette()",     // 35
+    "median_cut_palette() / dither_*()",        // 36
+    "hsv_to_pixels() / hsl_to_pixels() batch conversion", // 37
+    "transform_pixels() / for_each_pixel_span()", // 38
+    "plasma() deterministic / parallel",        // 39
+    "pattern_fill() / pattern_setter",          // 40
+    "zingl_image_drawer NoClip fast path",      // 41
+    "zingl_image_drawer span-clipped outlines", // 42
+    "zingl_image_drawer<*>::plotLineAA()",      // 43
+    "zingl_image_drawer<*>::plotPolyline*()",   // 44
+    "plot_series() / column_extents()",         // 45
+    "zingl_image_drawer<*>::fillPolygon*()",    // 46
+    "zingl_image_drawer<*>::fillPolygon*AA()",  // 47
+    "zingl_image_drawer<*>::plot*Bezier*()",    // 48
+    "zingl_image_drawer<*> rotated ellipses / arcs / pies", // 49
+    "zingl_image_drawer<*>::plotStamp() / marker_cache"  // 50
+};
+
+int main(int argc, char* argv[])
+{
+    const int last_testno = 50;
+    // a last argument "timings" prints the times of the benchmarks
+    if (argc > 1 && !strcmp(argv[argc - 1], "timings"))
+    {
+        print_timings = true;
+        --argc;
+    }
     const int n_first = (argc == 1 ? 0 : 1);
     const int n_last = (argc == 1 ? last_testno : argc -1);
     if (argc == 2 && (!strcmp(argv[1], "help") || !strcmp(argv[1], "h"))) {
         for (int t = 0; t <= last_testno; ++t)
             fprintf(stderr, "test %2d: %s\n", t, testDesc[t]);
+        fprintf(stderr, "a last argument \"timings\" prints the times of the benchmarks\n");
         return 0;
     }
     bool loadOK = true;
@@ -1032,6 +3275,30 @@ int main(int argc, char* argv[])
         if (t == 24)    test24();
         if (t == 25)    test25();
         if (t == 26)    test26();
+        if (t == 27 && loadOK)  test27();
+        if (t == 28)    test28();
+        if (t == 29 && loadOK)  test29();
+        if (t == 30 && loadOK)  test30();
+        if (t == 31)    test31();
+        if (t == 32 && loadOK)  test32();
+        if (t == 33)    test33();
+        if (t == 34)    test34();
+        if (t == 35 && loadOK)  test35();
+        if (t == 36 && loadOK)  test36();
+        if (t == 37)    test37();
+        if (t == 38)    test38();
+        if (t == 39)    test39();
+        if (t == 40)    test40();
+        if (t == 41)    test41();
+        if (t == 42)    test42();
+        if (t == 43)    test43();
+        if (t == 44)    test44();
+        if (t == 45)    test45();
+        if (t == 46)    test46();
+        if (t == 47)    test47();
+        if (t == 48)    test48();
+        if (t == 49)    test49();
+        if (t == 50)    test50();
     }
 
     if (argc == 1)
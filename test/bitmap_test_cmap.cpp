@@ -25,6 +25,7 @@
 #include <offscr_bmp_drw/image_drawer.hpp>
 #include <offscr_bmp_drw/zingl_image_drawer.hpp>
 #include <offscr_bmp_drw/colormaps.hpp>
+#include <offscr_bmp_drw/colormap_generator.hpp>
 
 #include <array>
 
@@ -73,19 +74,69 @@ static void generate_colormaps()
     convert_colors(1000, jet_colormap, cmapRef);
 }
 
+// generated at compile time - 256 entries, indexed with x * 256 / 1000
+static constexpr std::array<rgb_pixel_t, 256> cmapViridis = generate_colormap<rgb_pixel_t, 256>(cmap_viridis);
+static constexpr std::array<rgb_pixel_t, 256> cmapMagma   = generate_colormap<rgb_pixel_t, 256>(cmap_magma);
+static constexpr std::array<rgb_pixel_t, 256> cmapInferno = generate_colormap<rgb_pixel_t, 256>(cmap_inferno);
+static constexpr std::array<rgb_pixel_t, 256> cmapTurbo   = generate_colormap<rgb_pixel_t, 256>(cmap_turbo);
+
+// the perceptual maps against entries of the matplotlib reference tables
+constexpr bool near_color(const rgb_pixel_t c, const int r, const int g, const int b, const int tol)
+{
+    return c.red + tol >= r && c.red <= r + tol && c.green + tol >= g && c.green <= g + tol
+        && c.blue + tol >= b && c.blue <= b + tol;
+}
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_viridis, 0, 256), 68, 1, 84, 6), "viridis(0)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_viridis, 128, 256), 33, 145, 140, 6), "viridis(0.5)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_viridis, 255, 256), 253, 231, 37, 6), "viridis(1)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_plasma, 0, 256), 13, 8, 135, 6), "plasma(0)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_plasma, 255, 256), 240, 249, 33, 6), "plasma(1)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_magma, 0, 256), 0, 0, 4, 6), "magma(0)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_magma, 255, 256), 252, 253, 191, 6), "magma(1)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_inferno, 0, 256), 0, 0, 4, 6), "inferno(0)");
+static_assert(near_color(colormap_detail::entry<rgb_pixel_t>(cmap_inferno, 255, 256), 252, 255, 164, 6), "inferno(1)");
+
+// the generated gray, hot, copper and jet against the tables of colormaps.hpp
+static int check_generated_colormaps()
+{
+    struct { colormap_kind kind; const rgb_t* table; int tol; const char* name; } maps[] = {
+        { cmap_gray,   yarg_colormap,   1, "gray" },
+        { cmap_hot,    hot_colormap,    1, "hot" },
+        { cmap_copper, copper_colormap, 1, "copper" },
+        { cmap_jet,    jet_colormap,   30, "jet" }
+    };
+    static rgb_pixel_t generated[1000];
+    int num_errors = 0;
+    for (const auto& m : maps)
+    {
+        generate_colormap(m.kind, generated, 1000);
+        for (unsigned i = 0; i < 990; i += 45)
+            if (!near_color(generated[i], m.table[i].red, m.table[i].green, m.table[i].blue, m.tol))
+            {
+                fprintf(stderr, "test_cmap: ERROR: generated %s differs from the table at %u\n", m.name, i);
+                ++num_errors;
+            }
+    }
+    return num_errors;
+}
+
 
 int main(int, char* [])
 {
+    const int num_errors = check_generated_colormaps();
     generate_colormaps();
     // show 3 bars - from top to bottom:
     //  * a reference colormap
     //  * the colormap, defined in generate_colormaps()
     //  * the same colormap, defined in generate_colormaps()
     //     - but with black lines at the given color points
+    //  * compile time generated viridis, magma, inferno and turbo
     const rgb_pixel_t* colormap[] = { cmapRef, cmapA, cmapB };
+    const rgb_pixel_t* colormap256[] = { cmapViridis.data(), cmapMagma.data(), cmapInferno.data(), cmapTurbo.data() };
     constexpr int h_per_color = 50;
     constexpr int n_colormaps = sizeof(colormap) / sizeof(colormap[0]);
-    BitmapRGBImage image(1000, n_colormaps * h_per_color);
+    constexpr int n_colormaps256 = sizeof(colormap256) / sizeof(colormap256[0]);
+    BitmapRGBImage image(1000, (n_colormaps + n_colormaps256) * h_per_color);
 #if USE_ZINGL_DRAWER
     using RGBDrawer = zingl_image_drawer<BitmapRGBImage>;
     using Setter = RGBDrawer::PixelSetter;
@@ -106,7 +157,17 @@ int main(int, char* [])
             draw.vertical_line_segment(x, j * h_per_color, (j + 1) * h_per_color -2);
         #endif
         }
+        for (unsigned int j = 0; j < n_colormaps256; ++j)
+        {
+            const int y0 = (n_colormaps + j) * h_per_color;
+        #if USE_ZINGL_DRAWER
+            draw.plotVLine<Setter>(x, y0, y0 + h_per_color -2, colormap256[j][x * 256 / 1000]);
+        #else
+            draw.pen_color( colormap256[j][x * 256 / 1000] );
+            draw.vertical_line_segment(x, y0, y0 + h_per_color -2);
+        #endif
+        }
     }
     BitmapRGBImageFile::save(image, "test_cmap.bmp");
-    return 0;
+    return num_errors ? 1 : 0;
 }